@@ -28,6 +28,7 @@ CMixer::CMixer(unsigned int BackendSampleRate)
 	, m_log_dtk_audio(false)
 	, m_log_dsp_audio(false)
 	, m_speed(0)
+	, m_drop_samples(false)
 {
 	INFO_LOG(AUDIO_INTERFACE, "Mixer is initialized");
 }
@@ -167,6 +168,8 @@ void CMixer::MixerFifo::PushSamples(const short *samples, unsigned int num_sampl
 
 void CMixer::PushSamples(const short *samples, unsigned int num_samples)
 {
+	if (m_drop_samples.load())
+		return;
 	m_dma_mixer.PushSamples(samples, num_samples);
 	if (m_log_dsp_audio)
 		m_wave_writer_dsp.AddStereoSamplesBE(samples, num_samples);
@@ -174,6 +177,8 @@ void CMixer::PushSamples(const short *samples, unsigned int num_samples)
 
 void CMixer::PushStreamingSamples(const short *samples, unsigned int num_samples)
 {
+	if (m_drop_samples.load())
+		return;
 	m_streaming_mixer.PushSamples(samples, num_samples);
 	if (m_log_dtk_audio)
 		m_wave_writer_dtk.AddStereoSamplesBE(samples, num_samples);
@@ -181,6 +186,8 @@ void CMixer::PushStreamingSamples(const short *samples, unsigned int num_samples
 
 void CMixer::PushWiimoteSpeakerSamples(const short *samples, unsigned int num_samples, unsigned int sample_rate)
 {
+	if (m_drop_samples.load())
+		return;
 	short samples_stereo[MAX_SAMPLES * 2];
 
 	if (num_samples < MAX_SAMPLES)
@@ -47,6 +47,9 @@ public:
 	float GetCurrentSpeed() const { return m_speed.load(); }
 	void UpdateSpeed(float val) { m_speed.store(val); }
 
+	// For emulated audio that is going to be rolled back (run-ahead).
+	void SetDropSamples(bool drop) { m_drop_samples.store(drop); }
+
 protected:
 	class MixerFifo {
 	public:
@@ -90,4 +93,5 @@ protected:
 	bool m_log_dsp_audio;
 
 	std::atomic<float> m_speed; // Current rate of the emulation (1.0 = 100% speed)
+	std::atomic<bool> m_drop_samples;
 };
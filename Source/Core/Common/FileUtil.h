@@ -219,6 +219,8 @@ public:
 	u64 GetSize();
 	bool Resize(u64 size);
 	bool Flush();
+	// Flush, and wait until the data is on the disk.
+	bool Sync();
 
 	// clear error state
 	void Clear() { m_good = true; std::clearerr(m_file); }
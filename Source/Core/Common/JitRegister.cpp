@@ -6,8 +6,11 @@
 #include <cstddef>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 #include "Common/FileUtil.h"
@@ -20,6 +23,12 @@
 #include <unistd.h>
 #endif
 
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#endif
+
 #if defined USE_OPROFILE && USE_OPROFILE
 #include <opagent.h>
 #endif
@@ -35,6 +44,179 @@ static op_agent_t s_agent = nullptr;
 
 static File::IOFile s_perf_map_file;
 
+#ifdef __linux__
+// Linux perf's jitdump format (tools/perf/Documentation/jitdump-specification.txt
+// in the kernel tree). "perf record -k mono" followed by "perf inject --jit"
+// turns the records into ELF images, so that perf report and perf annotate
+// can show the generated code and the guest addresses it was compiled from.
+namespace JitDump
+{
+enum : u32
+{
+	MAGIC = 0x4A695444,
+	VERSION = 1,
+	JIT_CODE_LOAD = 0,
+	JIT_CODE_DEBUG_INFO = 2,
+};
+
+#if defined(_M_X86_64)
+static const u32 ELF_MACHINE = 62; // EM_X86_64
+#elif defined(_M_ARM_64)
+static const u32 ELF_MACHINE = 183; // EM_AARCH64
+#else
+static const u32 ELF_MACHINE = 0;
+#endif
+
+struct FileHeader
+{
+	u32 magic;
+	u32 version;
+	u32 total_size;
+	u32 elf_mach;
+	u32 pad1;
+	u32 pid;
+	u64 timestamp;
+	u64 flags;
+};
+
+struct RecordHeader
+{
+	u32 id;
+	u32 total_size;
+	u64 timestamp;
+};
+
+struct CodeLoad
+{
+	RecordHeader header;
+	u32 pid;
+	u32 tid;
+	u64 vma;
+	u64 code_addr;
+	u64 code_size;
+	u64 code_index;
+	// Followed by the null terminated name and the code.
+};
+
+struct DebugInfo
+{
+	RecordHeader header;
+	u64 code_addr;
+	u64 nr_entry;
+	// Followed by the entries.
+};
+
+struct DebugEntry
+{
+	u64 code_addr;
+	u32 line;
+	u32 discrim;
+	// Followed by the null terminated file name.
+};
+}
+
+static File::IOFile s_jit_dump_file;
+static void* s_jit_dump_marker;
+static u64 s_jit_dump_code_index;
+static std::mutex s_jit_dump_lock;
+
+// perf matches the records with its samples using CLOCK_MONOTONIC.
+static u64 GetJitDumpTimestamp()
+{
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void OpenJitDump(const std::string& dir)
+{
+	std::string filename = StringFromFormat("%s/jit-%d.dump", dir.data(), getpid());
+	if (!s_jit_dump_file.Open(filename, "w+b"))
+		return;
+
+	// perf finds the file through this mapping in the recorded mmap events.
+	s_jit_dump_marker = mmap(nullptr, sysconf(_SC_PAGESIZE), PROT_READ | PROT_EXEC, MAP_PRIVATE,
+	                         fileno(s_jit_dump_file.GetHandle()), 0);
+	if (s_jit_dump_marker == MAP_FAILED)
+	{
+		s_jit_dump_marker = nullptr;
+		s_jit_dump_file.Close();
+		return;
+	}
+
+	JitDump::FileHeader header = {};
+	header.magic = JitDump::MAGIC;
+	header.version = JitDump::VERSION;
+	header.total_size = sizeof(header);
+	header.elf_mach = JitDump::ELF_MACHINE;
+	header.pid = getpid();
+	header.timestamp = GetJitDumpTimestamp();
+	s_jit_dump_file.WriteBytes(&header, sizeof(header));
+	s_jit_dump_file.Flush();
+	s_jit_dump_code_index = 0;
+}
+
+static void CloseJitDump()
+{
+	if (s_jit_dump_marker)
+		munmap(s_jit_dump_marker, sysconf(_SC_PAGESIZE));
+	s_jit_dump_marker = nullptr;
+	if (s_jit_dump_file.IsOpen())
+		s_jit_dump_file.Close();
+}
+
+static void WriteJitDump(const void* base_address, u32 code_size, const std::string& symbol_name,
+                         const std::string& source_name, const std::vector<JitRegister::DebugEntry>& debug_entries)
+{
+	std::lock_guard<std::mutex> lk(s_jit_dump_lock);
+	if (!s_jit_dump_file.IsOpen())
+		return;
+
+	u64 timestamp = GetJitDumpTimestamp();
+
+	// The debug info has to precede the code it describes.
+	if (!debug_entries.empty())
+	{
+		std::vector<u8> record(sizeof(JitDump::DebugInfo));
+		for (const JitRegister::DebugEntry& entry : debug_entries)
+		{
+			JitDump::DebugEntry out;
+			out.code_addr = (u64)entry.host_address;
+			out.line = entry.guest_address;
+			out.discrim = 0;
+			const u8* out_bytes = reinterpret_cast<const u8*>(&out);
+			record.insert(record.end(), out_bytes, out_bytes + sizeof(out));
+			record.insert(record.end(), source_name.begin(), source_name.end());
+			record.push_back(0);
+		}
+
+		JitDump::DebugInfo info;
+		info.header.id = JitDump::JIT_CODE_DEBUG_INFO;
+		info.header.total_size = (u32)record.size();
+		info.header.timestamp = timestamp;
+		info.code_addr = (u64)base_address;
+		info.nr_entry = debug_entries.size();
+		std::memcpy(record.data(), &info, sizeof(info));
+		s_jit_dump_file.WriteBytes(record.data(), record.size());
+	}
+
+	JitDump::CodeLoad load;
+	load.header.id = JitDump::JIT_CODE_LOAD;
+	load.header.total_size = (u32)(sizeof(load) + symbol_name.size() + 1 + code_size);
+	load.header.timestamp = timestamp;
+	load.pid = getpid();
+	load.tid = (u32)syscall(SYS_gettid);
+	load.vma = (u64)base_address;
+	load.code_addr = (u64)base_address;
+	load.code_size = code_size;
+	load.code_index = s_jit_dump_code_index++;
+	s_jit_dump_file.WriteBytes(&load, sizeof(load));
+	s_jit_dump_file.WriteBytes(symbol_name.c_str(), symbol_name.size() + 1);
+	s_jit_dump_file.WriteBytes(base_address, code_size);
+	s_jit_dump_file.Flush();
+}
+#endif
+
 namespace JitRegister
 {
 
@@ -52,6 +234,10 @@ void Init(const std::string& perf_dir)
 		// Disable buffering in order to avoid missing some mappings
 		// if the event of a crash:
 		std::setvbuf(s_perf_map_file.GetHandle(), nullptr, _IONBF, 0);
+
+#ifdef __linux__
+		OpenJitDump(dir);
+#endif
 	}
 }
 
@@ -68,15 +254,33 @@ void Shutdown()
 
 	if (s_perf_map_file.IsOpen())
 		s_perf_map_file.Close();
+
+#ifdef __linux__
+	CloseJitDump();
+#endif
+}
+
+bool IsEnabled()
+{
+#if (defined USE_OPROFILE && USE_OPROFILE) || defined(USE_VTUNE)
+	return true;
+#else
+	return s_perf_map_file.IsOpen();
+#endif
 }
 
 void RegisterV(const void* base_address, u32 code_size,
 	const char* format, va_list args)
 {
-#if !(defined USE_OPROFILE && USE_OPROFILE) && !defined(USE_VTUNE)
-	if (!s_perf_map_file.IsOpen())
+	RegisterV(base_address, code_size, "", {}, format, args);
+}
+
+void RegisterV(const void* base_address, u32 code_size,
+	const std::string& source_name, const std::vector<DebugEntry>& debug_entries,
+	const char* format, va_list args)
+{
+	if (!IsEnabled())
 		return;
-#endif
 
 	std::string symbol_name = StringFromFormatV(format, args);
 
@@ -102,6 +306,10 @@ void RegisterV(const void* base_address, u32 code_size,
 			(u64)base_address, code_size, symbol_name.data());
 		s_perf_map_file.WriteBytes(entry.data(), entry.size());
 	}
+
+#ifdef __linux__
+	WriteJitDump(base_address, code_size, symbol_name, source_name, debug_entries);
+#endif
 }
 
 }
@@ -5,14 +5,30 @@
 #pragma once
 #include <stdarg.h>
 #include <string>
+#include <vector>
 #include "Common/CommonTypes.h"
 
 namespace JitRegister
 {
 
+// Attributes the host code from host_address up to the next entry to a guest
+// address. In the jitdump file, the guest address is the line number and the
+// source file is the name given to Register (the guest function).
+struct DebugEntry
+{
+	const void* host_address;
+	u32 guest_address;
+};
+
 void Init(const std::string& perf_dir);
 void Shutdown();
+// Whether anything consumes the registered code. Callers can skip collecting
+// debug entries when this is false.
+bool IsEnabled();
+void RegisterV(const void* base_address, u32 code_size,
+	const char* format, va_list args);
 void RegisterV(const void* base_address, u32 code_size,
+	const std::string& source_name, const std::vector<DebugEntry>& debug_entries,
 	const char* format, va_list args);
 
 inline void Register(const void* base_address, u32 code_size,
@@ -34,4 +50,14 @@ inline void Register(const void* start, const void* end,
 	va_end(args);
 }
 
+inline void Register(const void* base_address, u32 code_size,
+	const std::string& source_name, const std::vector<DebugEntry>& debug_entries,
+	const char* format, ...)
+{
+	va_list args;
+	va_start(args, format);
+	RegisterV(base_address, code_size, source_name, debug_entries, format, args);
+	va_end(args);
+}
+
 }
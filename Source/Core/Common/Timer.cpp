@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cerrno>
 #include <cinttypes>
 #include <ctime>
 #include <string>
@@ -63,6 +64,33 @@ u64 Timer::GetTimeUs()
 #endif
 }
 
+void Timer::SleepUntilUs(u64 time_us)
+{
+#if defined _WIN32 || defined __APPLE__
+	u64 now = GetTimeUs();
+	if (time_us <= now)
+		return;
+#ifdef _WIN32
+	// Whole milliseconds only, with the resolution from IncreaseResolution.
+	Sleep((DWORD)((time_us - now) / 1000));
+#else
+	struct timespec t;
+	t.tv_sec = (time_t)((time_us - now) / 1000000);
+	t.tv_nsec = (long)((time_us - now) % 1000000 * 1000);
+	nanosleep(&t, nullptr);
+#endif
+#else
+	// Same clock as GetTimeUs, and an absolute deadline doesn't drift when the
+	// sleep is interrupted.
+	struct timespec t;
+	t.tv_sec = (time_t)(time_us / 1000000);
+	t.tv_nsec = (long)(time_us % 1000000 * 1000);
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, nullptr) == EINTR)
+	{
+	}
+#endif
+}
+
 // --------------------------------------------
 // Initiate, Start, Stop, and Update the time
 // --------------------------------------------
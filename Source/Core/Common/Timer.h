@@ -37,6 +37,9 @@ public:
 
 	static u32 GetTimeMs();
 	static u64 GetTimeUs();
+	// Sleeps until GetTimeUs() reaches time_us, as precisely as the OS allows.
+	// That can be a millisecond late on Windows.
+	static void SleepUntilUs(u64 time_us);
 
 	// Arbitrarily chosen value (38 years) that is subtracted in GetDoubleTime()
 	// to increase sub-second precision of the resulting double timestamp
@@ -162,6 +162,15 @@ void XEmitter::ABI_CallFunctionPC(const void *func, void *param1, u32 param2)
 	ABI_CallFunction(func);
 }
 
+void XEmitter::ABI_CallFunctionPCR(const void *func, void *param1, u32 param2, X64Reg reg3)
+{
+	if (reg3 != ABI_PARAM3)
+		MOV(32, R(ABI_PARAM3), R(reg3));
+	MOV(64, R(ABI_PARAM1), Imm64((u64)param1));
+	MOV(32, R(ABI_PARAM2), Imm32(param2));
+	ABI_CallFunction(func);
+}
+
 void XEmitter::ABI_CallFunctionPPC(const void *func, void *param1, void *param2, u32 param3)
 {
 	MOV(64, R(ABI_PARAM1), Imm64((u64)param1));
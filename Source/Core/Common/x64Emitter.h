@@ -920,6 +920,7 @@ public:
 
 	// Pass a register as a parameter.
 	void ABI_CallFunctionR(const void* func, X64Reg reg1);
+	void ABI_CallFunctionPCR(const void* func, void* param1, u32 param2, X64Reg reg3);
 	void ABI_CallFunctionRR(const void* func, X64Reg reg1, X64Reg reg2);
 
 	// Helper method for the above, or can be used separately.
@@ -948,6 +949,14 @@ public:
 		auto trampoline = &XEmitter::CallLambdaTrampoline<T, Args...>;
 		ABI_CallFunctionPC((void*)trampoline, const_cast<void*>((const void*)f), p1);
 	}
+
+	// p2 must already be zero extended to 32 bits.
+	template <typename T, typename P1, typename P2>
+	void ABI_CallLambdaCR(const std::function<T(P1, P2)>* f, u32 p1, X64Reg p2)
+	{
+		auto trampoline = &XEmitter::CallLambdaTrampoline<T, P1, P2>;
+		ABI_CallFunctionPCR((void*)trampoline, const_cast<void*>((const void*)f), p1, p2);
+	}
 };  // class XEmitter
 
 class X64CodeBlock : public CodeBlock<XEmitter>
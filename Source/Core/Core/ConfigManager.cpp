@@ -35,14 +35,19 @@ SConfig::SConfig()
   bJITPairedOff(false), bJITSystemRegistersOff(false),
   bJITBranchOff(false),
   bJITILTimeProfiling(false), bJITILOutputIR(false),
+  bJITAsyncCompile(false),
+  bJITTieredCompile(false), iJITHotBlockThreshold(1000), bJITTraceFormation(false),
   bFPRF(false), bAccurateNaNs(false), iTimingVariance(40),
   bCPUThread(true), bDSPThread(false), bDSPHLE(true),
-  bSkipIdle(true), bSyncGPUOnSkipIdleHack(true), bNTSC(false), bForceNTSCJ(false),
+  bSkipIdle(true), bSyncGPUOnSkipIdleHack(true), bAdaptiveSlicing(false), bSamplingProfiler(false),
+  bIdleLoopStats(false), bHLENativeFunctions(false), bPreciseFramePacing(false), bJustInTimeInput(false),
+  iRunAheadFrames(0),
+  bNTSC(false), bForceNTSCJ(false),
   bHLE_BS2(true), bEnableCheats(false),
   bEnableMemcardSdWriting(true),
   bDPL2Decoder(false), iLatency(14),
   bRunCompareServer(false), bRunCompareClient(false),
-  bMMU(false), bDCBZOFF(false),
+  bMMU(false), bFastmemPageTable(false), bMMIOProfiling(false), bDCBZOFF(false),
   iBBDumpPort(0),
   bFastDiscSpeed(false), bSyncGPU(false),
   SelectedLanguage(0), bOverrideGCLanguage(false), bWii(false),
@@ -517,12 +522,21 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("RunCompareServer",          &bRunCompareServer, false);
 	core->Get("RunCompareClient",          &bRunCompareClient, false);
 	core->Get("MMU",                       &bMMU,              false);
+	core->Get("FastmemPageTable",          &bFastmemPageTable, false);
+	core->Get("MMIOProfiling",             &bMMIOProfiling,    false);
 	core->Get("BBDumpPort",                &iBBDumpPort,       -1);
 	core->Get("SyncGPU",                   &bSyncGPU,          false);
 	core->Get("SyncGpuMaxDistance",        &iSyncGpuMaxDistance,  200000);
 	core->Get("SyncGpuMinDistance",        &iSyncGpuMinDistance, -200000);
 	core->Get("SyncGpuOverclock",          &fSyncGpuOverclock, 1.0);
 	core->Get("FastDiscSpeed",             &bFastDiscSpeed,    false);
+	core->Get("AdaptiveSlicing",           &bAdaptiveSlicing,  false);
+	core->Get("SamplingProfiler",          &bSamplingProfiler, false);
+	core->Get("IdleLoopStats",             &bIdleLoopStats,    false);
+	core->Get("HLENativeFunctions",        &bHLENativeFunctions, false);
+	core->Get("PreciseFramePacing",        &bPreciseFramePacing, false);
+	core->Get("JustInTimeInput",           &bJustInTimeInput,  false);
+	core->Get("RunAheadFrames",            &iRunAheadFrames,   0);
 	core->Get("DCBZ",                      &bDCBZOFF,          false);
 	core->Get("FPRF",                      &bFPRF,             false);
 	core->Get("AccurateNaNs",              &bAccurateNaNs,     false);
@@ -535,6 +549,10 @@ void SConfig::LoadCoreSettings(IniFile& ini)
 	core->Get("GameCubeAdapter",           &m_GameCubeAdapter,                             false);
 	core->Get("AdapterRumble",             &m_AdapterRumble,                               true);
 	core->Get("PerfMapDir",                &m_perfDir, "");
+	core->Get("JITAsyncCompile",           &bJITAsyncCompile,                              false);
+	core->Get("JITTieredCompile",          &bJITTieredCompile,                             false);
+	core->Get("JITHotBlockThreshold",      &iJITHotBlockThreshold,                         1000);
+	core->Get("JITTraceFormation",         &bJITTraceFormation,                            false);
 }
 
 void SConfig::LoadMovieSettings(IniFile& ini)
@@ -74,6 +74,10 @@ struct SConfig : NonCopyable
 	bool bJITBranchOff;
 	bool bJITILTimeProfiling;
 	bool bJITILOutputIR;
+	bool bJITAsyncCompile;
+	bool bJITTieredCompile;
+	int iJITHotBlockThreshold;
+	bool bJITTraceFormation;
 
 	bool bFastmem;
 	bool bFPRF;
@@ -85,6 +89,13 @@ struct SConfig : NonCopyable
 	bool bDSPHLE;
 	bool bSkipIdle;
 	bool bSyncGPUOnSkipIdleHack;
+	bool bAdaptiveSlicing;
+	bool bSamplingProfiler;
+	bool bIdleLoopStats;
+	bool bHLENativeFunctions;
+	bool bPreciseFramePacing;
+	bool bJustInTimeInput;
+	int iRunAheadFrames;
 	bool bNTSC;
 	bool bForceNTSCJ;
 	bool bHLE_BS2;
@@ -98,6 +109,8 @@ struct SConfig : NonCopyable
 	bool bRunCompareClient;
 
 	bool bMMU;
+	bool bFastmemPageTable;
+	bool bMMIOProfiling;
 	bool bDCBZOFF;
 	int iBBDumpPort;
 	bool bFastDiscSpeed;
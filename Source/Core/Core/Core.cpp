@@ -2,6 +2,7 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <atomic>
 #include <cctype>
 #include <cstring>
@@ -807,14 +808,23 @@ void UpdateTitle()
 			// that's more of a debugging interest, it can always be optional of course if someone is interested.
 			static u64 ticks = 0;
 			static u64 idleTicks = 0;
+			static u64 slices = 0;
+			static u64 emptySlices = 0;
 			u64 newTicks = CoreTiming::GetTicks();
 			u64 newIdleTicks = CoreTiming::GetIdleTicks();
+			u64 newSlices = CoreTiming::GetSliceCount();
+			u64 newEmptySlices = CoreTiming::GetEmptySliceCount();
 
-			u64 diff = (newTicks - ticks) / 1000000;
+			u64 tickDiff = newTicks - ticks;
+			u64 diff = tickDiff / 1000000;
 			u64 idleDiff = (newIdleTicks - idleTicks) / 1000000;
+			u64 sliceDiff = std::max<u64>(newSlices - slices, 1);
+			u64 emptySliceDiff = newEmptySlices - emptySlices;
 
 			ticks = newTicks;
 			idleTicks = newIdleTicks;
+			slices = newSlices;
+			emptySlices = newEmptySlices;
 
 			float TicksPercentage = (float)diff / (float)(SystemTimers::GetTicksPerSecond() / 1000000) * 100;
 
@@ -826,6 +836,11 @@ void UpdateTitle()
 					SystemTimers::GetTicksPerSecond() / 1000000,
 					_CoreParameter.bSkipIdle ? "~" : "",
 					TicksPercentage);
+
+			SFPS += StringFromFormat(" | Slices: %i/s, %i cycles avg, %i%% empty",
+					(int)(sliceDiff * 1000 / ElapseTime),
+					(int)(tickDiff / sliceDiff),
+					(int)(emptySliceDiff * 100 / sliceDiff));
 		}
 	}
 	// This is our final "frame counter" string
@@ -2,13 +2,17 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
-#include <mutex>
+#include <functional>
+#include <iterator>
+#include <map>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "Common/ChunkFile.h"
-#include "Common/FifoQueue.h"
 #include "Common/StringUtil.h"
 #include "Common/Thread.h"
 
@@ -16,11 +20,22 @@
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
 #include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Profiler.h"
 
 #include "VideoCommon/VideoBackendBase.h"
 
 #define MAX_SLICE_LENGTH 20000
 
+// Adaptive slicing (SConfig::bAdaptiveSlicing) doubles the slice limit up to
+// this every time a slice ends without running an event, and falls back to
+// MAX_SLICE_LENGTH when events arrive from other threads, whose latency is
+// bounded by the slice length.
+#define MAX_ADAPTIVE_SLICE_LENGTH (MAX_SLICE_LENGTH * 8)
+// It also never ends a slice sooner than this, so that events due within a
+// few hundred cycles of each other run in one Advance. They run late by up
+// to this many cycles, which their callbacks get as cyclesLate.
+#define MIN_ADAPTIVE_SLICE_LENGTH 1000
+
 namespace CoreTiming
 {
 
@@ -28,32 +43,65 @@ struct EventType
 {
 	TimedCallback callback;
 	std::string name;
+	// RemoveEvent cancels the queued events of a type by bumping this; they stay
+	// in the queue and are dropped once they reach the front.
+	u32 generation;
+	// Number of queued events of this type that haven't been cancelled.
+	u32 pending;
 };
 
 static std::vector<EventType> event_types;
 
-struct BaseEvent
+struct Event
 {
 	s64 time;
+	u64 fifoOrder;
 	u64 userdata;
 	int type;
+	u32 generation;
 };
 
-typedef LinkedListItem<BaseEvent> Event;
+// Events due at the same time run in the order they were scheduled.
+static bool operator<(const Event& left, const Event& right)
+{
+	return std::tie(left.time, left.fifoOrder) < std::tie(right.time, right.fifoOrder);
+}
 
-// STATE_TO_SAVE
-static Event *first;
-static std::mutex tsWriteLock;
-static Common::FifoQueue<BaseEvent, false> tsQueue;
+static bool operator>(const Event& left, const Event& right)
+{
+	return right < left;
+}
 
-// event pools
-static Event *eventPool = nullptr;
+// Events scheduled from other threads, pushed onto the front of a lock-free
+// singly linked list and moved into the queue by the CPU thread.
+struct ThreadsafeEvent
+{
+	s64 time;
+	u64 userdata;
+	int type;
+	ThreadsafeEvent* next;
+};
+
+// STATE_TO_SAVE
+// A min-heap (std::push_heap with std::greater), which includes cancelled events.
+static std::vector<Event> eventQueue;
+static u64 eventFifoId;
+static u32 cancelledEvents;
+static std::atomic<ThreadsafeEvent*> tsQueue;
 
 static float lastOCFactor;
 int slicelength;
 static int maxSliceLength = MAX_SLICE_LENGTH;
+static bool adaptiveSlicing;
+// Set while Advance runs events, it works out the next slice itself afterwards.
+static bool runningEvents;
+
+static u64 sliceCount;
+static u64 emptySliceCount;
 
 static s64 idledCycles;
+// Not saved in savestates, like the slice counts.
+static std::map<u32, IdleLoopStats> idleLoops;
 static u32 fakeDecStartValue;
 static u64 fakeDecStartTicks;
 
@@ -63,20 +111,44 @@ u64 fakeTBStartTicks;
 
 static int ev_lost;
 
-static Event* GetNewEvent()
+static bool IsCancelled(const Event& ev)
 {
-	if (!eventPool)
-		return new Event;
+	return ev.generation != event_types[ev.type].generation;
+}
 
-	Event* ev = eventPool;
-	eventPool = ev->next;
-	return ev;
+static void PushEvent(s64 time, int event_type, u64 userdata)
+{
+	EventType& type = event_types[event_type];
+	type.pending++;
+	eventQueue.push_back(Event{time, eventFifoId++, userdata, event_type, type.generation});
+	std::push_heap(eventQueue.begin(), eventQueue.end(), std::greater<Event>());
 }
 
-static void FreeEvent(Event* ev)
+static void PopEvent()
 {
-	ev->next = eventPool;
-	eventPool = ev;
+	std::pop_heap(eventQueue.begin(), eventQueue.end(), std::greater<Event>());
+	eventQueue.pop_back();
+}
+
+// Drops cancelled events from the front of the queue.
+static void SkipCancelledEvents()
+{
+	while (!eventQueue.empty() && IsCancelled(eventQueue.front()))
+	{
+		PopEvent();
+		cancelledEvents--;
+	}
+}
+
+// The queued events that haven't been cancelled, in the order they will run.
+static std::vector<Event> GetSortedEvents()
+{
+	std::vector<Event> events;
+	events.reserve(eventQueue.size() - cancelledEvents);
+	std::copy_if(eventQueue.begin(), eventQueue.end(), std::back_inserter(events),
+	             [](const Event& ev) { return !IsCancelled(ev); });
+	std::sort(events.begin(), events.end(), std::less<Event>());
+	return events;
 }
 
 static void EmptyTimedCallback(u64 userdata, int cyclesLate) {}
@@ -103,6 +175,8 @@ int RegisterEvent(const std::string& name, TimedCallback callback)
 	EventType type;
 	type.name = name;
 	type.callback = callback;
+	type.generation = 0;
+	type.pending = 0;
 
 	// check for existing type with same name.
 	// we want event type names to remain unique so that we can use them for serialization.
@@ -124,7 +198,7 @@ int RegisterEvent(const std::string& name, TimedCallback callback)
 
 void UnregisterAllEvents()
 {
-	if (first)
+	if (eventQueue.size() != cancelledEvents)
 		PanicAlert("Cannot unregister events with events pending");
 	event_types.clear();
 }
@@ -136,26 +210,24 @@ void Init()
 	slicelength = maxSliceLength;
 	globalTimer = 0;
 	idledCycles = 0;
+	idleLoops.clear();
+	eventFifoId = 0;
+	maxSliceLength = MAX_SLICE_LENGTH;
+	adaptiveSlicing = SConfig::GetInstance().bAdaptiveSlicing;
+	sliceCount = 0;
+	emptySliceCount = 0;
 
 	ev_lost = RegisterEvent("_lost_event", &EmptyTimedCallback);
 }
 
 void Shutdown()
 {
-	std::lock_guard<std::mutex> lk(tsWriteLock);
 	MoveEvents();
 	ClearPendingEvents();
 	UnregisterAllEvents();
-
-	while (eventPool)
-	{
-		Event *ev = eventPool;
-		eventPool = ev->next;
-		delete ev;
-	}
 }
 
-static void EventDoState(PointerWrap &p, BaseEvent* ev)
+static void EventDoState(PointerWrap &p, Event* ev)
 {
 	p.Do(ev->time);
 
@@ -191,7 +263,6 @@ static void EventDoState(PointerWrap &p, BaseEvent* ev)
 
 void DoState(PointerWrap &p)
 {
-	std::lock_guard<std::mutex> lk(tsWriteLock);
 	p.Do(slicelength);
 	p.Do(globalTimer);
 	p.Do(idledCycles);
@@ -204,7 +275,34 @@ void DoState(PointerWrap &p)
 
 	MoveEvents();
 
-	p.DoLinkedList<BaseEvent, GetNewEvent, FreeEvent, EventDoState>(first);
+	// Same layout as the linked list of events this used to be (see
+	// PointerWrap::DoLinkedList): each event in order behind a 1 byte, then a 0.
+	if (p.GetMode() == PointerWrap::MODE_READ)
+	{
+		ClearPendingEvents();
+		while (true)
+		{
+			u8 more = 0;
+			p.Do(more);
+			if (!more)
+				break;
+
+			Event ev = {};
+			EventDoState(p, &ev);
+			PushEvent(ev.time, ev.type, ev.userdata);
+		}
+	}
+	else
+	{
+		for (Event& ev : GetSortedEvents())
+		{
+			u8 more = 1;
+			p.Do(more);
+			EventDoState(p, &ev);
+		}
+		u8 end = 0;
+		p.Do(end);
+	}
 	p.DoMarker("CoreTimingEvents");
 }
 
@@ -218,6 +316,16 @@ u64 GetIdleTicks()
 	return (u64)idledCycles;
 }
 
+u64 GetSliceCount()
+{
+	return sliceCount;
+}
+
+u64 GetEmptySliceCount()
+{
+	return emptySliceCount;
+}
+
 // This is to be called when outside threads, such as the graphics thread, wants to
 // schedule things to be executed on the main thread.
 void ScheduleEvent_Threadsafe(int cyclesIntoFuture, int event_type, u64 userdata)
@@ -229,12 +337,14 @@ void ScheduleEvent_Threadsafe(int cyclesIntoFuture, int event_type, u64 userdata
 		                   "was active.  This is likely to cause a desync.",
 		                   event_types[event_type].name.c_str());
 	}
-	std::lock_guard<std::mutex> lk(tsWriteLock);
-	Event ne;
-	ne.time = globalTimer + cyclesIntoFuture;
-	ne.type = event_type;
-	ne.userdata = userdata;
-	tsQueue.Push(ne);
+	ThreadsafeEvent* ne = new ThreadsafeEvent;
+	ne->time = globalTimer + cyclesIntoFuture;
+	ne->type = event_type;
+	ne->userdata = userdata;
+	ne->next = tsQueue.load(std::memory_order_relaxed);
+	while (!tsQueue.compare_exchange_weak(ne->next, ne, std::memory_order_release, std::memory_order_relaxed))
+	{
+	}
 }
 
 // Executes an event immediately, then returns.
@@ -260,30 +370,10 @@ void ScheduleEvent_Threadsafe_Immediate(int event_type, u64 userdata)
 
 void ClearPendingEvents()
 {
-	while (first)
-	{
-		Event *e = first->next;
-		FreeEvent(first);
-		first = e;
-	}
-}
-
-static void AddEventToQueue(Event* ne)
-{
-	Event* prev = nullptr;
-	Event** pNext = &first;
-	for (;;)
-	{
-		Event*& next = *pNext;
-		if (!next || ne->time < next->time)
-		{
-			ne->next = next;
-			next = ne;
-			break;
-		}
-		prev = next;
-		pNext = &prev->next;
-	}
+	eventQueue.clear();
+	cancelledEvents = 0;
+	for (EventType& type : event_types)
+		type.pending = 0;
 }
 
 // This must be run ONLY from within the CPU thread
@@ -293,40 +383,33 @@ void ScheduleEvent(int cyclesIntoFuture, int event_type, u64 userdata)
 {
 	_assert_msg_(POWERPC, Core::IsCPUThread() || Core::GetState() == Core::CORE_PAUSE,
 				 "ScheduleEvent from wrong thread");
-	Event *ne = GetNewEvent();
-	ne->userdata = userdata;
-	ne->type = event_type;
-	ne->time = globalTimer + cyclesIntoFuture;
-	AddEventToQueue(ne);
-}
+	PushEvent(globalTimer + cyclesIntoFuture, event_type, userdata);
 
-void RemoveEvent(int event_type)
-{
-	while (first && first->type == event_type)
+	// Adaptive slices can be far longer than the delay the CPU asked for.
+	if (adaptiveSlicing && !Core::g_want_determinism && !runningEvents &&
+	    DowncountToCycles(PowerPC::ppcState.downcount) > cyclesIntoFuture)
 	{
-		Event* next = first->next;
-		FreeEvent(first);
-		first = next;
+		maxSliceLength = MAX_SLICE_LENGTH;
+		ForceExceptionCheck(cyclesIntoFuture);
 	}
+}
 
-	if (!first)
+void RemoveEvent(int event_type)
+{
+	EventType& type = event_types[event_type];
+	if (!type.pending)
 		return;
 
-	Event *prev = first;
-	Event *ptr = prev->next;
-	while (ptr)
+	type.generation++;
+	cancelledEvents += type.pending;
+	type.pending = 0;
+
+	// Rebuild the heap once most of it is dead, which keeps this O(1) amortized.
+	if (cancelledEvents * 2 > eventQueue.size())
 	{
-		if (ptr->type == event_type)
-		{
-			prev->next = ptr->next;
-			FreeEvent(ptr);
-			ptr = prev->next;
-		}
-		else
-		{
-			prev = ptr;
-			ptr = ptr->next;
-		}
+		eventQueue.erase(std::remove_if(eventQueue.begin(), eventQueue.end(), IsCancelled), eventQueue.end());
+		std::make_heap(eventQueue.begin(), eventQueue.end(), std::greater<Event>());
+		cancelledEvents = 0;
 	}
 }
 
@@ -345,71 +428,103 @@ void ForceExceptionCheck(int cycles)
 	}
 }
 
+void AddTicks(int cycles)
+{
+	PowerPC::ppcState.downcount -= CyclesToDowncount(cycles);
+}
+
+
+// The first event must not be cancelled.
+static void RunFirstEvent()
+{
+	Event evt = eventQueue.front();
+	PopEvent();
+	event_types[evt.type].pending--;
+	event_types[evt.type].callback(evt.userdata, (int)(globalTimer - evt.time));
+}
 
 //This raise only the events required while the fifo is processing data
 void ProcessFifoWaitEvents()
 {
 	MoveEvents();
 
-	if (!first)
-		return;
-
-	while (first)
+	SkipCancelledEvents();
+	while (!eventQueue.empty() && eventQueue.front().time <= globalTimer)
 	{
-		if (first->time <= globalTimer)
-		{
-			Event* evt = first;
-			first = first->next;
-			event_types[evt->type].callback(evt->userdata, (int)(globalTimer - evt->time));
-			FreeEvent(evt);
-		}
-		else
-		{
-			break;
-		}
+		RunFirstEvent();
+		SkipCancelledEvents();
 	}
 }
 
 void MoveEvents()
 {
-	BaseEvent sevt;
-	while (tsQueue.Pop(sevt))
+	if (!tsQueue.load(std::memory_order_relaxed))
+		return;
+
+	maxSliceLength = MAX_SLICE_LENGTH;
+
+	// The list is newest first, reverse it to keep the scheduling order.
+	ThreadsafeEvent* list = tsQueue.exchange(nullptr, std::memory_order_acquire);
+	ThreadsafeEvent* reversed = nullptr;
+	while (list)
 	{
-		Event *evt = GetNewEvent();
-		evt->time = sevt.time;
-		evt->userdata = sevt.userdata;
-		evt->type = sevt.type;
-		AddEventToQueue(evt);
+		ThreadsafeEvent* next = list->next;
+		list->next = reversed;
+		reversed = list;
+		list = next;
+	}
+
+	while (reversed)
+	{
+		ThreadsafeEvent* next = reversed->next;
+		PushEvent(reversed->time, reversed->type, reversed->userdata);
+		delete reversed;
+		reversed = next;
 	}
 }
 
 void Advance()
 {
 	MoveEvents();
+	Profiler::TakeRequestedSample();
 
 	int cyclesExecuted = slicelength - DowncountToCycles(PowerPC::ppcState.downcount);
 	globalTimer += cyclesExecuted;
 	lastOCFactor = SConfig::GetInstance().m_OCEnable ? SConfig::GetInstance().m_OCFactor : 1.0f;
 	PowerPC::ppcState.downcount = CyclesToDowncount(slicelength);
 
-	while (first && first->time <= globalTimer)
+	bool ranEvents = false;
+	runningEvents = true;
+	SkipCancelledEvents();
+	while (!eventQueue.empty() && eventQueue.front().time <= globalTimer)
 	{
-		//LOG(POWERPC, "[Scheduler] %s     (%lld, %lld) ",
-		//             event_types[first->type].name ? event_types[first->type].name : "?", (u64)globalTimer, (u64)first->time);
-		Event* evt = first;
-		first = first->next;
-		event_types[evt->type].callback(evt->userdata, (int)(globalTimer - evt->time));
-		FreeEvent(evt);
+		RunFirstEvent();
+		SkipCancelledEvents();
+		ranEvents = true;
 	}
+	runningEvents = false;
+
+	sliceCount++;
+	if (!ranEvents)
+		emptySliceCount++;
+
+	// Movies and netplay need the same slices on every run.
+	bool adaptive = adaptiveSlicing && !Core::g_want_determinism;
+	if (!adaptive)
+		maxSliceLength = MAX_SLICE_LENGTH;
+	else if (!ranEvents)
+		maxSliceLength = std::min(maxSliceLength * 2, MAX_ADAPTIVE_SLICE_LENGTH);
 
-	if (!first)
+	if (eventQueue.empty())
 	{
 		WARN_LOG(POWERPC, "WARNING - no events in queue. Setting downcount to 10000");
 		PowerPC::ppcState.downcount += CyclesToDowncount(10000);
 	}
 	else
 	{
-		slicelength = (int)(first->time - globalTimer);
+		slicelength = (int)(eventQueue.front().time - globalTimer);
+		if (adaptive && slicelength < MIN_ADAPTIVE_SLICE_LENGTH)
+			slicelength = MIN_ADAPTIVE_SLICE_LENGTH;
 		if (slicelength > maxSliceLength)
 			slicelength = maxSliceLength;
 		PowerPC::ppcState.downcount = CyclesToDowncount(slicelength);
@@ -418,12 +533,8 @@ void Advance()
 
 void LogPendingEvents()
 {
-	Event *ptr = first;
-	while (ptr)
-	{
-		INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %d", globalTimer, ptr->time, ptr->type);
-		ptr = ptr->next;
-	}
+	for (const Event& ev : GetSortedEvents())
+		INFO_LOG(POWERPC, "PENDING: Now: %" PRId64 " Pending: %" PRId64 " Type: %d", globalTimer, ev.time, ev.type);
 }
 
 void Idle()
@@ -443,21 +554,41 @@ void Idle()
 	PowerPC::ppcState.downcount = 0;
 }
 
+void IdleLoop(u32 address)
+{
+	s64 idled = idledCycles;
+	Idle();
+
+	IdleLoopStats& stats = idleLoops[address];
+	stats.address = address;
+	stats.count++;
+	stats.cycles += idledCycles - idled;
+}
+
+std::vector<IdleLoopStats> GetIdleLoopStats()
+{
+	std::vector<IdleLoopStats> result;
+	for (const auto& loop : idleLoops)
+		result.push_back(loop.second);
+	std::sort(result.begin(), result.end(), [](const IdleLoopStats& a, const IdleLoopStats& b) {
+		return a.cycles != b.cycles ? a.cycles > b.cycles : a.address < b.address;
+	});
+	return result;
+}
+
 std::string GetScheduledEventsSummary()
 {
-	Event *ptr = first;
 	std::string text = "Scheduled events\n";
 	text.reserve(1000);
-	while (ptr)
+	for (const Event& ev : GetSortedEvents())
 	{
-		unsigned int t = ptr->type;
+		unsigned int t = ev.type;
 		if (t >= event_types.size())
 			PanicAlertT("Invalid event type %i", t);
 
-		const std::string& name = event_types[ptr->type].name;
+		const std::string& name = event_types[ev.type].name;
 
-		text += StringFromFormat("%s : %" PRIi64 " %016" PRIx64 "\n", name.c_str(), ptr->time, ptr->userdata);
-		ptr = ptr->next;
+		text += StringFromFormat("%s : %" PRIi64 " %016" PRIx64 "\n", name.c_str(), ev.time, ev.userdata);
 	}
 	return text;
 }
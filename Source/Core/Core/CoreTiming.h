@@ -18,6 +18,7 @@
 //   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
 
 #include <string>
+#include <vector>
 #include "Common/CommonTypes.h"
 
 class PointerWrap;
@@ -37,6 +38,10 @@ typedef void (*TimedCallback)(u64 userdata, int cyclesLate);
 u64 GetTicks();
 u64 GetIdleTicks();
 
+// The number of slices Advance has ended, and how many of them ran no events.
+u64 GetSliceCount();
+u64 GetEmptySliceCount();
+
 void DoState(PointerWrap &p);
 
 // Returns the event_type identifier. if name is not unique, an existing event_type will be discarded.
@@ -59,6 +64,19 @@ void ProcessFifoWaitEvents();
 // Pretend that the main CPU has executed enough cycles to reach the next event.
 void Idle();
 
+struct IdleLoopStats
+{
+	u32 address;
+	u64 count;   // times the loop was skipped
+	u64 cycles;  // cycles skipped
+};
+
+// Idle() for the busy wait loop starting at address, see
+// PPCAnalyst::CodeOp::branchIsIdleLoop. Keeps per-loop statistics.
+void IdleLoop(u32 address);
+// Sorted by skipped cycles, most first.
+std::vector<IdleLoopStats> GetIdleLoopStats();
+
 // Clear all pending events. This should ONLY be done on exit or state load.
 void ClearPendingEvents();
 
@@ -76,6 +94,9 @@ u64 GetFakeTBStartTicks();
 void SetFakeTBStartTicks(u64 val);
 
 void ForceExceptionCheck(int cycles);
+// Charges cycles to the CPU as if it had run code for them, e.g. for
+// functions replaced by host code.
+void AddTicks(int cycles);
 
 extern int slicelength;
 
@@ -4,6 +4,7 @@
 
 #include <cstring>
 
+#include "Common/JitRegister.h"
 #include "Core/DSP/DSPAnalyzer.h"
 #include "Core/DSP/DSPCore.h"
 #include "Core/DSP/DSPEmitter.h"
@@ -370,6 +371,8 @@ void DSPEmitter::Compile(u16 start_addr)
 		MOV(16, R(EAX), Imm16(blockSize[start_addr]));
 	}
 	JMP(returnDispatcher, true);
+
+	JitRegister::Register(entryPoint, GetCodePtr(), "JIT_DSP_%04x", start_addr);
 }
 
 const u8 *DSPEmitter::CompileStub()
@@ -378,6 +381,7 @@ const u8 *DSPEmitter::CompileStub()
 	ABI_CallFunction((void *)&CompileCurrent);
 	XOR(32, R(EAX), R(EAX)); // Return 0 cycles executed
 	JMP(returnDispatcher);
+	JitRegister::Register(entryPoint, GetCodePtr(), "JIT_DSP_Stub");
 	return entryPoint;
 }
 
@@ -423,4 +427,6 @@ void DSPEmitter::CompileDispatcher()
 	//MOV(32, M(&cyclesLeft), Imm32(0));
 	ABI_PopRegistersAndAdjustStack(registers_used, 8);
 	RET();
+
+	JitRegister::Register(enterDispatcher, GetCodePtr(), "JIT_DSP_Dispatcher");
 }
@@ -9,6 +9,7 @@
 #include "Core/Debugger/Debugger_SymbolMap.h"
 #include "Core/HLE/HLE.h"
 #include "Core/HLE/HLE_Misc.h"
+#include "Core/HLE/HLE_Native.h"
 #include "Core/HLE/HLE_OS.h"
 #include "Core/HW/Memmap.h"
 #include "Core/IPC_HLE/WII_IPC_HLE_Device_es.h"
@@ -59,6 +60,17 @@ static const SPatch OSPatches[] =
 	{ "___blank",             HLE_OS::HLE_GeneralDebugPrint,   HLE_HOOK_REPLACE, HLE_TYPE_DEBUG },
 	{ "__write_console",      HLE_OS::HLE_write_console,       HLE_HOOK_REPLACE, HLE_TYPE_DEBUG }, // used by sysmenu (+more?)
 	{ "GeckoCodehandler",     HLE_Misc::HLEGeckoCodehandler,   HLE_HOOK_START,   HLE_TYPE_GENERIC },
+
+	// Hot libc and SDK routines, found through the map file or the signature database
+	{ "memcpy",               HLE_Native::Memcpy,              HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "memset",               HLE_Native::Memset,              HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "__fill_mem",           HLE_Native::FillMem,             HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "DCFlushRange",         HLE_Native::DCFlushRange,        HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "DCStoreRange",         HLE_Native::DCStoreRange,        HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "DCInvalidateRange",    HLE_Native::DCInvalidateRange,   HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "PSMTXConcat",          HLE_Native::PSMTXConcat,         HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "PSMTXMultVec",         HLE_Native::PSMTXMultVec,        HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
+	{ "__ieee754_sqrt",       HLE_Native::Sqrt,                HLE_HOOK_REPLACE, HLE_TYPE_NATIVE },
 };
 
 static const SPatch OSBreakPoints[] =
@@ -146,6 +158,9 @@ bool IsEnabled(int flags)
 	if (flags == HLE::HLE_TYPE_DEBUG && !SConfig::GetInstance().bEnableDebugging && PowerPC::GetMode() != MODE_INTERPRETER)
 		return false;
 
+	if (flags == HLE::HLE_TYPE_NATIVE && !SConfig::GetInstance().bHLENativeFunctions)
+		return false;
+
 	return true;
 }
 
@@ -156,10 +171,8 @@ u32 UnPatch(const std::string& patchName)
 	if (symbol)
 	{
 		for (u32 addr = symbol->address; addr < symbol->address + symbol->size; addr += 4)
-		{
 			orig_instruction[addr] = 0;
-			PowerPC::ppcState.iCache.Invalidate(addr);
-		}
+		PowerPC::ppcState.iCache.InvalidateRange(symbol->address, symbol->size);
 		return symbol->address;
 	}
 
@@ -0,0 +1,353 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/MathUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HLE/HLE_Native.h"
+#include "Core/HW/DSP.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter_FPUtils.h"
+
+namespace HLE_Native
+{
+
+// Rough guest cycle counts of the SDK implementations: a fixed part for the
+// call and setup, plus the inner loops.
+enum
+{
+	MEMCPY_CYCLES = 30,        // + 1 per byte
+	MEMSET_CYCLES = 30,        // + 1 per 2 bytes
+	DC_RANGE_CYCLES = 10,      // + 3 per cache line
+	PSMTXCONCAT_CYCLES = 60,
+	PSMTXMULTVEC_CYCLES = 20,
+	SQRT_CYCLES = 150,
+};
+
+// Host pointer to [address, address + size) if all of it is in the BAT mapped
+// views of MEM1 or MEM2, where neither the MMU nor MMIO can get in the way.
+static u8* GetRAMRange(u32 address, u32 size)
+{
+	if (SConfig::GetInstance().bMMU)
+		return nullptr;
+
+	u32 segment = address >> 28;
+	u64 end = (u64)(address & 0x0FFFFFFF) + size;
+	if ((segment == 0x8 || segment == 0xC) && end <= Memory::REALRAM_SIZE)
+		return Memory::m_pRAM + (address & 0x0FFFFFFF);
+	if (Memory::m_pEXRAM && (segment == 0x9 || segment == 0xD) && end <= Memory::EXRAM_SIZE)
+		return Memory::m_pEXRAM + (address & 0x0FFFFFFF);
+	return nullptr;
+}
+
+static bool HasDSI()
+{
+	return (PowerPC::ppcState.Exceptions & EXCEPTION_DSI) != 0;
+}
+
+// Under the MMU, an access to a page the guest hasn't mapped yet raises a DSI.
+// The routine then leaves NPC at its entry, where the caller raises the
+// exception, and the guest's handler returns to the start of the call. That
+// works out the same as resuming it, as the routines read all of their inputs
+// before they write, and a write only faults on a page none of them are on.
+static bool RestartOnDSI()
+{
+	if (!HasDSI())
+		return false;
+	NPC = PC;
+	return true;
+}
+
+// The SDK's memcpy copies backwards when the destination is above the source,
+// so it behaves like memmove. A write that faults then leaves the bytes of the
+// source that weren't copied yet unchanged.
+static void CopyMemory(u32 dst, u32 src, u32 size)
+{
+	u8* host_dst = GetRAMRange(dst, size);
+	u8* host_src = GetRAMRange(src, size);
+	if (host_dst && host_src)
+	{
+		std::memmove(host_dst, host_src, size);
+		return;
+	}
+
+	std::vector<u8> buffer(size);
+	for (u32 i = 0; i < size; i++)
+	{
+		buffer[i] = PowerPC::Read_U8(src + i);
+		if (HasDSI())
+			return;
+	}
+
+	if (dst <= src)
+	{
+		for (u32 i = 0; i < size && !HasDSI(); i++)
+			PowerPC::Write_U8(buffer[i], dst + i);
+	}
+	else
+	{
+		for (u32 i = size; i-- > 0 && !HasDSI();)
+			PowerPC::Write_U8(buffer[i], dst + i);
+	}
+}
+
+static void FillMemory(u32 dst, u8 value, u32 size)
+{
+	u8* host_dst = GetRAMRange(dst, size);
+	if (host_dst)
+	{
+		std::memset(host_dst, value, size);
+		return;
+	}
+
+	for (u32 i = 0; i < size && !HasDSI(); i++)
+		PowerPC::Write_U8(value, dst + i);
+}
+
+// void* memcpy(void* dst, const void* src, size_t n)
+void Memcpy()
+{
+	u32 size = GPR(5);
+	CopyMemory(GPR(3), GPR(4), size);
+	if (RestartOnDSI())
+		return;
+	// r3 still holds dst, the return value.
+	CoreTiming::AddTicks(MEMCPY_CYCLES + size);
+	NPC = LR;
+}
+
+// void* memset(void* dst, int value, size_t n)
+void Memset()
+{
+	u32 size = GPR(5);
+	FillMemory(GPR(3), (u8)GPR(4), size);
+	if (RestartOnDSI())
+		return;
+	CoreTiming::AddTicks(MEMSET_CYCLES + size / 2);
+	NPC = LR;
+}
+
+// void __fill_mem(void* dst, int value, size_t n), memset's worker in MSL.
+void FillMem()
+{
+	Memset();
+}
+
+// Number of 32 byte cache lines the SDK's DC*Range(addr, n) touch.
+static u32 GetCacheLineCount(u32 address, u32 size)
+{
+	if (!size)
+		return 0;
+	return (u32)(((u64)(address & 0x1f) + size + 0x1f) >> 5);
+}
+
+// The data cache isn't emulated, so dcbf and dcbst only matter to the JIT.
+static void FlushDataCacheRange(u32 address, u32 size)
+{
+	u32 lines = GetCacheLineCount(address, size);
+	if (lines)
+		JitInterface::InvalidateICache(address & ~0x1f, lines * 32, false);
+	CoreTiming::AddTicks(DC_RANGE_CYCLES + 3 * lines);
+}
+
+// void DCFlushRange(void* addr, u32 n)
+void DCFlushRange()
+{
+	FlushDataCacheRange(GPR(3), GPR(4));
+	NPC = LR;
+}
+
+// void DCStoreRange(void* addr, u32 n)
+void DCStoreRange()
+{
+	FlushDataCacheRange(GPR(3), GPR(4));
+	NPC = LR;
+}
+
+// void DCInvalidateRange(void* addr, u32 n)
+void DCInvalidateRange()
+{
+	u32 address = GPR(3) & ~0x1f;
+	u32 lines = GetCacheLineCount(GPR(3), GPR(4));
+	// Same as dcbi on each line, see Interpreter::dcbi.
+	for (u32 i = 0; i < lines; i++)
+		DSP::FlushInstantDMA(address + i * 32);
+	if (lines)
+		JitInterface::InvalidateICache(address, lines * 32, false);
+	CoreTiming::AddTicks(DC_RANGE_CYCLES + 3 * lines);
+	NPC = LR;
+}
+
+// Converted like psq_l and psq_st with a float GQR, which the SDK routines
+// load and store with.
+static double LoadFloat(u32 address)
+{
+	return MathUtil::IntFloat(PowerPC::Read_U32(address)).f;
+}
+
+static void StoreFloat(double value, u32 address)
+{
+	PowerPC::Write_U32(ConvertToSingleFTZ(MathUtil::IntDouble(value).i), address);
+}
+
+// The paired single operations the SDK routines are made of, rounded like the
+// interpreter rounds them.
+static double MulS(double a, double c)
+{
+	return ForceSingle(NI_mul(a, Force25Bit(c)));
+}
+
+static double MaddS(double a, double c, double b)
+{
+	return ForceSingle(NI_madd(a, Force25Bit(c), b));
+}
+
+static double AddS(double a, double b)
+{
+	return ForceSingle(NI_add(a, b));
+}
+
+// void PSMTXConcat(const Mtx a, const Mtx b, Mtx ab), ab = a * b with 3x4
+// matrices. ab may be a or b, as both are read before ab is written.
+void PSMTXConcat()
+{
+	u32 a_address = GPR(3);
+	u32 b_address = GPR(4);
+	u32 ab_address = GPR(5);
+
+	double a[3][4], b[3][4];
+	for (u32 i = 0; i < 3; i++)
+	{
+		for (u32 j = 0; j < 4; j++)
+		{
+			a[i][j] = LoadFloat(a_address + (i * 4 + j) * 4);
+			b[i][j] = LoadFloat(b_address + (i * 4 + j) * 4);
+		}
+	}
+	if (RestartOnDSI())
+		return;
+
+	for (u32 i = 0; i < 3; i++)
+	{
+		for (u32 j = 0; j < 4; j++)
+		{
+			// The SDK multiplies pairs of b by a single element of a, and adds
+			// a[i][3] times the {0, 1} constant to the last two columns. 0 * a[i][3]
+			// is not a no-op: it turns an infinity into a NaN, and -0 + 0 into 0.
+			double t = MulS(b[0][j], a[i][0]);
+			t = MaddS(b[1][j], a[i][1], t);
+			t = MaddS(b[2][j], a[i][2], t);
+			if (j >= 2)
+				t = MaddS(j == 3 ? 1.0 : 0.0, a[i][3], t);
+			StoreFloat(t, ab_address + (i * 4 + j) * 4);
+		}
+	}
+	if (RestartOnDSI())
+		return;
+
+	CoreTiming::AddTicks(PSMTXCONCAT_CYCLES);
+	NPC = LR;
+}
+
+// (m0 * x + m2 * z) + (m1 * y + m3), summed pairwise like ps_sum0 does.
+static double MultVecRow(u32 row, double x, double y, double z)
+{
+	double even = MaddS(LoadFloat(row + 8), z, MulS(LoadFloat(row), x));
+	double odd = MaddS(LoadFloat(row + 12), 1.0, MulS(LoadFloat(row + 4), y));
+	return AddS(even, odd);
+}
+
+// void PSMTXMultVec(const Mtx m, const Vec* src, Vec* dst), dst = m * src.
+// The SDK stores dst->x before it reads the last row of m, which only matters
+// if the two overlap.
+void PSMTXMultVec()
+{
+	u32 m_address = GPR(3);
+	u32 src_address = GPR(4);
+	u32 dst_address = GPR(5);
+
+	double x = LoadFloat(src_address);
+	double y = LoadFloat(src_address + 4);
+	double z = LoadFloat(src_address + 8);
+
+	double result_x = MultVecRow(m_address, x, y, z);
+	double result_y = MultVecRow(m_address + 16, x, y, z);
+	// Faults on the last row before dst->x is stored.
+	LoadFloat(m_address + 32);
+	LoadFloat(m_address + 44);
+	if (RestartOnDSI())
+		return;
+	StoreFloat(result_x, dst_address);
+	double result_z = MultVecRow(m_address + 32, x, y, z);
+	StoreFloat(result_y, dst_address + 4);
+	StoreFloat(result_z, dst_address + 8);
+	if (RestartOnDSI())
+		return;
+
+	CoreTiming::AddTicks(PSMTXMULTVEC_CYCLES);
+	NPC = LR;
+}
+
+// Whether sqrt(x) isn't representable, for a positive finite x.
+static bool IsSqrtInexact(double x)
+{
+	// Scaling by an even power of two keeps r * r - x from underflowing to 0.
+	if (x < std::ldexp(1.0, -600))
+		x = std::ldexp(x, 600);
+	double r = std::sqrt(x);
+	return std::fma(r, r, -x) != 0.0;
+}
+
+// double __ieee754_sqrt(double x), fdlibm's software square root. The FPSCR is
+// left as the floating point operations fdlibm runs for each case leave it.
+void Sqrt()
+{
+	double x = rPS0(1);
+	double result;
+	if (std::isnan(x) || std::isinf(x))
+	{
+		// sqrt(NaN) = NaN, sqrt(+inf) = +inf, sqrt(-inf) = NaN
+		result = NI_madd(x, x, x);
+		UpdateFPRF(result);
+	}
+	else if (x == 0.0)
+	{
+		// sqrt(+-0) = +-0, without touching the FPU.
+		result = x;
+	}
+	else if (x < 0.0)
+	{
+		result = NI_div(NI_sub(x, x), NI_sub(x, x));
+		UpdateFPRF(result);
+	}
+	else
+	{
+		// Correctly rounded in the current rounding mode, like fdlibm's result,
+		// which it computes with integer operations.
+		result = std::sqrt(x);
+		if (IsSqrtInexact(x))
+		{
+			// fdlibm finds the rounding direction from 1 - tiny, and then 1 + tiny
+			// if that rounded up. Both are inexact, and only the second one
+			// rounding up, towards +inf, leaves FR set. The results are 1 or just
+			// below it, positive normal numbers.
+			SetFI(1);
+			FPSCR.FR = FPSCR.RN == 2;
+			UpdateFPRF(1.0);
+		}
+	}
+
+	rPS0(1) = result;
+	CoreTiming::AddTicks(SQRT_CYCLES);
+	NPC = LR;
+}
+
+}
@@ -0,0 +1,22 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+// Host implementations of SDK and libc routines that games spend a lot of
+// time in. Each leaves memory, the return value and the non-volatile
+// registers as the guest code would, and charges roughly the cycles the
+// guest code would have taken.
+namespace HLE_Native
+{
+	void Memcpy();
+	void Memset();
+	void FillMem();
+	void DCFlushRange();
+	void DCStoreRange();
+	void DCInvalidateRange();
+	void PSMTXConcat();
+	void PSMTXMultVec();
+	void Sqrt();
+}
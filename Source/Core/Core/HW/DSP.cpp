@@ -290,6 +290,13 @@ void Shutdown()
 	dsp_emulator = nullptr;
 }
 
+// With HLE, reading the high half of a mailbox only peeks at it.
+template <bool cpu_mailbox>
+static u16 ReadMailBoxHighHLE(u32)
+{
+	return dsp_emulator->DSP_ReadMailBoxHigh(cpu_mailbox);
+}
+
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 {
 	// Declare all the boilerplate direct MMIOs.
@@ -321,7 +328,11 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 	}
 
 	// DSP mail MMIOs call DSP emulator functions to get results or write data.
+	// Registered before Init, which creates the DSP emulator from the same setting.
+	bool hle = SConfig::GetInstance().bDSPHLE;
+
 	mmio->Register(base | DSP_MAIL_TO_DSP_HI,
+		hle ? MMIO::PureRead<u16>(ReadMailBoxHighHLE<true>) :
 		MMIO::ComplexRead<u16>([](u32) {
 			if (dsp_slice > DSP_MAIL_SLICE && dsp_is_lle)
 			{
@@ -343,6 +354,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 		})
 	);
 	mmio->Register(base | DSP_MAIL_FROM_DSP_HI,
+		hle ? MMIO::PureRead<u16>(ReadMailBoxHighHLE<false>) :
 		MMIO::ComplexRead<u16>([](u32) {
 			if (dsp_slice > DSP_MAIL_SLICE && dsp_is_lle)
 			{
@@ -569,6 +581,10 @@ static void Do_ARAM_DMA()
 		g_arDMA.ARAddr &= 0x3ffffff;
 		g_arDMA.MMAddr &= 0x3ffffff;
 
+		// Games copy code out of ARAM too; drop what was compiled from the
+		// destination in one go.
+		PowerPC::ppcState.iCache.InvalidateRange(g_arDMA.MMAddr, g_arDMA.Cnt.count);
+
 		if (g_arDMA.ARAddr < g_ARAM.size)
 		{
 			while (g_arDMA.Cnt.count)
@@ -429,6 +429,7 @@ const DiscIO::IVolume& GetVolume()
 bool SetVolumeName(const std::string& disc_path)
 {
 	DVDThread::WaitUntilIdle();
+	DVDThread::InvalidateCache();
 	s_inserted_volume = DiscIO::CreateVolumeFromFilename(disc_path);
 	return VolumeIsValid();
 }
@@ -436,6 +437,7 @@ bool SetVolumeName(const std::string& disc_path)
 bool SetVolumeDirectory(const std::string& full_path, bool is_wii, const std::string& apploader_path, const std::string& DOL_path)
 {
 	DVDThread::WaitUntilIdle();
+	DVDThread::InvalidateCache();
 	s_inserted_volume = DiscIO::CreateVolumeFromDirectory(full_path, is_wii, apploader_path, DOL_path);
 	return VolumeIsValid();
 }
@@ -465,6 +467,7 @@ bool IsDiscInside()
 void EjectDiscCallback(u64 userdata, int cyclesLate)
 {
 	DVDThread::WaitUntilIdle();
+	DVDThread::InvalidateCache();
 	s_inserted_volume.reset();
 	SetDiscInside(false);
 }
@@ -517,6 +520,7 @@ void SetLidOpen(bool _bOpen)
 bool ChangePartition(u64 offset)
 {
 	DVDThread::WaitUntilIdle();
+	DVDThread::InvalidateCache();
 	return s_inserted_volume->ChangePartition(offset);
 }
 
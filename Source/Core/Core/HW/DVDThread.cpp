@@ -2,14 +2,19 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
 #include <cinttypes>
-#include <mutex>
+#include <cstring>
+#include <map>
 #include <thread>
+#include <utility>
 #include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/Event.h"
+#include "Common/FifoQueue.h"
 #include "Common/Flag.h"
 #include "Common/MsgHandler.h"
 #include "Common/Thread.h"
@@ -22,15 +27,37 @@
 #include "Core/HW/DVDThread.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
+#include "Core/PowerPC/PowerPC.h"
 
 #include "DiscIO/Volume.h"
 
 namespace DVDThread
 {
 
+struct ReadRequest
+{
+	u64 id;
+	u64 dvd_offset;
+	u32 output_address;
+	u32 length;
+	bool decrypt;
+	bool success;
+
+	// Used to notify emulated software after executing command.
+	// Pointers don't work with savestates, so CoreTiming events are used instead
+	int callback_event_type;
+
+	u64 time_started_ticks;
+	// The following time variables are only used for logging
+	u64 realtime_started_us;
+	u64 realtime_done_us;
+};
+
+using ReadResult = std::pair<ReadRequest, std::vector<u8>>;
+
 static void DVDThread();
 
-static void FinishRead(u64 userdata, int cyclesLate);
+static void FinishRead(u64 id, int cyclesLate);
 static int s_finish_read;
 
 static std::thread s_dvd_thread;
@@ -38,22 +65,40 @@ static Common::Event s_dvd_thread_start_working;
 static Common::Event s_dvd_thread_done_working;
 static Common::Flag s_dvd_thread_exiting(false);
 
-static std::vector<u8> s_dvd_buffer;
-static u64 s_time_read_started;
-static bool s_dvd_success;
-
-static u64 s_dvd_offset;
-static u32 s_output_address;
-static u32 s_length;
-static bool s_decrypt;
-
-// Used to notify emulated software after executing command.
-// Pointers don't work with savestates, so CoreTiming events are used instead
-static int s_callback_event_type;
-
-// The following time variables are only used for logging
-static u64 s_realtime_started_us;
-static u64 s_realtime_done_us;
+// Requests that haven't been read yet, results that are waiting for their
+// FinishRead event, and the number of requests that the DVD thread hasn't
+// fully handled, including the read-ahead behind them.
+static Common::FifoQueue<ReadRequest, false> s_request_queue;
+static Common::FifoQueue<ReadResult, false> s_result_queue;
+static Common::Event s_result_queue_expanded;
+static std::atomic<u32> s_pending_requests(0);
+
+// Results moved off s_result_queue by the CPU thread.
+static std::map<u64, ReadResult> s_result_map;
+static u64 s_next_id = 0;
+
+// Read-ahead for sequential reads, owned by the DVD thread. The guest-visible
+// timing is still decided by DVDInterface, this only saves host time.
+// It's read in chunks, so that a request queued meanwhile, or WaitUntilIdle,
+// waits for one chunk at most rather than for all of it.
+static const u32 MAX_READ_AHEAD = 0x100000;
+static const u32 READ_AHEAD_CHUNK = 0x8000;
+static Common::Flag s_stop_read_ahead(false);
+
+struct ReadAheadCache
+{
+	u64 dvd_offset;
+	bool decrypt;
+	std::vector<u8> data;
+};
+static ReadAheadCache s_cache;
+static u64 s_last_read_end;
+static bool s_last_read_decrypt;
+
+// Only used for logging
+static u32 s_reads;
+static u32 s_cache_hits;
+static u64 s_stall_us;
 
 void Start()
 {
@@ -74,38 +119,67 @@ void Stop()
 	s_dvd_thread.join();
 
 	s_dvd_thread_exiting.Clear();
+
+	ReadRequest request;
+	while (s_request_queue.Pop(request)) {}
+	ReadResult result;
+	while (s_result_queue.Pop(result)) {}
+	s_result_map.clear();
+	s_pending_requests.store(0);
+	InvalidateCache();
+
+	if (s_reads)
+	{
+		INFO_LOG(DVDINTERFACE, "%u of %u disc reads were served by the read-ahead. "
+		         "The CPU thread waited for the disc for %" PRIu64 " us.", s_cache_hits, s_reads, s_stall_us);
+	}
+	s_reads = 0;
+	s_cache_hits = 0;
+	s_stall_us = 0;
 }
 
 void DoState(PointerWrap &p)
 {
 	WaitUntilIdle();
 
-	// TODO: Savestates can be smaller if s_DVD_buffer is not saved
-	p.Do(s_dvd_buffer);
-	p.Do(s_time_read_started);
-	p.Do(s_dvd_success);
+	// Move everything to the result map, so that it's the only thing that
+	// needs to be savestated
+	ReadResult result;
+	while (s_result_queue.Pop(result))
+		s_result_map.emplace(result.first.id, std::move(result));
 
-	p.Do(s_dvd_offset);
-	p.Do(s_output_address);
-	p.Do(s_length);
-	p.Do(s_decrypt);
-	p.Do(s_callback_event_type);
+	// TODO: Savestates can be smaller if the buffers of results aren't saved,
+	// but instead get re-read from the disc when loading the savestate.
+	p.Do(s_result_map);
+	p.Do(s_next_id);
 
-	// s_realtime_started_us and s_realtime_done_us aren't savestated
+	// realtime_started_us and realtime_done_us aren't savestated
 	// because they rely on the current system's time.
 	// This means that loading a savestate might cause
 	// incorrect times to be logged once.
+
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		InvalidateCache();
 }
 
 void WaitUntilIdle()
 {
 	_assert_(Core::IsCPUThread());
 
-	// Wait until DVD thread isn't working
-	s_dvd_thread_done_working.Wait();
+	// Wait until DVD thread isn't working. The event may be left over from an
+	// earlier request, so check the count again after each wakeup. The
+	// read-ahead is cut short, it only has to stop using the volume.
+	s_stop_read_ahead.Set();
+	while (s_pending_requests.load() != 0)
+		s_dvd_thread_done_working.Wait();
+	s_stop_read_ahead.Clear();
+}
 
-	// Set the event again so that we still know that the DVD thread isn't working
-	s_dvd_thread_done_working.Set();
+void InvalidateCache()
+{
+	s_cache.data.clear();
+	s_last_read_end = 0;
+	s_last_read_decrypt = false;
 }
 
 void StartRead(u64 dvd_offset, u32 output_address, u32 length, bool decrypt,
@@ -113,45 +187,122 @@ void StartRead(u64 dvd_offset, u32 output_address, u32 length, bool decrypt,
 {
 	_assert_(Core::IsCPUThread());
 
-	s_dvd_thread_done_working.Wait();
+	ReadRequest request;
 
-	s_dvd_offset = dvd_offset;
-	s_output_address = output_address;
-	s_length = length;
-	s_decrypt = decrypt;
-	s_callback_event_type = callback_event_type;
+	request.id = s_next_id++;
+	request.dvd_offset = dvd_offset;
+	request.output_address = output_address;
+	request.length = length;
+	request.decrypt = decrypt;
+	request.success = false;
+	request.callback_event_type = callback_event_type;
 
-	s_time_read_started = CoreTiming::GetTicks();
-	s_realtime_started_us = Common::Timer::GetTimeUs();
+	request.time_started_ticks = CoreTiming::GetTicks();
+	request.realtime_started_us = Common::Timer::GetTimeUs();
+	request.realtime_done_us = 0;
 
+	s_pending_requests++;
+	s_request_queue.Push(request);
 	s_dvd_thread_start_working.Set();
 
-	CoreTiming::ScheduleEvent(ticks_until_completion, s_finish_read);
+	CoreTiming::ScheduleEvent(ticks_until_completion, s_finish_read, request.id);
 }
 
-static void FinishRead(u64 userdata, int cyclesLate)
+static void FinishRead(u64 id, int cyclesLate)
 {
-	WaitUntilIdle();
+	// We can't simply pop s_result_queue and always get the ReadResult
+	// we want, because the DVD thread may add ReadResults to the queue
+	// in a different order than we want to get them. What we do instead
+	// is to pop the queue until we find the ReadResult we want (the one
+	// whose ID matches userdata), which means we may end up popping
+	// ReadResults that we don't want. We can't add those unwanted results
+	// back to the queue, because the queue can only have one writer.
+	// Instead, we add them to a map that only is used by the CPU thread.
+	// When this function is called again later, it will check the map for
+	// the wanted ReadResult before it starts searching through the queue.
+	auto it = s_result_map.find(id);
+	if (it == s_result_map.end())
+	{
+		// A slow host read (compressed or encrypted images) makes the CPU
+		// thread wait here.
+		u64 wait_start_us = Common::Timer::GetTimeUs();
+		while (true)
+		{
+			ReadResult result;
+			while (s_result_queue.Pop(result))
+				s_result_map.emplace(result.first.id, std::move(result));
+
+			it = s_result_map.find(id);
+			if (it != s_result_map.end())
+				break;
+			s_result_queue_expanded.Wait();
+		}
+		s_stall_us += Common::Timer::GetTimeUs() - wait_start_us;
+	}
+
+	const ReadRequest& request = it->second.first;
+	const std::vector<u8>& buffer = it->second.second;
 
 	DEBUG_LOG(DVDINTERFACE, "Disc has been read. Real time: %" PRIu64 " us. "
 	          "Real time including delay: %" PRIu64 " us. Emulated time including delay: %" PRIu64 " us.",
-	          s_realtime_done_us - s_realtime_started_us,
-	          Common::Timer::GetTimeUs() - s_realtime_started_us,
-	          (CoreTiming::GetTicks() - s_time_read_started) / (SystemTimers::GetTicksPerSecond() / 1000 / 1000));
+	          request.realtime_done_us - request.realtime_started_us,
+	          Common::Timer::GetTimeUs() - request.realtime_started_us,
+	          (CoreTiming::GetTicks() - request.time_started_ticks) / (SystemTimers::GetTicksPerSecond() / 1000 / 1000));
 
-	if (s_dvd_success)
-		Memory::CopyToEmu(s_output_address, s_dvd_buffer.data(), s_length);
+	if (request.success)
+	{
+		Memory::CopyToEmu(request.output_address, buffer.data(), request.length);
+		PowerPC::ppcState.iCache.InvalidateRange(request.output_address, request.length);
+	}
 	else
 		PanicAlertT("The disc could not be read (at 0x%" PRIx64 " - 0x%" PRIx64 ").",
-		            s_dvd_offset, s_dvd_offset + s_length);
-
-	// This will make the buffer take less space in savestates.
-	// Reducing the size doesn't change the amount of reserved memory,
-	// so this doesn't lead to extra memory allocations.
-	s_dvd_buffer.resize(0);
+		            request.dvd_offset, request.dvd_offset + request.length);
 
 	// Notify the emulated software that the command has been executed
-	CoreTiming::ScheduleEvent_Immediate(s_callback_event_type, DVDInterface::INT_TCINT);
+	int callback_event_type = request.callback_event_type;
+	s_result_map.erase(it);
+	CoreTiming::ScheduleEvent_Immediate(callback_event_type, DVDInterface::INT_TCINT);
+}
+
+static bool ReadFromCache(const ReadRequest& request, u8* buffer)
+{
+	if (s_cache.data.empty() || s_cache.decrypt != request.decrypt || request.dvd_offset < s_cache.dvd_offset ||
+	    request.dvd_offset + request.length > s_cache.dvd_offset + s_cache.data.size())
+	{
+		return false;
+	}
+
+	memcpy(buffer, &s_cache.data[request.dvd_offset - s_cache.dvd_offset], request.length);
+	return true;
+}
+
+// Reads the data after a sequential read while the guest is busy with the
+// current one.
+static void ReadAhead(const ReadRequest& request)
+{
+	u64 offset = request.dvd_offset + request.length;
+	u32 length = std::min(request.length, MAX_READ_AHEAD);
+	if (!s_cache.data.empty() && s_cache.decrypt == request.decrypt && s_cache.dvd_offset <= offset &&
+	    offset + length <= s_cache.dvd_offset + s_cache.data.size())
+	{
+		return;
+	}
+
+	s_cache.dvd_offset = offset;
+	s_cache.decrypt = request.decrypt;
+	s_cache.data.clear();
+	// Stopping early leaves the chunks before it in the cache.
+	while (s_cache.data.size() < length && s_request_queue.Empty() && !s_stop_read_ahead.IsSet())
+	{
+		size_t done = s_cache.data.size();
+		u32 chunk_length = std::min<u32>(length - (u32)done, READ_AHEAD_CHUNK);
+		s_cache.data.resize(done + chunk_length);
+		if (!DVDInterface::GetVolume().Read(offset + done, chunk_length, &s_cache.data[done], request.decrypt))
+		{
+			s_cache.data.resize(done);
+			break;
+		}
+	}
 }
 
 static void DVDThread()
@@ -160,18 +311,44 @@ static void DVDThread()
 
 	while (true)
 	{
-		s_dvd_thread_done_working.Set();
-
 		s_dvd_thread_start_working.Wait();
 
 		if (s_dvd_thread_exiting.IsSet())
 			return;
 
-		s_dvd_buffer.resize(s_length);
-
-		s_dvd_success = DVDInterface::GetVolume().Read(s_dvd_offset, s_length, s_dvd_buffer.data(), s_decrypt);
-
-		s_realtime_done_us = Common::Timer::GetTimeUs();
+		ReadRequest request;
+		while (s_request_queue.Pop(request))
+		{
+			std::vector<u8> buffer(request.length);
+			s_reads++;
+			if (ReadFromCache(request, buffer.data()))
+			{
+				s_cache_hits++;
+				request.success = true;
+			}
+			else
+			{
+				request.success = DVDInterface::GetVolume().Read(request.dvd_offset, request.length, buffer.data(),
+				                                                 request.decrypt);
+			}
+
+			request.realtime_done_us = Common::Timer::GetTimeUs();
+
+			bool sequential = request.dvd_offset == s_last_read_end && request.decrypt == s_last_read_decrypt;
+			s_last_read_end = request.dvd_offset + request.length;
+			s_last_read_decrypt = request.decrypt;
+
+			s_result_queue.Push(ReadResult(request, std::move(buffer)));
+			s_result_queue_expanded.Set();
+
+			// Only when there's nothing else to read. A read the guest queues
+			// during it still waits for the chunk being read.
+			if (sequential && request.success && s_request_queue.Empty() && !s_stop_read_ahead.IsSet())
+				ReadAhead(request);
+
+			if (--s_pending_requests == 0)
+				s_dvd_thread_done_working.Set();
+		}
 	}
 }
 
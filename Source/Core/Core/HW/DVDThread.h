@@ -15,6 +15,8 @@ void Stop();
 void DoState(PointerWrap &p);
 
 void WaitUntilIdle();
+// Drops the read-ahead data. Call after WaitUntilIdle when the disc changes.
+void InvalidateCache();
 void StartRead(u64 dvd_offset, u32 output_address, u32 length, bool decrypt,
                int callback_event_type, int ticks_until_completion);
 
@@ -0,0 +1,228 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cinttypes>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/Thread.h"
+#include "Common/Timer.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/RunAhead.h"
+#include "Core/HW/FramePacer.h"
+#include "Core/HW/SystemTimers.h"
+#include "Core/HW/VideoInterface.h"
+
+namespace FramePacer
+{
+
+// How long before the deadline the OS sleep has to return. The rest of the
+// wait is spent spinning.
+#ifdef _WIN32
+static const u64 SPIN_US = 2000;
+#else
+static const u64 SPIN_US = 250;
+#endif
+
+static bool s_enabled;
+static bool s_pacing;
+// Host time the current field is due, fractional so that the field lengths
+// don't round off.
+static double s_deadline_us;
+static u64 s_last_ticks;
+static u64 s_last_field_us;
+
+static std::mutex s_histogram_lock;
+static std::vector<u64> s_histogram(HISTOGRAM_BUCKETS);
+static u64 s_frame_count;
+static u64 s_frame_time_sum;
+static u64 s_frame_time_max;
+
+void Init()
+{
+	s_enabled = SConfig::GetInstance().bPreciseFramePacing;
+	s_pacing = false;
+	s_last_field_us = 0;
+	ClearFrameTimes();
+}
+
+void Shutdown()
+{
+	if (!s_enabled)
+		return;
+
+	FrameTimeStats stats = GetFrameTimeStats();
+	if (!stats.count)
+		return;
+
+	std::string filename = File::GetUserPath(D_DUMP_IDX) + "Profiler/" +
+	                       SConfig::GetInstance().GetUniqueID() + ".frametimes.txt";
+	File::CreateFullPath(filename);
+	WriteFrameTimeHistogram(filename);
+	NOTICE_LOG(COMMON, "Field times: mean %" PRIu64 " us, median %" PRIu64 " us, 99th percentile %" PRIu64
+	           " us, max %" PRIu64 " us. Histogram written to %s", stats.mean_us, stats.p50_us, stats.p99_us,
+	           stats.max_us, filename.c_str());
+}
+
+bool IsEnabled()
+{
+	return s_enabled;
+}
+
+// Emulation speed relative to the console, like the Throttle event uses it.
+static double GetSpeed()
+{
+	const SConfig& config = SConfig::GetInstance();
+	if (config.m_Framelimit > 1 && VideoInterface::TargetRefreshRate)
+		return (config.m_Framelimit - 1) * 5.0 / VideoInterface::TargetRefreshRate;
+	return 1.0;
+}
+
+void PaceField()
+{
+	// With run-ahead, only the presented fields are paced. The emulated time
+	// between them is still one field.
+	if (!s_enabled || !RunAhead::IsPresentingField())
+		return;
+
+	const SConfig& config = SConfig::GetInstance();
+	bool frame_limiter = config.m_Framelimit && !Core::GetIsFramelimiterTempDisabled();
+	u64 ticks = CoreTiming::GetTicks();
+	u64 now = Common::Timer::GetTimeUs();
+
+	if (frame_limiter && s_pacing)
+	{
+		s_deadline_us += (ticks - s_last_ticks) * 1000000.0 / (SystemTimers::GetTicksPerSecond() * GetSpeed());
+
+		const double max_fallback = config.iTimingVariance * 1000.0;
+		if (now > s_deadline_us + max_fallback)
+		{
+			DEBUG_LOG(COMMON, "system too slow, %.0f us skipped", now - s_deadline_us - max_fallback);
+			s_deadline_us = now - max_fallback;
+		}
+		else
+		{
+			WaitUntil((u64)s_deadline_us);
+			now = Common::Timer::GetTimeUs();
+		}
+	}
+	else
+	{
+		// Start over from this field once the limit is back on.
+		s_deadline_us = (double)now;
+	}
+	s_pacing = frame_limiter;
+	s_last_ticks = ticks;
+
+	if (s_last_field_us)
+		RecordFrameTime(now - s_last_field_us);
+	s_last_field_us = now;
+}
+
+void WaitForEmulatedTime()
+{
+	// Run-ahead goes back and forth in emulated time.
+	if (!s_enabled || !s_pacing || Core::GetIsFramelimiterTempDisabled() || RunAhead::IsActive())
+		return;
+
+	double due_us = s_deadline_us + (CoreTiming::GetTicks() - s_last_ticks) * 1000000.0 /
+	                (SystemTimers::GetTicksPerSecond() * GetSpeed());
+	WaitUntil((u64)due_us);
+}
+
+void WaitUntil(u64 time_us)
+{
+	if (time_us > Common::Timer::GetTimeUs() + SPIN_US)
+		Common::Timer::SleepUntilUs(time_us - SPIN_US);
+	while (Common::Timer::GetTimeUs() < time_us)
+		Common::YieldCPU();
+}
+
+void RecordFrameTime(u64 time_us)
+{
+	std::lock_guard<std::mutex> lk(s_histogram_lock);
+	s_histogram[std::min<u64>(time_us / HISTOGRAM_BUCKET_US, HISTOGRAM_BUCKETS - 1)]++;
+	s_frame_count++;
+	s_frame_time_sum += time_us;
+	s_frame_time_max = std::max(s_frame_time_max, time_us);
+}
+
+void ClearFrameTimes()
+{
+	std::lock_guard<std::mutex> lk(s_histogram_lock);
+	std::fill(s_histogram.begin(), s_histogram.end(), 0);
+	s_frame_count = 0;
+	s_frame_time_sum = 0;
+	s_frame_time_max = 0;
+}
+
+std::vector<u64> GetFrameTimeHistogram()
+{
+	std::lock_guard<std::mutex> lk(s_histogram_lock);
+	return s_histogram;
+}
+
+// Upper end of the bucket the given fraction of the frame times is in.
+static u64 GetPercentile(u64 numerator, u64 denominator)
+{
+	u64 rank = (s_frame_count * numerator + denominator - 1) / denominator;
+	u64 seen = 0;
+	for (size_t i = 0; i < HISTOGRAM_BUCKETS - 1; i++)
+	{
+		seen += s_histogram[i];
+		if (seen >= rank)
+			return std::min<u64>((i + 1) * HISTOGRAM_BUCKET_US, s_frame_time_max);
+	}
+	return s_frame_time_max;
+}
+
+FrameTimeStats GetFrameTimeStats()
+{
+	std::lock_guard<std::mutex> lk(s_histogram_lock);
+	FrameTimeStats stats = {};
+	stats.count = s_frame_count;
+	if (!s_frame_count)
+		return stats;
+	stats.mean_us = s_frame_time_sum / s_frame_count;
+	stats.p50_us = GetPercentile(50, 100);
+	stats.p99_us = GetPercentile(99, 100);
+	stats.max_us = s_frame_time_max;
+	return stats;
+}
+
+void WriteFrameTimeHistogram(const std::string& filename)
+{
+	FrameTimeStats stats = GetFrameTimeStats();
+	std::vector<u64> histogram = GetFrameTimeHistogram();
+
+	File::IOFile f(filename, "w");
+	if (!f)
+	{
+		PanicAlert("Failed to open %s", filename.c_str());
+		return;
+	}
+	fprintf(f.GetHandle(), "fields: %" PRIu64 ", mean: %" PRIu64 " us, median: %" PRIu64 " us, 99th percentile: %"
+	        PRIu64 " us, max: %" PRIu64 " us\n", stats.count, stats.mean_us, stats.p50_us, stats.p99_us,
+	        stats.max_us);
+	fprintf(f.GetHandle(), "time (us)        fields\n");
+	for (size_t i = 0; i < histogram.size(); i++)
+	{
+		if (!histogram[i])
+			continue;
+		if (i == histogram.size() - 1)
+			fprintf(f.GetHandle(), "%6u+          %" PRIu64 "\n", (u32)(i * HISTOGRAM_BUCKET_US), histogram[i]);
+		else
+			fprintf(f.GetHandle(), "%6u-%-6u    %" PRIu64 "\n", (u32)(i * HISTOGRAM_BUCKET_US),
+			        (u32)((i + 1) * HISTOGRAM_BUCKET_US), histogram[i]);
+	}
+}
+
+}
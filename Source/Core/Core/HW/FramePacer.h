@@ -0,0 +1,60 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+
+// Paces emulation to the host clock at VI field boundaries, with microsecond
+// precision instead of the millisecond steps of the Throttle event. Used when
+// SConfig::bPreciseFramePacing is set.
+namespace FramePacer
+{
+
+// Width of a histogram bucket, and the number of buckets. The last bucket
+// also counts everything longer.
+enum
+{
+	HISTOGRAM_BUCKET_US = 100,
+	HISTOGRAM_BUCKETS = 500,
+};
+
+struct FrameTimeStats
+{
+	u64 count;
+	u64 mean_us;
+	u64 p50_us;
+	u64 p99_us;
+	u64 max_us;
+};
+
+void Init();
+void Shutdown();
+
+bool IsEnabled();
+
+// Called by VideoInterface at the end of each field. Waits until the host
+// time the field is due at the current speed limit.
+void PaceField();
+
+// Waits until the host time the current emulated time is due, for events
+// within a field that should line up with the host clock. Doesn't wait when
+// emulation is behind or nothing is being paced.
+void WaitForEmulatedTime();
+
+// Sleeps until Common::Timer::GetTimeUs() reaches time_us, and spins for the
+// last bit, which the OS sleep isn't precise enough for.
+void WaitUntil(u64 time_us);
+
+// Times between the fields as delivered, in microseconds.
+void RecordFrameTime(u64 time_us);
+void ClearFrameTimes();
+std::vector<u64> GetFrameTimeHistogram();
+FrameTimeStats GetFrameTimeStats();
+void WriteFrameTimeHistogram(const std::string& filename);
+
+}
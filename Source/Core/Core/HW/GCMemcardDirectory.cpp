@@ -91,11 +91,8 @@ int GCMemcardDirectory::LoadGCI(const std::string& fileName, DiscIO::IVolume::EC
 			return NO_INDEX;
 		}
 
-		if (m_GameId == BE32(gci.m_gci_header.Gamecode))
-		{
-			gci.LoadSaveBlocks();
-		}
-		else
+		// The save blocks are only read on the first access, or for a savestate.
+		if (m_GameId != BE32(gci.m_gci_header.Gamecode))
 		{
 			if (currentGameOnly)
 			{
@@ -144,6 +141,7 @@ GCMemcardDirectory::GCMemcardDirectory(const std::string& directory, int slot, u
 	, m_bat1(sizeMb)
 	, m_saves(0)
 	, m_SaveDirectory(directory)
+	, m_flush_stats()
 	, m_exiting(false)
 {
 	// Use existing header data if available
@@ -547,83 +545,122 @@ bool GCMemcardDirectory::SetUsedBlocks(int saveIndex)
 
 void GCMemcardDirectory::FlushToFile()
 {
-	std::unique_lock<std::mutex> l(m_write_mutex);
-	int errors = 0;
-	DEntry invalid;
-	for (u16 i = 0; i < m_saves.size(); ++i)
+	// The saves to write are copied with m_write_mutex held, and written
+	// without it, so that the emulation thread doesn't wait for the disk.
+	struct SaveFile
 	{
-		if (m_saves[i].m_dirty)
+		std::string filename;
+		DEntry header;
+		std::vector<GCMBlock> data;
+	};
+	std::vector<SaveFile> writes;
+	std::vector<std::string> deletes;
+
+	std::unique_lock<std::mutex> flush_lock(m_flush_mutex);
+	{
+		std::unique_lock<std::mutex> l(m_write_mutex);
+		for (u16 i = 0; i < m_saves.size(); ++i)
 		{
-			if (BE32(m_saves[i].m_gci_header.Gamecode) != 0xFFFFFFFF)
+			bool written = false;
+			if (m_saves[i].m_dirty)
 			{
-				m_saves[i].m_dirty = false;
-				if (m_saves[i].m_save_data.size() == 0)
-				{
-					// The save's header has been changed but the actual save blocks haven't been read/written to
-					// skip flushing this file until actual save data is modified
-					ERROR_LOG(EXPANSIONINTERFACE, "GCI header modified without corresponding save data changes");
-					continue;
-				}
-				if (m_saves[i].m_filename.empty())
+				if (BE32(m_saves[i].m_gci_header.Gamecode) != 0xFFFFFFFF)
 				{
-					std::string defaultSaveName = m_SaveDirectory + m_saves[i].m_gci_header.GCI_FileName();
-
-					// Check to see if another file is using the same name
-					// This seems unlikely except in the case of file corruption
-					// otherwise what user would name another file this way?
-					for (int j = 0; File::Exists(defaultSaveName) && j < 10; ++j)
+					m_saves[i].m_dirty = false;
+					// Saves are loaded on first access, so one whose header alone
+					// changed may not be loaded yet. Its file still has the data.
+					if (!m_saves[i].LoadSaveBlocks())
 					{
-						defaultSaveName.insert(defaultSaveName.end() - 4, '0');
+						// The save's header has been changed but the actual save blocks haven't been read/written to
+						// skip flushing this file until actual save data is modified
+						ERROR_LOG(EXPANSIONINTERFACE, "GCI header modified without corresponding save data changes");
+						continue;
 					}
-					if (File::Exists(defaultSaveName))
-						PanicAlertT("Failed to find new filename.\n%s\n will be overwritten", defaultSaveName.c_str());
-					m_saves[i].m_filename = defaultSaveName;
-				}
-				File::IOFile GCI(m_saves[i].m_filename, "wb");
-				if (GCI)
-				{
-					GCI.WriteBytes(&m_saves[i].m_gci_header, DENTRY_SIZE);
-					GCI.WriteBytes(m_saves[i].m_save_data.data(), BLOCK_SIZE * m_saves[i].m_save_data.size());
-
-					if (GCI.IsGood())
+					if (m_saves[i].m_filename.empty())
 					{
-						Core::DisplayMessage(
-							StringFromFormat("Wrote save contents to %s", m_saves[i].m_filename.c_str()), 4000);
-					}
-					else
-					{
-						++errors;
-						Core::DisplayMessage(
-							StringFromFormat("Failed to write save contents to %s", m_saves[i].m_filename.c_str()),
-							4000);
-						ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", m_saves[i].m_filename.c_str());
+						std::string defaultSaveName = m_SaveDirectory + m_saves[i].m_gci_header.GCI_FileName();
+
+						// Check to see if another file is using the same name
+						// This seems unlikely except in the case of file corruption
+						// otherwise what user would name another file this way?
+						for (int j = 0; File::Exists(defaultSaveName) && j < 10; ++j)
+						{
+							defaultSaveName.insert(defaultSaveName.end() - 4, '0');
+						}
+						if (File::Exists(defaultSaveName))
+							PanicAlertT("Failed to find new filename.\n%s\n will be overwritten", defaultSaveName.c_str());
+						m_saves[i].m_filename = defaultSaveName;
 					}
+					writes.push_back({m_saves[i].m_filename, m_saves[i].m_gci_header, m_saves[i].m_save_data});
+					written = true;
+				}
+				else if (m_saves[i].m_filename.length() != 0)
+				{
+					m_saves[i].m_dirty = false;
+					deletes.push_back(m_saves[i].m_filename);
+					m_saves[i].m_filename.clear();
+					m_saves[i].m_save_data.clear();
+					m_saves[i].m_used_blocks.clear();
 				}
 			}
-			else if (m_saves[i].m_filename.length() != 0)
+
+			// Unload the save data for any game that is not running
+			// we could use !m_dirty, but some games have multiple gci files and may not write to them simultaneously
+			// this ensures that the save data for all of the current games gci files are stored in the savestate
+			// A save written by this flush stays loaded until the next one, as its file is only
+			// written after the lock is released, and loading it before then would read the old data.
+			u32 gamecode = BE32(m_saves[i].m_gci_header.Gamecode);
+			if (!written && gamecode != m_GameId && gamecode != 0xFFFFFFFF && m_saves[i].m_save_data.size())
 			{
-				m_saves[i].m_dirty = false;
-				std::string &oldname = m_saves[i].m_filename;
-				std::string deletedname = oldname + ".deleted";
-				if (File::Exists(deletedname))
-					File::Delete(deletedname);
-				File::Rename(oldname, deletedname);
-				m_saves[i].m_filename.clear();
+				INFO_LOG(EXPANSIONINTERFACE, "Flushing savedata to disk for %s", m_saves[i].m_filename.c_str());
 				m_saves[i].m_save_data.clear();
-				m_saves[i].m_used_blocks.clear();
 			}
 		}
+	}
 
-		// Unload the save data for any game that is not running
-		// we could use !m_dirty, but some games have multiple gci files and may not write to them simultaneously
-		// this ensures that the save data for all of the current games gci files are stored in the savestate
-		u32 gamecode = BE32(m_saves[i].m_gci_header.Gamecode);
-		if (gamecode != m_GameId && gamecode != 0xFFFFFFFF && m_saves[i].m_save_data.size())
+	for (const std::string& oldname : deletes)
+	{
+		std::string deletedname = oldname + ".deleted";
+		if (File::Exists(deletedname))
+			File::Delete(deletedname);
+		File::Rename(oldname, deletedname);
+	}
+
+	u64 bytes = 0;
+	for (const SaveFile& save : writes)
+	{
+		// Through a temporary file, so that a crash doesn't leave a broken save.
+		std::string temp_filename = File::GetTempFilenameForAtomicWrite(save.filename);
+		bool good;
 		{
-			INFO_LOG(EXPANSIONINTERFACE, "Flushing savedata to disk for %s", m_saves[i].m_filename.c_str());
-			m_saves[i].m_save_data.clear();
+			File::IOFile GCI(temp_filename, "wb");
+			GCI.WriteBytes(&save.header, DENTRY_SIZE);
+			GCI.WriteBytes(save.data.data(), BLOCK_SIZE * save.data.size());
+			// On disk before the rename, which is then made durable as well.
+			good = GCI.Sync();
+		}
+		if (good)
+			good = File::RenameSync(temp_filename, save.filename);
+
+		if (good)
+		{
+			bytes += DENTRY_SIZE + BLOCK_SIZE * save.data.size();
+			Core::DisplayMessage(StringFromFormat("Wrote save contents to %s", save.filename.c_str()), 4000);
+		}
+		else
+		{
+			File::Delete(temp_filename);
+			Core::DisplayMessage(StringFromFormat("Failed to write save contents to %s", save.filename.c_str()), 4000);
+			ERROR_LOG(EXPANSIONINTERFACE, "Failed to save data to %s", save.filename.c_str());
 		}
 	}
+
+	if (!writes.empty())
+	{
+		m_flush_stats.flushes++;
+		m_flush_stats.last_files = writes.size();
+		m_flush_stats.last_bytes = bytes;
+	}
 #if _WRITE_MC_HEADER
 	u8 mc[BLOCK_SIZE * MC_FST_BLOCKS];
 	Read(0, BLOCK_SIZE * MC_FST_BLOCKS, mc);
@@ -632,6 +669,12 @@ void GCMemcardDirectory::FlushToFile()
 #endif
 }
 
+GCMemcardDirectory::FlushStats GCMemcardDirectory::GetFlushStats()
+{
+	std::unique_lock<std::mutex> l(m_flush_mutex);
+	return m_flush_stats;
+}
+
 void GCMemcardDirectory::DoState(PointerWrap &p)
 {
 	std::unique_lock<std::mutex> l(m_write_mutex);
@@ -648,6 +691,10 @@ void GCMemcardDirectory::DoState(PointerWrap &p)
 	m_saves.resize(numSaves);
 	for (auto itr = m_saves.begin(); itr != m_saves.end(); ++itr)
 	{
+		// The saves of the current game go into the savestate, whether the
+		// game has read them yet or not.
+		if (p.GetMode() != PointerWrap::MODE_READ && BE32(itr->m_gci_header.Gamecode) == m_GameId)
+			itr->LoadSaveBlocks();
 		itr->DoState(p);
 	}
 }
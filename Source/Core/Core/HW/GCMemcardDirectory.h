@@ -26,6 +26,7 @@ public:
 	GCMemcardDirectory(const std::string& directory, int slot = 0, u16 sizeMb = MemCard2043Mb, bool ascii = true,
 		DiscIO::IVolume::ECountry  card_region = DiscIO::IVolume::COUNTRY_EUROPE, int gameId = 0);
 	~GCMemcardDirectory();
+	// Writes the saves that changed since the last flush to their files.
 	void FlushToFile();
 	void FlushThread();
 	s32 Read(u32 address, s32 length, u8 *destaddress) override;
@@ -34,6 +35,15 @@ public:
 	void ClearAll() override {}
 	void DoState(PointerWrap &p) override;
 
+	struct FlushStats
+	{
+		u64 flushes;
+		// GCI files and bytes written by the last flush.
+		u64 last_files;
+		u64 last_bytes;
+	};
+	FlushStats GetFlushStats();
+
 private:
 	int LoadGCI(const std::string& fileName, DiscIO::IVolume::ECountry card_region, bool currentGameOnly);
 	inline s32 SaveAreaRW(u32 block, bool writing = false);
@@ -56,6 +66,9 @@ private:
 	const std::chrono::seconds flush_interval = std::chrono::seconds(1);
 	Common::Event m_flush_trigger;
 	std::mutex m_write_mutex;
+	// Held for a whole flush, which writes the files without m_write_mutex.
+	std::mutex m_flush_mutex;
+	FlushStats m_flush_stats;
 	std::atomic<bool> m_exiting;
 	std::thread m_flush_thread;
 };
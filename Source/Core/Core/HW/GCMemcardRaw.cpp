@@ -2,11 +2,15 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <memory>
+#include <utility>
+#include <vector>
 
 #include "Common/ChunkFile.h"
 #include "Common/FileUtil.h"
+#include "Common/Hash.h"
 #include "Common/Thread.h"
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
@@ -16,10 +20,99 @@
 #define SIZE_TO_Mb (1024 * 8 * 16)
 #define MC_HDR_SIZE 0xA000
 
+// The changed blocks are first written to a journal next to the card file, so
+// that a crash while patching the card file can be recovered from: a journal
+// with a good checksum is replayed when the card is opened, and one without is
+// from a crash before the card file was touched.
+static const u32 JOURNAL_MAGIC = 0x4a434d44; // "DMCJ"
+
+struct JournalHeader
+{
+	u32 magic;
+	u32 num_ranges;
+	// Adler-32 of the ranges and the data behind the header.
+	u32 checksum;
+};
+
+static std::string GetJournalFilename(const std::string& filename)
+{
+	return filename + ".journal";
+}
+
+static bool WriteJournal(const std::string& filename, const std::vector<std::pair<u32, u32>>& ranges, const u8* data)
+{
+	std::vector<u8> body(ranges.size() * 8);
+	for (size_t i = 0; i < ranges.size(); i++)
+	{
+		memcpy(&body[i * 8], &ranges[i].first, sizeof(u32));
+		memcpy(&body[i * 8 + 4], &ranges[i].second, sizeof(u32));
+	}
+	for (const auto& range : ranges)
+		body.insert(body.end(), data + range.first, data + range.first + range.second);
+
+	JournalHeader header;
+	header.magic = JOURNAL_MAGIC;
+	header.num_ranges = (u32)ranges.size();
+	header.checksum = HashAdler32(body.data(), body.size());
+
+	File::IOFile journal(filename, "wb");
+	return journal.WriteArray(&header, 1) && journal.WriteBytes(body.data(), body.size()) && journal.Sync();
+}
+
+// Applies the journal of an interrupted flush to the card file.
+static void ReplayJournal(const std::string& filename, const std::string& journal_filename)
+{
+	File::IOFile journal(journal_filename, "rb");
+	JournalHeader header;
+	std::vector<u8> body;
+	if (journal.ReadArray(&header, 1) && header.magic == JOURNAL_MAGIC &&
+	    journal.GetSize() >= sizeof(header) + header.num_ranges * 8ull)
+	{
+		body.resize(journal.GetSize() - sizeof(header));
+		if (!journal.ReadBytes(body.data(), body.size()) || HashAdler32(body.data(), body.size()) != header.checksum)
+			body.clear();
+	}
+	journal.Close();
+
+	if (body.empty())
+	{
+		WARN_LOG(EXPANSIONINTERFACE, "Discarding incomplete memory card journal %s", journal_filename.c_str());
+		File::Delete(journal_filename);
+		return;
+	}
+
+	File::IOFile card(filename, "r+b");
+	size_t data_offset = header.num_ranges * 8;
+	for (u32 i = 0; card && i < header.num_ranges; i++)
+	{
+		u32 offset, length;
+		memcpy(&offset, &body[i * 8], sizeof(u32));
+		memcpy(&length, &body[i * 8 + 4], sizeof(u32));
+		if (data_offset + length > body.size() || offset + (u64)length > card.GetSize())
+			break;
+		card.Seek(offset, SEEK_SET);
+		card.WriteBytes(&body[data_offset], length);
+		data_offset += length;
+	}
+	if (data_offset != body.size() || !card.Sync())
+	{
+		ERROR_LOG(EXPANSIONINTERFACE, "Could not replay memory card journal %s", journal_filename.c_str());
+		return;
+	}
+
+	NOTICE_LOG(EXPANSIONINTERFACE, "Replayed memory card journal %s", journal_filename.c_str());
+	card.Close();
+	File::Delete(journal_filename);
+}
+
 MemoryCard::MemoryCard(const std::string& filename, int _card_index, u16 sizeMb)
 	: MemoryCardBase(_card_index, sizeMb)
 	, m_filename(filename)
+	, m_flush_stats()
 {
+	if (File::Exists(GetJournalFilename(m_filename)))
+		ReplayJournal(m_filename, GetJournalFilename(m_filename));
+
 	File::IOFile pFile(m_filename, "rb");
 	if (pFile)
 	{
@@ -48,7 +141,11 @@ MemoryCard::MemoryCard(const std::string& filename, int _card_index, u16 sizeMb)
 
 	// Class members (including inherited ones) have now been initialized, so
 	// it's safe to startup the flush thread (which reads them).
+	// The flush buffer holds what the file does. A new card is written whole
+	// anyway.
 	m_flush_buffer = std::make_unique<u8[]>(memory_card_size);
+	memcpy(&m_flush_buffer[0], &m_memcard_data[0], memory_card_size);
+	m_dirty_blocks.resize((memory_card_size + BLOCK_SIZE - 1) / BLOCK_SIZE);
 	m_flush_thread = std::thread(&MemoryCard::FlushThread, this);
 }
 
@@ -72,6 +169,7 @@ void MemoryCard::FlushThread()
 	Common::SetCurrentThreadName(
 		StringFromFormat("Memcard %d flushing thread", card_index).c_str());
 
+	// The changes of a whole autosave are written together.
 	const auto flush_interval = std::chrono::seconds(15);
 
 	while (true)
@@ -88,23 +186,7 @@ void MemoryCard::FlushThread()
 			}
 		}
 
-		// Opening the file is purposefully done each iteration to ensure the
-		// file doesn't disappear out from under us after the first check.
-		File::IOFile pFile(m_filename, "r+b");
-
-		if (!pFile)
-		{
-			std::string dir;
-			SplitPath(m_filename, &dir, nullptr, nullptr);
-			if (!File::IsDirectory(dir))
-			{
-				File::CreateFullPath(dir);
-			}
-			pFile.Open(m_filename, "wb");
-		}
-
-		// Note - pFile may have changed above, after ctor
-		if (!pFile)
+		if (!Flush())
 		{
 			PanicAlertT(
 				"Could not write memory card file %s.\n\n"
@@ -118,12 +200,6 @@ void MemoryCard::FlushThread()
 			return;
 		}
 
-		{
-			std::unique_lock<std::mutex> l(m_flush_mutex);
-			memcpy(&m_flush_buffer[0], &m_memcard_data[0], memory_card_size);
-		}
-		pFile.WriteBytes(&m_flush_buffer[0], memory_card_size);
-
 		if (!do_exit)
 		{
 			Core::DisplayMessage(
@@ -143,6 +219,123 @@ void MemoryCard::MakeDirty()
 	m_dirty.Set();
 }
 
+void MemoryCard::MarkBlocksDirty(u32 address, u32 length)
+{
+	u32 end = std::min(address + length, memory_card_size);
+	for (u32 block = address / BLOCK_SIZE; block * BLOCK_SIZE < end; block++)
+		m_dirty_blocks[block] = true;
+}
+
+bool MemoryCard::Flush()
+{
+	std::unique_lock<std::mutex> write_lock(m_write_mutex);
+
+	// Ranges of consecutive dirty blocks, as offset and length.
+	std::vector<std::pair<u32, u32>> ranges;
+	{
+		std::unique_lock<std::mutex> l(m_flush_mutex);
+		for (u32 block = 0; block < m_dirty_blocks.size(); block++)
+		{
+			if (!m_dirty_blocks[block])
+				continue;
+			m_dirty_blocks[block] = false;
+
+			u32 offset = block * BLOCK_SIZE;
+			u32 length = std::min<u32>(BLOCK_SIZE, memory_card_size - offset);
+			memcpy(&m_flush_buffer[offset], &m_memcard_data[offset], length);
+			if (!ranges.empty() && ranges.back().first + ranges.back().second == offset)
+				ranges.back().second += length;
+			else
+				ranges.emplace_back(offset, length);
+		}
+	}
+
+	// Opening the file is purposefully done each flush to ensure the file
+	// doesn't disappear out from under us after the first check.
+	File::IOFile file(m_filename, "r+b");
+	if (!file || file.GetSize() != memory_card_size)
+	{
+		file.Close();
+		return WriteAll();
+	}
+	if (ranges.empty())
+		return true;
+	return WriteBlocks(file, ranges);
+}
+
+// For a new card, or when the file doesn't match the card anymore. Written to
+// a temporary file first, so that the old file stays intact until the new one
+// is complete.
+bool MemoryCard::WriteAll()
+{
+	std::string dir;
+	SplitPath(m_filename, &dir, nullptr, nullptr);
+	if (!File::IsDirectory(dir))
+		File::CreateFullPath(dir);
+
+	{
+		std::unique_lock<std::mutex> l(m_flush_mutex);
+		memcpy(&m_flush_buffer[0], &m_memcard_data[0], memory_card_size);
+	}
+
+	std::string temp_filename = File::GetTempFilenameForAtomicWrite(m_filename);
+	{
+		File::IOFile temp(temp_filename, "wb");
+		if (!temp.WriteBytes(&m_flush_buffer[0], memory_card_size) || !temp.Sync())
+		{
+			temp.Close();
+			File::Delete(temp_filename);
+			return false;
+		}
+	}
+	if (!File::RenameSync(temp_filename, m_filename))
+		return false;
+
+	std::unique_lock<std::mutex> l(m_flush_mutex);
+	m_flush_stats.flushes++;
+	m_flush_stats.last_bytes = memory_card_size;
+	m_flush_stats.total_bytes += memory_card_size;
+	return true;
+}
+
+bool MemoryCard::WriteBlocks(File::IOFile& file, const std::vector<std::pair<u32, u32>>& ranges)
+{
+	std::string journal_filename = GetJournalFilename(m_filename);
+	if (!WriteJournal(journal_filename, ranges, &m_flush_buffer[0]))
+	{
+		File::Delete(journal_filename);
+		return false;
+	}
+
+	u64 bytes = 0;
+	for (const auto& range : ranges)
+	{
+		file.Seek(range.first, SEEK_SET);
+		file.WriteBytes(&m_flush_buffer[range.first], range.second);
+		bytes += range.second;
+	}
+	// The journal is kept if this fails, to be replayed next time.
+	if (!file.Sync())
+		return false;
+	file.Close();
+	File::Delete(journal_filename);
+
+	INFO_LOG(EXPANSIONINTERFACE, "Wrote %u ranges, %u bytes of memory card %c", (u32)ranges.size(), (u32)bytes,
+	         card_index ? 'B' : 'A');
+
+	std::unique_lock<std::mutex> l(m_flush_mutex);
+	m_flush_stats.flushes++;
+	m_flush_stats.last_bytes = bytes;
+	m_flush_stats.total_bytes += bytes;
+	return true;
+}
+
+MemoryCard::FlushStats MemoryCard::GetFlushStats()
+{
+	std::unique_lock<std::mutex> l(m_flush_mutex);
+	return m_flush_stats;
+}
+
 s32 MemoryCard::Read(u32 srcaddress, s32 length, u8 *destaddress)
 {
 	if (!IsAddressInBounds(srcaddress))
@@ -168,6 +361,7 @@ s32 MemoryCard::Write(u32 destaddress, s32 length, u8 *srcaddress)
 	{
 		std::unique_lock<std::mutex> l(m_flush_mutex);
 		memcpy(&m_memcard_data[destaddress], srcaddress, length);
+		MarkBlocksDirty(destaddress, length);
 	}
 	MakeDirty();
 	return length;
@@ -185,6 +379,7 @@ void MemoryCard::ClearBlock(u32 address)
 	{
 		std::unique_lock<std::mutex> l(m_flush_mutex);
 		memset(&m_memcard_data[address], 0xFF, BLOCK_SIZE);
+		MarkBlocksDirty(address, BLOCK_SIZE);
 	}
 	MakeDirty();
 }
@@ -194,6 +389,7 @@ void MemoryCard::ClearAll()
 	{
 		std::unique_lock<std::mutex> l(m_flush_mutex);
 		memset(&m_memcard_data[0], 0xFF, memory_card_size);
+		MarkBlocksDirty(0, memory_card_size);
 	}
 	MakeDirty();
 }
@@ -203,4 +399,24 @@ void MemoryCard::DoState(PointerWrap &p)
 	p.Do(card_index);
 	p.Do(memory_card_size);
 	p.DoArray(&m_memcard_data[0], memory_card_size);
+
+	// Only the blocks of the loaded card that differ from the file need writing.
+	if (p.GetMode() == PointerWrap::MODE_READ)
+	{
+		bool changed = false;
+		{
+			std::unique_lock<std::mutex> l(m_flush_mutex);
+			for (u32 offset = 0; offset < memory_card_size; offset += BLOCK_SIZE)
+			{
+				u32 length = std::min<u32>(BLOCK_SIZE, memory_card_size - offset);
+				if (memcmp(&m_memcard_data[offset], &m_flush_buffer[offset], length))
+				{
+					MarkBlocksDirty(offset, length);
+					changed = true;
+				}
+			}
+		}
+		if (changed)
+			MakeDirty();
+	}
 }
@@ -8,11 +8,17 @@
 #include <mutex>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 #include "Common/Event.h"
 #include "Common/Flag.h"
 #include "Core/HW/GCMemcard.h"
 
 class PointerWrap;
+namespace File
+{
+class IOFile;
+}
 
 class MemoryCard : public MemoryCardBase
 {
@@ -21,6 +27,18 @@ public:
 	~MemoryCard();
 	void FlushThread();
 	void MakeDirty();
+	// Writes the changed blocks to the file now. Returns false if the file
+	// couldn't be written. Safe to call while the flush thread is running.
+	bool Flush();
+
+	struct FlushStats
+	{
+		u64 flushes;
+		// Bytes written to the card file by the last flush, and overall.
+		u64 last_bytes;
+		u64 total_bytes;
+	};
+	FlushStats GetFlushStats();
 
 	s32 Read(u32 address, s32 length, u8 *destaddress) override;
 	s32 Write(u32 destaddress, s32 length, u8 *srcaddress) override;
@@ -29,11 +47,23 @@ public:
 	void DoState(PointerWrap &p) override;
 
 private:
+	// Must be called with m_flush_mutex held.
+	void MarkBlocksDirty(u32 address, u32 length);
+	// Must be called with m_write_mutex held.
+	bool WriteAll();
+	bool WriteBlocks(File::IOFile& file, const std::vector<std::pair<u32, u32>>& ranges);
+
 	std::string m_filename;
 	std::unique_ptr<u8[]> m_memcard_data;
 	std::unique_ptr<u8[]> m_flush_buffer;
 	std::thread m_flush_thread;
 	std::mutex m_flush_mutex;
+	// Held for a whole flush, so that only one writes the flush buffer, the
+	// journal and the card file at a time. Taken before m_flush_mutex.
+	std::mutex m_write_mutex;
 	Common::Event m_flush_trigger;
 	Common::Flag m_dirty;
+	// One per block, guarded by m_flush_mutex like the data.
+	std::vector<bool> m_dirty_blocks;
+	FlushStats m_flush_stats;
 };
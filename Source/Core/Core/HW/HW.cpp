@@ -9,6 +9,7 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/RunAhead.h"
 #include "Core/State.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/CPU.h"
@@ -49,6 +50,7 @@ namespace HW
 		GPFifo::Init();
 		CPU::Init(SConfig::GetInstance().iCPUCore);
 		SystemTimers::Init();
+		RunAhead::Init();
 
 		if (SConfig::GetInstance().bWii)
 		{
@@ -69,6 +71,7 @@ namespace HW
 			Common::ShutdownWiiRoot();
 		}
 
+		RunAhead::Shutdown();
 		SystemTimers::Shutdown();
 		CPU::Shutdown();
 		DVDInterface::Shutdown();
@@ -2,7 +2,10 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
 #include <functional>
+#include <vector>
 
 #include "Core/HW/MMIO.h"
 #include "Core/HW/MMIOHandlers.h"
@@ -189,6 +192,33 @@ WriteHandlingMethod<T>* ComplexWrite(std::function<void(u32, T)> lambda)
 	return new ComplexHandlingMethod<T>(lambda);
 }
 
+// Pure: a complex read handling method that also hands the plain function it
+// was made from to the visitors which can make use of it.
+template <typename T>
+class PureHandlingMethod : public ReadHandlingMethod<T>
+{
+public:
+	explicit PureHandlingMethod(T (*func)(u32)) : func_(func), lambda_(func)
+	{
+	}
+
+	virtual ~PureHandlingMethod() {}
+
+	void AcceptReadVisitor(ReadHandlingMethodVisitor<T>& v) const override
+	{
+		v.VisitPure(func_, &lambda_);
+	}
+
+private:
+	T (*func_)(u32);
+	std::function<T(u32)> lambda_;
+};
+template <typename T>
+ReadHandlingMethod<T>* PureRead(T (*func)(u32))
+{
+	return new PureHandlingMethod<T>(func);
+}
+
 // Invalid: specialization of the complex handling type with lambdas that
 // display error messages.
 template <typename T>
@@ -220,6 +250,87 @@ template <typename T> struct LargerAccessSize {};
 template <> struct LargerAccessSize<u8> { typedef u16 value; };
 template <> struct LargerAccessSize<u16> { typedef u32 value; };
 
+// Records which handling method a handler currently uses. The converters use
+// this to turn combinations of Constant and Direct handlers into a single
+// Constant or Direct handler, which the JITs can then inline. The combined
+// handler doesn't follow later changes to the handlers it was made from, so
+// these only look at handlers that are already registered.
+enum class MethodKind
+{
+	Nop,
+	Constant,
+	Direct,
+	Complex,
+};
+
+template <typename T>
+struct ReadMethodInfo : public ReadHandlingMethodVisitor<T>
+{
+	MethodKind kind = MethodKind::Complex;
+	T value = 0;
+	const T* addr = nullptr;
+	u32 mask = 0;
+
+	explicit ReadMethodInfo(ReadHandler<T>* handler) { handler->Visit(*this); }
+
+	void VisitConstant(T v) override
+	{
+		kind = MethodKind::Constant;
+		value = v;
+	}
+	void VisitDirect(const T* a, u32 m) override
+	{
+		kind = MethodKind::Direct;
+		addr = a;
+		mask = m;
+	}
+	void VisitComplex(const std::function<T(u32)>* lambda) override
+	{
+		kind = MethodKind::Complex;
+	}
+};
+
+template <typename T>
+struct WriteMethodInfo : public WriteHandlingMethodVisitor<T>
+{
+	MethodKind kind = MethodKind::Complex;
+	T* addr = nullptr;
+	u32 mask = 0;
+
+	explicit WriteMethodInfo(WriteHandler<T>* handler) { handler->Visit(*this); }
+
+	void VisitNop() override
+	{
+		kind = MethodKind::Nop;
+	}
+	void VisitDirect(T* a, u32 m) override
+	{
+		kind = MethodKind::Direct;
+		addr = a;
+		mask = m;
+	}
+	void VisitComplex(const std::function<void(u32, T)>* lambda) override
+	{
+		kind = MethodKind::Complex;
+	}
+};
+
+// The two halves of a register can be accessed as one if the high half
+// directly follows the low half in host memory (which is the case for the
+// MMIO::Utils::LowPart/HighPart pairs on little endian hosts).
+template <typename T, typename ST>
+static bool AreCombinable(const ST* high, const ST* low)
+{
+	return high == low + 1 && reinterpret_cast<uintptr_t>(low) % sizeof(T) == 0;
+}
+
+template <typename ST>
+static u32 CombineMasks(u32 high_mask, u32 low_mask)
+{
+	const u32 all_ones = (1ULL << (8 * sizeof(ST))) - 1;
+	return ((high_mask & all_ones) << (8 * sizeof(ST))) | (low_mask & all_ones);
+}
+
 template <typename T>
 ReadHandlingMethod<T>* ReadToSmaller(Mapping* mmio, u32 high_part_addr, u32 low_part_addr)
 {
@@ -228,7 +339,16 @@ ReadHandlingMethod<T>* ReadToSmaller(Mapping* mmio, u32 high_part_addr, u32 low_
 	ReadHandler<ST>* high_part = &mmio->GetHandlerForRead<ST>(high_part_addr);
 	ReadHandler<ST>* low_part = &mmio->GetHandlerForRead<ST>(low_part_addr);
 
-	// TODO(delroth): optimize
+	ReadMethodInfo<ST> high(high_part);
+	ReadMethodInfo<ST> low(low_part);
+	if (high.kind == MethodKind::Constant && low.kind == MethodKind::Constant)
+		return Constant<T>(((T)high.value << (8 * sizeof (ST))) | low.value);
+	if (high.kind == MethodKind::Direct && low.kind == MethodKind::Direct &&
+	    AreCombinable<T>(high.addr, low.addr))
+	{
+		return DirectRead<T>(reinterpret_cast<const T*>(low.addr), CombineMasks<ST>(high.mask, low.mask));
+	}
+
 	return ComplexRead<T>([=](u32 addr) {
 		return ((T)high_part->Read(high_part_addr) << (8 * sizeof (ST)))
 			| low_part->Read(low_part_addr);
@@ -243,7 +363,16 @@ WriteHandlingMethod<T>* WriteToSmaller(Mapping* mmio, u32 high_part_addr, u32 lo
 	WriteHandler<ST>* high_part = &mmio->GetHandlerForWrite<ST>(high_part_addr);
 	WriteHandler<ST>* low_part = &mmio->GetHandlerForWrite<ST>(low_part_addr);
 
-	// TODO(delroth): optimize
+	WriteMethodInfo<ST> high(high_part);
+	WriteMethodInfo<ST> low(low_part);
+	if (high.kind == MethodKind::Nop && low.kind == MethodKind::Nop)
+		return Nop<T>();
+	if (high.kind == MethodKind::Direct && low.kind == MethodKind::Direct &&
+	    AreCombinable<T>(high.addr, low.addr))
+	{
+		return DirectWrite<T>(reinterpret_cast<T*>(low.addr), CombineMasks<ST>(high.mask, low.mask));
+	}
+
 	return ComplexWrite<T>([=](u32 addr, T val) {
 		high_part->Write(high_part_addr, val >> (8 * sizeof (ST)));
 		low_part->Write(low_part_addr, (ST)val);
@@ -257,7 +386,16 @@ ReadHandlingMethod<T>* ReadToLarger(Mapping* mmio, u32 larger_addr, u32 shift)
 
 	ReadHandler<LT>* large = &mmio->GetHandlerForRead<LT>(larger_addr);
 
-	// TODO(delroth): optimize
+	ReadMethodInfo<LT> info(large);
+	if (info.kind == MethodKind::Constant)
+		return Constant<T>((T)(info.value >> shift));
+	if (info.kind == MethodKind::Direct && shift % (8 * sizeof (T)) == 0)
+	{
+		// Little endian hosts keep the low part first.
+		const T* part = reinterpret_cast<const T*>(info.addr) + shift / (8 * sizeof (T));
+		return DirectRead<T>(part, (info.mask >> shift) & (T)~0);
+	}
+
 	return ComplexRead<T>([large, shift](u32 addr) {
 		return large->Read(addr & ~(sizeof (LT) - 1)) >> shift;
 	});
@@ -378,6 +516,57 @@ void WriteHandler<T>::ResetMethod(WriteHandlingMethod<T>* method)
 	m_WriteFunc = v.ret;
 }
 
+void Mapping::SetProfilingEnabled(bool enabled)
+{
+	m_profiling = enabled;
+	if (enabled)
+	{
+		m_read_counts.assign(NUM_MMIOS, 0);
+		m_write_counts.assign(NUM_MMIOS, 0);
+	}
+	else
+	{
+		m_read_counts.clear();
+		m_write_counts.clear();
+	}
+}
+
+std::vector<Mapping::ProfileEntry> Mapping::GetProfileResults() const
+{
+	std::vector<ProfileEntry> results;
+	if (!m_profiling)
+		return results;
+
+	for (u32 id = 0; id < NUM_MMIOS; ++id)
+	{
+		if (!m_read_counts[id] && !m_write_counts[id])
+			continue;
+
+		// Inverse of UniqueID, using the first mirror of the Wii block.
+		u32 address = ((id >> 16) ? 0x0D000000 : 0x0C000000) | (id & 0xFFFF);
+		results.push_back({ address, m_read_counts[id], m_write_counts[id] });
+	}
+
+	std::stable_sort(results.begin(), results.end(), [](const ProfileEntry& a, const ProfileEntry& b) {
+		return a.reads + a.writes > b.reads + b.writes;
+	});
+	return results;
+}
+
+void Mapping::LogProfileResults(size_t max_entries) const
+{
+	std::vector<ProfileEntry> results = GetProfileResults();
+	if (results.size() > max_entries)
+		results.resize(max_entries);
+
+	NOTICE_LOG(MEMMAP, "Most accessed MMIO registers:");
+	for (const ProfileEntry& entry : results)
+	{
+		NOTICE_LOG(MEMMAP, "%08x: %" PRIu64 " reads, %" PRIu64 " writes",
+		           entry.address, entry.reads, entry.writes);
+	}
+}
+
 // Define all the public specializations that are exported in MMIOHandlers.h.
 #define MaybeExtern
 MMIO_PUBLIC_SPECIALIZATIONS()
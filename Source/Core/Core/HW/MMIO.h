@@ -7,6 +7,7 @@
 #include <array>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "Common/Assert.h"
 #include "Common/CommonTypes.h"
@@ -115,15 +116,39 @@ public:
 	template<typename Unit>
 	Unit Read(u32 addr)
 	{
+		if (m_profiling)
+			m_read_counts[UniqueID(addr)]++;
 		return GetHandlerForRead<Unit>(addr).Read(addr);
 	}
 
 	template<typename Unit>
 	void Write(u32 addr, Unit val)
 	{
+		if (m_profiling)
+			m_write_counts[UniqueID(addr)]++;
 		GetHandlerForWrite<Unit>(addr).Write(addr, val);
 	}
 
+	// Access profiling.
+	//
+	// While enabled, accesses through Read and Write are counted per address.
+	// The JITs don't inline MMIO accesses during that time, so that all
+	// accesses from guest code are counted. Use this to find the registers
+	// that are worth giving a handling method the JITs can inline.
+	struct ProfileEntry
+	{
+		u32 address;
+		u64 reads;
+		u64 writes;
+	};
+
+	void SetProfilingEnabled(bool enabled);
+	bool IsProfilingEnabled() const { return m_profiling; }
+
+	// Returns the addresses that were accessed, most accessed first.
+	std::vector<ProfileEntry> GetProfileResults() const;
+	void LogProfileResults(size_t max_entries) const;
+
 	// Handlers access interface.
 	//
 	// Use when you care more about how to access the MMIO register for an
@@ -165,6 +190,11 @@ private:
 	HandlerArray<u16>::Write m_write_handlers16;
 	HandlerArray<u32>::Write m_write_handlers32;
 
+	// Indexed by UniqueID, only allocated while profiling.
+	bool m_profiling = false;
+	std::vector<u64> m_read_counts;
+	std::vector<u64> m_write_counts;
+
 	// Getter functions for the handler arrays.
 	//
 	// TODO:
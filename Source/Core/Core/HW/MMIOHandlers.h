@@ -52,6 +52,12 @@ template <typename T> WriteHandlingMethod<T>* DirectWrite(volatile T* addr, u32
 template <typename T> ReadHandlingMethod<T>* ComplexRead(std::function<T(u32)>);
 template <typename T> WriteHandlingMethod<T>* ComplexWrite(std::function<void(u32, T)>);
 
+// Pure: a Complex read for a function that has no side effects, like reading
+// a timer or a mailbox. The function must not write any emulator state, not
+// even a cached copy of the register. JITs call the function directly instead
+// of going through a std::function. This is only for reads.
+template <typename T> ReadHandlingMethod<T>* PureRead(T (*func)(u32));
+
 // Invalid: log an error and return -1 in case of a read. These are the default
 // handlers set for all MMIO types.
 template <typename T> ReadHandlingMethod<T>* InvalidRead();
@@ -90,6 +96,12 @@ public:
 	virtual void VisitConstant(T value) = 0;
 	virtual void VisitDirect(const T* addr, u32 mask) = 0;
 	virtual void VisitComplex(const std::function<T(u32)>* lambda) = 0;
+
+	// Pure handlers are Complex ones to visitors that don't tell them apart.
+	virtual void VisitPure(T (*func)(u32), const std::function<T(u32)>* lambda)
+	{
+		VisitComplex(lambda);
+	}
 };
 template <typename T>
 class WriteHandlingMethodVisitor
@@ -204,6 +216,7 @@ private:
 	MaybeExtern template WriteHandlingMethod<T>* DirectWrite(volatile T* addr, u32 mask); \
 	MaybeExtern template ReadHandlingMethod<T>* ComplexRead<T>(std::function<T(u32)>); \
 	MaybeExtern template WriteHandlingMethod<T>* ComplexWrite<T>(std::function<void(u32, T)>); \
+	MaybeExtern template ReadHandlingMethod<T>* PureRead<T>(T (*func)(u32)); \
 	MaybeExtern template ReadHandlingMethod<T>* InvalidRead<T>(); \
 	MaybeExtern template WriteHandlingMethod<T>* InvalidWrite<T>(); \
 	MaybeExtern template class ReadHandler<T>; \
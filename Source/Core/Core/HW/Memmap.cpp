@@ -9,10 +9,13 @@
 // may be redirected here (for example to Read_U32()).
 
 #include <cstring>
+#include <vector>
 
+#include "Common/BitSet.h"
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
 #include "Common/MemArena.h"
+#include "Common/MathUtil.h"
 #include "Common/MemoryUtil.h"
 
 #include "Core/ConfigManager.h"
@@ -58,6 +61,13 @@ static MemArena g_arena;
 static bool m_IsInitialized = false; // Save the Init(), Shutdown() state
 // END STATE_TO_SAVE
 
+static bool s_page_table_mapping = false;
+// One bit per host page of the logical arena, set while the page is mapped.
+// Pages get mapped from the fault handler, so this is allocated up front.
+static std::vector<u64> s_logical_pages;
+static u32 s_logical_page_shift;
+static u32 s_num_logical_pages;
+
 u8* m_pRAM;
 u8* m_pL1Cache;
 u8* m_pEXRAM;
@@ -186,6 +196,17 @@ void Init()
 	logical_base = physical_base + 0x200000000;
 #endif
 
+	// Views can only be created at 4KB granularity on POSIX systems, Windows
+	// maps them in 64KB units.
+#if !defined(_ARCH_32) && !defined(_WIN32)
+	s_page_table_mapping = bMMU && SConfig::GetInstance().bFastmem && SConfig::GetInstance().bFastmemPageTable;
+#else
+	s_page_table_mapping = false;
+#endif
+	s_logical_page_shift = IntLog2(GetPageSize());
+	s_logical_pages.assign(s_page_table_mapping ? (0x100000000ULL >> s_logical_page_shift) / 64 : 0, 0);
+	s_num_logical_pages = 0;
+
 	mmio_mapping = new MMIO::Mapping();
 
 	if (wii)
@@ -193,6 +214,9 @@ void Init()
 	else
 		InitMMIO(mmio_mapping);
 
+	if (SConfig::GetInstance().bMMIOProfiling)
+		mmio_mapping->SetProfilingEnabled(true);
+
 	INFO_LOG(MEMMAP, "Memory system initialized. RAM at %p", m_pRAM);
 	m_IsInitialized = true;
 }
@@ -214,6 +238,8 @@ void DoState(PointerWrap &p)
 void Shutdown()
 {
 	m_IsInitialized = false;
+	UnmapAllLogicalPages();
+	s_page_table_mapping = false;
 	u32 flags = 0;
 	if (SConfig::GetInstance().bWii) flags |= MV_WII_ONLY;
 	if (bFakeVMEM) flags |= MV_FAKE_VMEM;
@@ -221,6 +247,8 @@ void Shutdown()
 	g_arena.ReleaseSHMSegment();
 	physical_base = nullptr;
 	logical_base = nullptr;
+	if (mmio_mapping->IsProfilingEnabled())
+		mmio_mapping->LogProfileResults(32);
 	delete mmio_mapping;
 	INFO_LOG(MEMMAP, "Memory system shut down.");
 }
@@ -235,6 +263,71 @@ void Clear()
 		memset(m_pEXRAM, 0, EXRAM_SIZE);
 }
 
+bool IsPageTableMappingEnabled()
+{
+	return s_page_table_mapping;
+}
+
+bool MapLogicalPage(u32 logical_address, u32 physical_address, bool writable)
+{
+	const u32 page_size = 1 << s_logical_page_shift;
+	if (!s_page_table_mapping || physical_address >= REALRAM_SIZE)
+		return false;
+
+	u32 page = logical_address >> s_logical_page_shift;
+	u64 bit = 1ULL << (page % 64);
+	u8* base = logical_base + (page << s_logical_page_shift);
+	// RAM is the first view, so it starts the shared memory segment. This
+	// replaces any previous mapping of the page.
+	if (g_arena.CreateView(views[0].shm_position + (physical_address & ~(page_size - 1)), page_size, base) != base)
+	{
+		if (s_logical_pages[page / 64] & bit)
+		{
+			s_logical_pages[page / 64] &= ~bit;
+			s_num_logical_pages--;
+		}
+		return false;
+	}
+	if (!writable)
+		WriteProtectMemory(base, page_size);
+
+	if (!(s_logical_pages[page / 64] & bit))
+	{
+		s_logical_pages[page / 64] |= bit;
+		s_num_logical_pages++;
+	}
+	return true;
+}
+
+void UnmapLogicalPage(u32 logical_address)
+{
+	if (!s_num_logical_pages)
+		return;
+
+	u32 page = logical_address >> s_logical_page_shift;
+	u64 bit = 1ULL << (page % 64);
+	if (!(s_logical_pages[page / 64] & bit))
+		return;
+
+	g_arena.ReleaseView(logical_base + (page << s_logical_page_shift), 1 << s_logical_page_shift);
+	s_logical_pages[page / 64] &= ~bit;
+	s_num_logical_pages--;
+}
+
+void UnmapAllLogicalPages()
+{
+	for (size_t i = 0; i < s_logical_pages.size() && s_num_logical_pages; i++)
+	{
+		for (u64 bits = s_logical_pages[i]; bits; bits &= bits - 1)
+		{
+			u32 page = (u32)(i * 64 + LeastSignificantSetBit(bits));
+			g_arena.ReleaseView(logical_base + (page << s_logical_page_shift), 1 << s_logical_page_shift);
+			s_num_logical_pages--;
+		}
+		s_logical_pages[i] = 0;
+	}
+}
+
 bool AreMemoryBreakpointsActivated()
 {
 #ifdef ENABLE_MEM_CHECK
@@ -74,6 +74,18 @@ void DoState(PointerWrap &p);
 void Clear();
 bool AreMemoryBreakpointsActivated();
 
+// Page table mappings in the logical fastmem arena (MMU mode with
+// FastmemPageTable). The MMU maps a page of RAM at the effective address it
+// translates from when a JIT fastmem access faults on it, and unmaps pages
+// whenever the translation may have changed. Read-only pages fault on the
+// first write, so that the MMU gets to set the C bit. MapLogicalPage runs in
+// the fault handler, so it doesn't allocate: it only makes the mmap/mprotect
+// system calls and sets a bit in a table sized by Init.
+bool IsPageTableMappingEnabled();
+bool MapLogicalPage(u32 logical_address, u32 physical_address, bool writable);
+void UnmapLogicalPage(u32 logical_address);
+void UnmapAllLogicalPages();
+
 // Routines to access physically addressed memory, designed for use by
 // emulated hardware outside the CPU. Use "Device_" prefix.
 std::string GetString(u32 em_address, size_t size = 0);
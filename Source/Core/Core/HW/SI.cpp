@@ -4,15 +4,19 @@
 
 #include <algorithm>
 #include <array>
+#include <cinttypes>
 #include <memory>
 
 #include "Common/ChunkFile.h"
 #include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Common/Timer.h"
 
 #include "Core/ConfigManager.h"
 #include "Core/CoreTiming.h"
 #include "Core/Movie.h"
 #include "Core/NetPlayProto.h"
+#include "Core/HW/FramePacer.h"
 #include "Core/HW/MMIO.h"
 #include "Core/HW/ProcessorInterface.h"
 #include "Core/HW/SI.h"
@@ -27,6 +31,14 @@ namespace SerialInterface
 static int changeDevice;
 static int et_transfer_pending;
 
+// Host time of the last poll, and the channels whose data the guest hasn't
+// read since. Only for the latency statistics, so not in the savestate.
+static u64 s_poll_time_us;
+static std::array<bool, MAX_SI_CHANNELS> s_latency_pending;
+static u64 s_latency_count;
+static u64 s_latency_sum;
+static u64 s_latency_max;
+
 void RunSIBuffer(u64 userdata, int cyclesLate);
 void UpdateInterrupts();
 
@@ -279,15 +291,49 @@ void Init()
 
 	changeDevice = CoreTiming::RegisterEvent("ChangeSIDevice", ChangeDeviceCallback);
 	et_transfer_pending = CoreTiming::RegisterEvent("SITransferPending", RunSIBuffer);
+
+	s_latency_pending.fill(false);
+	s_latency_count = 0;
+	s_latency_sum = 0;
+	s_latency_max = 0;
 }
 
 void Shutdown()
 {
+	InputLatencyStats stats = GetInputLatencyStats();
+	if (stats.count)
+	{
+		NOTICE_LOG(SERIALINTERFACE, "Input latency: mean %" PRIu64 " us, max %" PRIu64 " us over %" PRIu64 " reads",
+		           stats.mean_us, stats.max_us, stats.count);
+	}
+
 	for (int i = 0; i < MAX_SI_CHANNELS; i++)
 		RemoveDevice(i);
 	GBAConnectionWaiter_Shutdown();
 }
 
+static void RecordInputLatency(int channel)
+{
+	if (!s_latency_pending[channel])
+		return;
+	s_latency_pending[channel] = false;
+
+	u64 latency = Common::Timer::GetTimeUs() - s_poll_time_us;
+	s_latency_count++;
+	s_latency_sum += latency;
+	s_latency_max = std::max(s_latency_max, latency);
+}
+
+InputLatencyStats GetInputLatencyStats()
+{
+	InputLatencyStats stats = {};
+	stats.count = s_latency_count;
+	if (s_latency_count)
+		stats.mean_us = s_latency_sum / s_latency_count;
+	stats.max_us = s_latency_max;
+	return stats;
+}
+
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 {
 	// Register SI buffer direct accesses.
@@ -315,6 +361,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			MMIO::ComplexRead<u32>([i, rdst_bit](u32) {
 				g_StatusReg.Hex &= ~(1 << rdst_bit);
 				UpdateInterrupts();
+				RecordInputLatency(i);
 				return g_Channel[i].m_InHi.Hex;
 			}),
 			MMIO::DirectWrite<u32>(&g_Channel[i].m_InHi.Hex)
@@ -323,6 +370,7 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 			MMIO::ComplexRead<u32>([i, rdst_bit](u32) {
 				g_StatusReg.Hex &= ~(1 << rdst_bit);
 				UpdateInterrupts();
+				RecordInputLatency(i);
 				return g_Channel[i].m_InLo.Hex;
 			}),
 			MMIO::DirectWrite<u32>(&g_Channel[i].m_InLo.Hex)
@@ -513,11 +561,20 @@ void ChangeDevice(SIDevices device, int channel)
 
 void UpdateDevices()
 {
+	// The CPU thread usually gets here well before the host time this poll is
+	// due, so the pads would be sampled early. Wait for it instead. The input
+	// still goes through the devices' movie and netplay hooks as usual, and
+	// waiting doesn't change the emulated timing.
+	if (SConfig::GetInstance().bJustInTimeInput)
+		FramePacer::WaitForEmulatedTime();
+	s_poll_time_us = Common::Timer::GetTimeUs();
+
 	// Update channels and set the status bit if there's new data
 	g_StatusReg.RDST0 = !!g_Channel[0].m_device->GetData(g_Channel[0].m_InHi.Hex, g_Channel[0].m_InLo.Hex);
 	g_StatusReg.RDST1 = !!g_Channel[1].m_device->GetData(g_Channel[1].m_InHi.Hex, g_Channel[1].m_InLo.Hex);
 	g_StatusReg.RDST2 = !!g_Channel[2].m_device->GetData(g_Channel[2].m_InHi.Hex, g_Channel[2].m_InLo.Hex);
 	g_StatusReg.RDST3 = !!g_Channel[3].m_device->GetData(g_Channel[3].m_InHi.Hex, g_Channel[3].m_InLo.Hex);
+	s_latency_pending = {{!!g_StatusReg.RDST0, !!g_StatusReg.RDST1, !!g_StatusReg.RDST2, !!g_StatusReg.RDST3}};
 
 	UpdateInterrupts();
 }
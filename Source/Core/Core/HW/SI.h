@@ -40,4 +40,14 @@ SIDevices GetDeviceType(int channel);
 
 int GetTicksToNextSIPoll();
 
+struct InputLatencyStats
+{
+	u64 count;
+	u64 mean_us;
+	u64 max_us;
+};
+
+// Host time from sampling the pads at a poll to the guest reading the data.
+InputLatencyStats GetInputLatencyStats();
+
 } // end of namespace SerialInterface
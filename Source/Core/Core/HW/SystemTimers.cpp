@@ -52,9 +52,11 @@ IPC_HLE_PERIOD: For the Wiimote this is the call schedule:
 #include "Core/CoreTiming.h"
 #include "Core/DSPEmulator.h"
 #include "Core/PatchEngine.h"
+#include "Core/RunAhead.h"
 #include "Core/HW/AudioInterface.h"
 #include "Core/HW/DSP.h"
 #include "Core/HW/EXI_DeviceIPL.h"
+#include "Core/HW/FramePacer.h"
 #include "Core/HW/SI.h"
 #include "Core/HW/SystemTimers.h"
 #include "Core/HW/VideoInterface.h"
@@ -195,7 +197,10 @@ static void ThrottleCallback(u64 last_time, int cyclesLate)
 
 	int diff = (u32)last_time - time;
 	const SConfig& config = SConfig::GetInstance();
-	bool frame_limiter = config.m_Framelimit && !Core::GetIsFramelimiterTempDisabled();
+	// The frame pacer limits the speed at the VI fields instead, and the fields
+	// run ahead are rolled back anyway.
+	bool frame_limiter = config.m_Framelimit && !Core::GetIsFramelimiterTempDisabled() && !FramePacer::IsEnabled() &&
+	                     !RunAhead::IsRunningAhead();
 	u32 next_event = GetTicksPerSecond()/1000;
 	if (config.m_Framelimit > 1)
 	{
@@ -239,6 +244,7 @@ void Init()
 	s_audio_dma_period = s_cpu_core_clock / (AudioInterface::GetAIDSampleRate() * 4 / 32);
 
 	Common::Timer::IncreaseResolution();
+	FramePacer::Init();
 	// store and convert localtime at boot to timebase ticks
 	CoreTiming::SetFakeTBStartValue((u64)(s_cpu_core_clock / TIMER_RATIO) * (u64)CEXIIPL::GetGCTime());
 	CoreTiming::SetFakeTBStartTicks(CoreTiming::GetTicks());
@@ -274,6 +280,7 @@ void Init()
 
 void Shutdown()
 {
+	FramePacer::Shutdown();
 	Common::Timer::RestoreResolution();
 }
 
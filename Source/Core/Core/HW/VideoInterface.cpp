@@ -12,7 +12,9 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/RunAhead.h"
 #include "Core/State.h"
+#include "Core/HW/FramePacer.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/MMIO.h"
 #include "Core/HW/ProcessorInterface.h"
@@ -63,6 +65,7 @@ static u32 s_clock_freqs[2] =
 
 static u64 s_ticks_last_line_start;  // number of ticks when the current full scanline started
 static u32 s_half_line_count;  // number of halflines that have occurred for this full frame
+static u16 s_vertical_beam_position;  // follows s_half_line_count, so the JITs can read it directly
 
 
 static FieldType s_current_field;
@@ -73,6 +76,11 @@ static u32 s_odd_field_first_hl;  // index first halfline of the odd field
 static u32 s_even_field_last_hl;  // index last halfline of the even field
 static u32 s_odd_field_last_hl;   // index last halfline of the odd field
 
+static void UpdateVerticalBeamPosition()
+{
+	s_vertical_beam_position = static_cast<u16>(1 + (s_half_line_count - 1) / 2);
+}
+
 void DoState(PointerWrap &p)
 {
 	p.DoPOD(m_VerticalTimingRegister);
@@ -100,6 +108,7 @@ void DoState(PointerWrap &p)
 	p.Do(TargetRefreshRate);
 	p.Do(s_ticks_last_line_start);
 	p.Do(s_half_line_count);
+	UpdateVerticalBeamPosition();
 	p.Do(s_current_field);
 	p.Do(s_even_field_first_hl);
 	p.Do(s_odd_field_first_hl);
@@ -157,6 +166,7 @@ void Preset(bool _bNTSC)
 
 	s_ticks_last_line_start = 0;
 	s_half_line_count = 1;
+	UpdateVerticalBeamPosition();
 	s_current_field = FIELD_ODD;
 
 	UpdateParameters();
@@ -167,6 +177,12 @@ void Init()
 	Preset(true);
 }
 
+static u16 ReadHorizontalBeamPosition(u32)
+{
+	u16 value = static_cast<u16>(1 +  m_HTiming0.HLW * (CoreTiming::GetTicks() - s_ticks_last_line_start) / (GetTicksPerHalfLine()));
+	return MathUtil::Clamp(value, static_cast<u16>(1), static_cast<u16>(m_HTiming0.HLW * 2));
+}
+
 void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 {
 	struct {
@@ -288,18 +304,13 @@ void RegisterMMIO(MMIO::Mapping* mmio, u32 base)
 
 	// MMIOs with unimplemented writes that trigger warnings.
 	mmio->Register(base | VI_VERTICAL_BEAM_POSITION,
-		MMIO::ComplexRead<u16>([](u32) {
-			return 1 + (s_half_line_count-1) / 2;
-		}),
+		MMIO::DirectRead<u16>(&s_vertical_beam_position),
 		MMIO::ComplexWrite<u16>([](u32, u16 val) {
 			WARN_LOG(VIDEOINTERFACE, "Changing vertical beam position to 0x%04x - not documented or implemented yet", val);
 		})
 	);
 	mmio->Register(base | VI_HORIZONTAL_BEAM_POSITION,
-		MMIO::ComplexRead<u16>([](u32) {
-			u16 value = static_cast<u16>(1 +  m_HTiming0.HLW * (CoreTiming::GetTicks() - s_ticks_last_line_start) / (GetTicksPerHalfLine()));
-			return MathUtil::Clamp(value, static_cast<u16>(1), static_cast<u16>(m_HTiming0.HLW * 2));
-		}),
+		MMIO::PureRead<u16>(ReadHorizontalBeamPosition),
 		MMIO::ComplexWrite<u16>([](u32, u16 val) {
 			WARN_LOG(VIDEOINTERFACE, "Changing horizontal beam position to 0x%04x - not documented or implemented yet", val);
 		})
@@ -652,8 +663,14 @@ static void BeginField(FieldType field)
 
 static void EndField()
 {
+	// Before the field goes to the video backend, so that it's presented at
+	// the paced time.
+	FramePacer::PaceField();
 	g_video_backend->Video_EndField();
-	Core::VideoThrottle();
+	if (RunAhead::IsPresentingField())
+		Core::VideoThrottle();
+	// Last, as it may load a state.
+	RunAhead::EndField();
 }
 
 // Purpose: Send VI interrupt when triggered
@@ -690,6 +707,7 @@ void Update()
 	if (s_half_line_count > GetHalfLinesPerEvenField() + GetHalfLinesPerOddField()) {
 		s_half_line_count = 1;
 	}
+	UpdateVerticalBeamPosition();
 
 	if (s_half_line_count & 1) {
 		s_ticks_last_line_start = CoreTiming::GetTicks();
@@ -40,61 +40,301 @@ void CachedInterpreter::SingleStep()
 	int block = GetBlockNumberFromStartAddress(PC);
 	if (block >= 0)
 	{
-		Instruction* code = (Instruction*)GetCompiledCodeFromBlock(block);
-
-		while (true)
-		{
-			switch (code->type)
-			{
-			case Instruction::INSTRUCTION_ABORT:
-				return;
-
-			case Instruction::INSTRUCTION_TYPE_COMMON:
-				code->common_callback(UGeckoInstruction(code->data));
-				code++;
-				break;
-
-			case Instruction::INSTRUCTION_TYPE_CONDITIONAL:
-				bool ret = code->conditional_callback(code->data);
-				code++;
-				if (ret)
-					return;
-				break;
-			}
-		}
+		const Instruction* code = (const Instruction*)GetCompiledCodeFromBlock(block);
+		while (!code->handler(*code))
+			code++;
+		return;
 	}
 
 	Jit(PC);
 }
 
-static void EndBlock(UGeckoInstruction data)
+struct CachedInterpreter::Handlers
 {
-	PC = NPC;
-	PowerPC::CheckExceptions();
-	PowerPC::ppcState.downcount -= data.hex;
-	if (PowerPC::ppcState.downcount <= 0)
+	static bool Abort(const Instruction& inst)
+	{
+		return true;
+	}
+
+	static bool Common(const Instruction& inst)
+	{
+		inst.common_callback(UGeckoInstruction(inst.data));
+		return false;
+	}
+
+	static bool EndBlock(const Instruction& inst)
+	{
+		PC = NPC;
+		PowerPC::CheckExceptions();
+		PowerPC::ppcState.downcount -= inst.data;
+		if (PowerPC::ppcState.downcount <= 0)
+		{
+			CoreTiming::Advance();
+		}
+		return false;
+	}
+
+	static bool WritePC(const Instruction& inst)
+	{
+		PC = inst.data;
+		NPC = inst.data + 4;
+		return false;
+	}
+
+	static bool CheckFPU(const Instruction& inst)
+	{
+		UReg_MSR& msr = (UReg_MSR&)MSR;
+		if (!msr.FP)
+		{
+			PC = NPC = inst.data;
+			PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
+			PowerPC::CheckExceptions();
+			return true;
+		}
+		return false;
+	}
+
+	// li, lis
+	static bool LoadImm(const Instruction& inst)
+	{
+		rGPR[inst.d] = inst.data;
+		return false;
+	}
+
+	// addi, addis
+	static bool AddImm(const Instruction& inst)
+	{
+		rGPR[inst.d] = rGPR[inst.a] + inst.data;
+		return false;
+	}
+
+	// ori, oris
+	static bool OrImm(const Instruction& inst)
+	{
+		rGPR[inst.a] = rGPR[inst.d] | inst.data;
+		return false;
+	}
+
+	static bool Rlwinm(const Instruction& inst)
+	{
+		rGPR[inst.a] = _rotl(rGPR[inst.d], inst.sh) & inst.mask;
+		return false;
+	}
+
+	static bool Add(const Instruction& inst)
+	{
+		rGPR[inst.d] = rGPR[inst.a] + rGPR[inst.b];
+		return false;
+	}
+
+	static bool Subf(const Instruction& inst)
+	{
+		rGPR[inst.d] = rGPR[inst.b] - rGPR[inst.a];
+		return false;
+	}
+
+	static bool Or(const Instruction& inst)
 	{
-		CoreTiming::Advance();
+		rGPR[inst.a] = rGPR[inst.d] | rGPR[inst.b];
+		return false;
 	}
+
+	static bool And(const Instruction& inst)
+	{
+		rGPR[inst.a] = rGPR[inst.d] & rGPR[inst.b];
+		return false;
+	}
+
+	template <typename T>
+	static void Compare(int crf, T a, T b)
+	{
+		int f;
+		if (a < b)
+			f = 0x8;
+		else if (a > b)
+			f = 0x4;
+		else
+			f = 0x2;
+
+		if (GetXER_SO())
+			f |= 0x1;
+
+		SetCRField(crf, f);
+	}
+
+	static bool Cmpi(const Instruction& inst)
+	{
+		// Same as Interpreter::cmpi, which sets the field from the difference.
+		u64 cr_val = (u64)(s64)(s32)(rGPR[inst.a] - inst.data);
+		cr_val = (cr_val & ~(1ull << 61)) | ((u64)GetXER_SO() << 61);
+		PowerPC::ppcState.cr_val[inst.d] = cr_val;
+		return false;
+	}
+
+	static bool Cmpli(const Instruction& inst)
+	{
+		Compare<u32>(inst.d, rGPR[inst.a], inst.data);
+		return false;
+	}
+
+	static bool Cmp(const Instruction& inst)
+	{
+		Compare<s32>(inst.d, rGPR[inst.a], rGPR[inst.b]);
+		return false;
+	}
+
+	static bool Cmpl(const Instruction& inst)
+	{
+		Compare<u32>(inst.d, rGPR[inst.a], rGPR[inst.b]);
+		return false;
+	}
+
+	static u32 ReadU32(u32 address) { return PowerPC::Read_U32(address); }
+	static u32 ReadU16(u32 address) { return PowerPC::Read_U16(address); }
+	static u32 ReadU8(u32 address) { return PowerPC::Read_U8(address); }
+	static void WriteU32(u32 value, u32 address) { PowerPC::Write_U32(value, address); }
+	static void WriteU16(u32 value, u32 address) { PowerPC::Write_U16((u16)value, address); }
+	static void WriteU8(u32 value, u32 address) { PowerPC::Write_U8((u8)value, address); }
+
+	// lwz, lhz, lbz with a base register
+	template <u32 (*read)(u32)>
+	static bool Load(const Instruction& inst)
+	{
+		u32 temp = read(rGPR[inst.a] + inst.data);
+		if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
+			rGPR[inst.d] = temp;
+		return false;
+	}
+
+	// stw, sth, stb with a base register
+	template <void (*write)(u32, u32)>
+	static bool Store(const Instruction& inst)
+	{
+		write(rGPR[inst.d], rGPR[inst.a] + inst.data);
+		return false;
+	}
+};
+
+CachedInterpreter::Instruction::Instruction()
+	: handler(Handlers::Abort), common_callback(nullptr), data(0), d(0), a(0), b(0), sh(0)
+{
 }
 
-static void WritePC(UGeckoInstruction data)
+CachedInterpreter::Instruction::Instruction(Handler h, u32 imm)
+	: handler(h), common_callback(nullptr), data(imm), d(0), a(0), b(0), sh(0)
 {
-	PC = data.hex;
-	NPC = data.hex + 4;
 }
 
-static bool CheckFPU(u32 data)
+CachedInterpreter::Instruction::Instruction(CommonCallback c, UGeckoInstruction i)
+	: handler(Handlers::Common), common_callback(c), data(i.hex), d(0), a(0), b(0), sh(0)
 {
-	UReg_MSR& msr = (UReg_MSR&)MSR;
-	if (!msr.FP)
+}
+
+CachedInterpreter::Instruction CachedInterpreter::Decode(UGeckoInstruction inst)
+{
+	Instruction::Handler handler = nullptr;
+	u32 data = 0;
+	bool uses_crf = false;
+
+	switch (inst.OPCD)
 	{
-		PC = NPC = data;
-		PowerPC::ppcState.Exceptions |= EXCEPTION_FPU_UNAVAILABLE;
-		PowerPC::CheckExceptions();
-		return true;
+	case 14: // addi
+		data = (u32)inst.SIMM_16;
+		handler = inst.RA ? Handlers::AddImm : Handlers::LoadImm;
+		break;
+	case 15: // addis
+		data = (u32)inst.SIMM_16 << 16;
+		handler = inst.RA ? Handlers::AddImm : Handlers::LoadImm;
+		break;
+	case 24: // ori
+		data = inst.UIMM;
+		handler = Handlers::OrImm;
+		break;
+	case 25: // oris
+		data = inst.UIMM << 16;
+		handler = Handlers::OrImm;
+		break;
+	case 21: // rlwinmx
+		if (!inst.Rc)
+			handler = Handlers::Rlwinm;
+		break;
+	case 11: // cmpi
+		data = (u32)inst.SIMM_16;
+		handler = Handlers::Cmpi;
+		uses_crf = true;
+		break;
+	case 10: // cmpli
+		data = inst.UIMM;
+		handler = Handlers::Cmpli;
+		uses_crf = true;
+		break;
+	case 32: // lwz
+	case 40: // lhz
+	case 34: // lbz
+	case 36: // stw
+	case 44: // sth
+	case 38: // stb
+		// rA = 0 means an absolute address, which is rare enough to leave to
+		// the interpreter.
+		if (!inst.RA)
+			break;
+		data = (u32)inst.SIMM_16;
+		switch (inst.OPCD)
+		{
+		case 32: handler = Handlers::Load<Handlers::ReadU32>; break;
+		case 40: handler = Handlers::Load<Handlers::ReadU16>; break;
+		case 34: handler = Handlers::Load<Handlers::ReadU8>; break;
+		case 36: handler = Handlers::Store<Handlers::WriteU32>; break;
+		case 44: handler = Handlers::Store<Handlers::WriteU16>; break;
+		case 38: handler = Handlers::Store<Handlers::WriteU8>; break;
+		}
+		break;
+	case 31:
+		// SUBOP10 includes OE, so the arithmetic cases only match the forms
+		// without it.
+		switch (inst.SUBOP10)
+		{
+		case 266: // addx
+			if (!inst.Rc)
+				handler = Handlers::Add;
+			break;
+		case 40: // subfx
+			if (!inst.Rc)
+				handler = Handlers::Subf;
+			break;
+		case 444: // orx
+			if (!inst.Rc)
+				handler = Handlers::Or;
+			break;
+		case 28: // andx
+			if (!inst.Rc)
+				handler = Handlers::And;
+			break;
+		case 0: // cmp
+			handler = Handlers::Cmp;
+			uses_crf = true;
+			break;
+		case 32: // cmpl
+			handler = Handlers::Cmpl;
+			uses_crf = true;
+			break;
+		}
+		break;
 	}
-	return false;
+
+	if (!handler)
+		return Instruction(GetInterpreterOp(inst), inst);
+
+	Instruction decoded(handler, data);
+	decoded.d = uses_crf ? inst.CRFD : inst.RD;
+	decoded.a = inst.RA;
+	decoded.b = inst.RB;
+	if (inst.OPCD == 21)
+	{
+		decoded.sh = inst.SH;
+		decoded.mask = Interpreter::Helper_Mask(inst.MB, inst.ME);
+	}
+	return decoded;
 }
 
 void CachedInterpreter::Jit(u32 address)
@@ -143,11 +383,11 @@ void CachedInterpreter::Jit(u32 address)
 				int flags = HLE::GetFunctionFlagsByIndex(function);
 				if (HLE::IsEnabled(flags))
 				{
-					m_code.emplace_back(WritePC, ops[i].address);
+					m_code.emplace_back(Handlers::WritePC, ops[i].address);
 					m_code.emplace_back(Interpreter::HLEFunction, ops[i].inst);
 					if (type == HLE::HLE_HOOK_REPLACE)
 					{
-						m_code.emplace_back(EndBlock, js.downcountAmount);
+						m_code.emplace_back(Handlers::EndBlock, js.downcountAmount);
 						m_code.emplace_back();
 						break;
 					}
@@ -159,21 +399,21 @@ void CachedInterpreter::Jit(u32 address)
 		{
 			if ((ops[i].opinfo->flags & FL_USE_FPU) && !js.firstFPInstructionFound)
 			{
-				m_code.emplace_back(CheckFPU, ops[i].address);
+				m_code.emplace_back(Handlers::CheckFPU, ops[i].address);
 				js.firstFPInstructionFound = true;
 			}
 
 			if (ops[i].opinfo->flags & FL_ENDBLOCK)
-				m_code.emplace_back(WritePC, ops[i].address);
-			m_code.emplace_back(GetInterpreterOp(ops[i].inst), ops[i].inst);
+				m_code.emplace_back(Handlers::WritePC, ops[i].address);
+			m_code.push_back(Decode(ops[i].inst));
 			if (ops[i].opinfo->flags & FL_ENDBLOCK)
-				m_code.emplace_back(EndBlock, js.downcountAmount);
+				m_code.emplace_back(Handlers::EndBlock, js.downcountAmount);
 		}
 	}
 	if (code_block.m_broken)
 	{
-		m_code.emplace_back(WritePC, nextPC);
-		m_code.emplace_back(EndBlock, js.downcountAmount);
+		m_code.emplace_back(Handlers::WritePC, nextPC);
+		m_code.emplace_back(Handlers::EndBlock, js.downcountAmount);
 	}
 	m_code.emplace_back();
 
@@ -196,3 +436,7 @@ void CachedInterpreter::WriteDestroyBlock(const u8* location, u32 address)
 void CachedInterpreter::WriteLinkBlock(u8* location, const u8* address)
 {
 }
+
+void CachedInterpreter::WriteUnlinkBlock(u8* location, u32 address)
+{
+}
@@ -38,34 +38,49 @@ public:
 	void WriteLinkBlock(u8* location, const u8* address) override;
 
 	void WriteDestroyBlock(const u8* location, u32 address) override;
+	void WriteUnlinkBlock(u8* location, u32 address) override;
 
 	const CommonAsmRoutinesBase* GetAsmRoutines() override { return nullptr; };
 
 private:
+	// One pre-decoded instruction. Blocks are compiled into an array of these,
+	// each carrying the handler to run it, and executed by calling the handlers
+	// in order until one of them returns true to leave the block. The common
+	// integer and load/store forms get handlers of their own that work on the
+	// unpacked fields; everything else calls the interpreter with the raw
+	// instruction.
+	// This is call threading rather than direct threading: jumping straight
+	// from one handler to the next needs computed gotos, which MSVC doesn't
+	// have, and the handlers being plain functions keeps them shareable with
+	// the interpreter fallback.
 	struct Instruction
 	{
+		typedef bool (*Handler)(const Instruction& inst);
 		typedef void (*CommonCallback)(UGeckoInstruction);
-		typedef bool (*ConditionalCallback)(u32 data);
 
-		Instruction() : type(INSTRUCTION_ABORT) {};
-		Instruction(const CommonCallback c, UGeckoInstruction i) : common_callback(c), data(i.hex), type(INSTRUCTION_TYPE_COMMON) {};
-		Instruction(const ConditionalCallback c, u32 d) : conditional_callback(c), data(d), type(INSTRUCTION_TYPE_CONDITIONAL) {};
+		Instruction();
+		Instruction(Handler h, u32 imm);
+		Instruction(CommonCallback c, UGeckoInstruction i);
 
+		Handler handler;
 		union
 		{
-			const CommonCallback common_callback;
-			const ConditionalCallback conditional_callback;
-
+			// Interpreter fallback
+			CommonCallback common_callback;
+			// rlwinm
+			u32 mask;
 		};
+		// Raw instruction, immediate or address, depending on the handler.
 		u32 data;
-		enum
-		{
-			INSTRUCTION_ABORT,
-			INSTRUCTION_TYPE_COMMON,
-			INSTRUCTION_TYPE_CONDITIONAL,
-		} type;
+		// Unpacked register fields (or CR field for compares) and shift amount.
+		u8 d, a, b, sh;
 	};
 
+	// The handlers, defined in CachedInterpreter.cpp.
+	struct Handlers;
+
+	static Instruction Decode(UGeckoInstruction inst);
+
 	const u8* GetCodePtr() { return (u8*)(m_code.data() + m_code.size()); }
 
 	std::vector<Instruction> m_code;
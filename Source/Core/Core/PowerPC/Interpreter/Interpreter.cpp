@@ -89,6 +89,12 @@ int Interpreter::SingleStepInner()
 					// Run the original.
 					function = 0;
 				}
+				else if (PowerPC::ppcState.Exceptions & EXCEPTION_DSI)
+				{
+					// The native routines return to their entry when they fault.
+					PowerPC::CheckExceptions();
+					m_EndBlock = true;
+				}
 			}
 			else
 			{
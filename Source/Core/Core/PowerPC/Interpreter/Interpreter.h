@@ -29,6 +29,32 @@ public:
 
 	static bool m_EndBlock;
 
+	// Some handlers are templates over the decoded form of their instruction,
+	// so that the forms InterpreterTables::GetDecodedOp picks when decoding
+	// ahead of time don't test the fields again on every execution. The
+	// FORM_RUNTIME instances read the fields from the instruction and are the
+	// ones in the opcode tables.
+	enum
+	{
+		FORM_RUNTIME = -1,
+		FORM_RC      = 1 << 0,  // record bit set
+		FORM_OE      = 1 << 1,  // overflow enable set
+		FORM_RA0     = 1 << 2,  // rA is 0, which reads as the value 0
+	};
+
+	template <int form> static bool HasRc(UGeckoInstruction _inst)
+	{
+		return form == FORM_RUNTIME ? _inst.Rc != 0 : (form & FORM_RC) != 0;
+	}
+	template <int form> static bool HasOE(UGeckoInstruction _inst)
+	{
+		return form == FORM_RUNTIME ? _inst.OE != 0 : (form & FORM_OE) != 0;
+	}
+	template <int form> static bool IsRA0(UGeckoInstruction _inst)
+	{
+		return form == FORM_RUNTIME ? _inst.RA == 0 : (form & FORM_RA0) != 0;
+	}
+
 	static void unknown_instruction(UGeckoInstruction _inst);
 
 	// Branch Instructions
@@ -72,10 +98,10 @@ public:
 	static void fsubx(UGeckoInstruction _inst);
 
 	// Integer Instructions
-	static void addi(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addi(UGeckoInstruction _inst);
 	static void addic(UGeckoInstruction _inst);
 	static void addic_rc(UGeckoInstruction _inst);
-	static void addis(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addis(UGeckoInstruction _inst);
 	static void andi_rc(UGeckoInstruction _inst);
 	static void andis_rc(UGeckoInstruction _inst);
 	static void cmpi(UGeckoInstruction _inst);
@@ -87,68 +113,68 @@ public:
 	static void twi(UGeckoInstruction _inst);
 	static void xori(UGeckoInstruction _inst);
 	static void xoris(UGeckoInstruction _inst);
-	static void rlwimix(UGeckoInstruction _inst);
-	static void rlwinmx(UGeckoInstruction _inst);
-	static void rlwnmx(UGeckoInstruction _inst);
-	static void andx(UGeckoInstruction _inst);
-	static void andcx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void rlwimix(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void rlwinmx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void rlwnmx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void andx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void andcx(UGeckoInstruction _inst);
 	static void cmp(UGeckoInstruction _inst);
 	static void cmpl(UGeckoInstruction _inst);
-	static void cntlzwx(UGeckoInstruction _inst);
-	static void eqvx(UGeckoInstruction _inst);
-	static void extsbx(UGeckoInstruction _inst);
-	static void extshx(UGeckoInstruction _inst);
-	static void nandx(UGeckoInstruction _inst);
-	static void norx(UGeckoInstruction _inst);
-	static void orx(UGeckoInstruction _inst);
-	static void orcx(UGeckoInstruction _inst);
-	static void slwx(UGeckoInstruction _inst);
-	static void srawx(UGeckoInstruction _inst);
-	static void srawix(UGeckoInstruction _inst);
-	static void srwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void cntlzwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void eqvx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void extsbx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void extshx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void nandx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void norx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void orx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void orcx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void slwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void srawx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void srawix(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void srwx(UGeckoInstruction _inst);
 	static void tw(UGeckoInstruction _inst);
-	static void xorx(UGeckoInstruction _inst);
-	static void addx(UGeckoInstruction _inst);
-	static void addcx(UGeckoInstruction _inst);
-	static void addex(UGeckoInstruction _inst);
-	static void addmex(UGeckoInstruction _inst);
-	static void addzex(UGeckoInstruction _inst);
-	static void divwx(UGeckoInstruction _inst);
-	static void divwux(UGeckoInstruction _inst);
-	static void mulhwx(UGeckoInstruction _inst);
-	static void mulhwux(UGeckoInstruction _inst);
-	static void mullwx(UGeckoInstruction _inst);
-	static void negx(UGeckoInstruction _inst);
-	static void subfx(UGeckoInstruction _inst);
-	static void subfcx(UGeckoInstruction _inst);
-	static void subfex(UGeckoInstruction _inst);
-	static void subfmex(UGeckoInstruction _inst);
-	static void subfzex(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void xorx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addcx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addex(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addmex(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void addzex(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void divwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void divwux(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void mulhwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void mulhwux(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void mullwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void negx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void subfx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void subfcx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void subfex(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void subfmex(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void subfzex(UGeckoInstruction _inst);
 
 	// Load/Store Instructions
-	static void lbz(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lbz(UGeckoInstruction _inst);
 	static void lbzu(UGeckoInstruction _inst);
-	static void lfd(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lfd(UGeckoInstruction _inst);
 	static void lfdu(UGeckoInstruction _inst);
-	static void lfs(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lfs(UGeckoInstruction _inst);
 	static void lfsu(UGeckoInstruction _inst);
-	static void lha(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lha(UGeckoInstruction _inst);
 	static void lhau(UGeckoInstruction _inst);
-	static void lhz(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lhz(UGeckoInstruction _inst);
 	static void lhzu(UGeckoInstruction _inst);
 	static void lmw(UGeckoInstruction _inst);
-	static void lwz(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lwz(UGeckoInstruction _inst);
 	static void lwzu(UGeckoInstruction _inst);
-	static void stb(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stb(UGeckoInstruction _inst);
 	static void stbu(UGeckoInstruction _inst);
-	static void stfd(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stfd(UGeckoInstruction _inst);
 	static void stfdu(UGeckoInstruction _inst);
-	static void stfs(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stfs(UGeckoInstruction _inst);
 	static void stfsu(UGeckoInstruction _inst);
-	static void sth(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void sth(UGeckoInstruction _inst);
 	static void sthu(UGeckoInstruction _inst);
 	static void stmw(UGeckoInstruction _inst);
-	static void stw(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stw(UGeckoInstruction _inst);
 	static void stwu(UGeckoInstruction _inst);
 	static void dcba(UGeckoInstruction _inst);
 	static void dcbf(UGeckoInstruction _inst);
@@ -162,38 +188,38 @@ public:
 	static void eieio(UGeckoInstruction _inst);
 	static void icbi(UGeckoInstruction _inst);
 	static void lbzux(UGeckoInstruction _inst);
-	static void lbzx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lbzx(UGeckoInstruction _inst);
 	static void lfdux(UGeckoInstruction _inst);
-	static void lfdx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lfdx(UGeckoInstruction _inst);
 	static void lfsux(UGeckoInstruction _inst);
-	static void lfsx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lfsx(UGeckoInstruction _inst);
 	static void lhaux(UGeckoInstruction _inst);
-	static void lhax(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lhax(UGeckoInstruction _inst);
 	static void lhbrx(UGeckoInstruction _inst);
 	static void lhzux(UGeckoInstruction _inst);
-	static void lhzx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lhzx(UGeckoInstruction _inst);
 	static void lswi(UGeckoInstruction _inst);
 	static void lswx(UGeckoInstruction _inst);
 	static void lwarx(UGeckoInstruction _inst);
 	static void lwbrx(UGeckoInstruction _inst);
 	static void lwzux(UGeckoInstruction _inst);
-	static void lwzx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void lwzx(UGeckoInstruction _inst);
 	static void stbux(UGeckoInstruction _inst);
-	static void stbx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stbx(UGeckoInstruction _inst);
 	static void stfdux(UGeckoInstruction _inst);
-	static void stfdx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stfdx(UGeckoInstruction _inst);
 	static void stfiwx(UGeckoInstruction _inst);
 	static void stfsux(UGeckoInstruction _inst);
-	static void stfsx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stfsx(UGeckoInstruction _inst);
 	static void sthbrx(UGeckoInstruction _inst);
 	static void sthux(UGeckoInstruction _inst);
-	static void sthx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void sthx(UGeckoInstruction _inst);
 	static void stswi(UGeckoInstruction _inst);
 	static void stswx(UGeckoInstruction _inst);
 	static void stwbrx(UGeckoInstruction _inst);
 	static void stwcxd(UGeckoInstruction _inst);
 	static void stwux(UGeckoInstruction _inst);
-	static void stwx(UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME> static void stwx(UGeckoInstruction _inst);
 	static void tlbie(UGeckoInstruction _inst);
 	static void tlbsync(UGeckoInstruction _inst);
 
@@ -287,6 +313,7 @@ public:
 	static void RunTable63(UGeckoInstruction _instCode);
 
 	static u32 Helper_Carry(u32 _uValue1, u32 _uValue2);
+	static u32 Helper_Mask(int mb, int me);
 
 private:
 	// flag helper
@@ -295,9 +322,17 @@ private:
 	static void Helper_UpdateCRx(int _x, u32 _uValue);
 
 	// address helper
-	static u32 Helper_Get_EA   (const UGeckoInstruction _inst);
+	template <int form = FORM_RUNTIME>
+	static u32 Helper_Get_EA(const UGeckoInstruction _inst)
+	{
+		return IsRA0<form>(_inst) ? (u32)_inst.SIMM_16 : (rGPR[_inst.RA] + _inst.SIMM_16);
+	}
+	template <int form = FORM_RUNTIME>
+	static u32 Helper_Get_EA_X(const UGeckoInstruction _inst)
+	{
+		return IsRA0<form>(_inst) ? rGPR[_inst.RB] : (rGPR[_inst.RA] + rGPR[_inst.RB]);
+	}
 	static u32 Helper_Get_EA_U (const UGeckoInstruction _inst);
-	static u32 Helper_Get_EA_X (const UGeckoInstruction _inst);
 	static u32 Helper_Get_EA_UX(const UGeckoInstruction _inst);
 
 	// paired helper
@@ -305,8 +340,6 @@ private:
 	static void Helper_Quantize(u32 addr, u32 instI, u32 instRS, u32 instW);
 
 	// other helper
-	static u32 Helper_Mask(int mb, int me);
-
 	static void Helper_FloatCompareOrdered(UGeckoInstruction _inst, double a, double b);
 	static void Helper_FloatCompareUnordered(UGeckoInstruction _inst, double a, double b);
 
@@ -315,3 +348,19 @@ private:
 	static bool g_bReserve;
 	static u32  g_reserveAddr;
 };
+
+// The forms of a template handler that InterpreterTables refers to.
+#define INSTANTIATE_RC_FORMS(handler) \
+	template void Interpreter::handler<Interpreter::FORM_RUNTIME>(UGeckoInstruction); \
+	template void Interpreter::handler<0>(UGeckoInstruction); \
+	template void Interpreter::handler<Interpreter::FORM_RC>(UGeckoInstruction)
+
+#define INSTANTIATE_RC_OE_FORMS(handler) \
+	INSTANTIATE_RC_FORMS(handler); \
+	template void Interpreter::handler<Interpreter::FORM_OE>(UGeckoInstruction); \
+	template void Interpreter::handler<Interpreter::FORM_OE | Interpreter::FORM_RC>(UGeckoInstruction)
+
+#define INSTANTIATE_RA0_FORMS(handler) \
+	template void Interpreter::handler<Interpreter::FORM_RUNTIME>(UGeckoInstruction); \
+	template void Interpreter::handler<0>(UGeckoInstruction); \
+	template void Interpreter::handler<Interpreter::FORM_RA0>(UGeckoInstruction)
@@ -42,9 +42,10 @@ u32 Interpreter::Helper_Mask(int mb, int me)
 		return mask;
 }
 
+template <int form>
 void Interpreter::addi(UGeckoInstruction _inst)
 {
-	if (_inst.RA)
+	if (!IsRA0<form>(_inst))
 		rGPR[_inst.RD] = rGPR[_inst.RA] + _inst.SIMM_16;
 	else
 		rGPR[_inst.RD] = _inst.SIMM_16;
@@ -65,9 +66,10 @@ void Interpreter::addic_rc(UGeckoInstruction _inst)
 	Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::addis(UGeckoInstruction _inst)
 {
-	if (_inst.RA)
+	if (!IsRA0<form>(_inst))
 		rGPR[_inst.RD] = rGPR[_inst.RA] + (_inst.SIMM_16 << 16);
 	else
 		rGPR[_inst.RD] = (_inst.SIMM_16 << 16);
@@ -173,46 +175,51 @@ void Interpreter::xoris(UGeckoInstruction _inst)
 	rGPR[_inst.RA] = rGPR[_inst.RS] ^ (_inst.UIMM << 16);
 }
 
+template <int form>
 void Interpreter::rlwimix(UGeckoInstruction _inst)
 {
 	u32 mask = Helper_Mask(_inst.MB,_inst.ME);
 	rGPR[_inst.RA] = (rGPR[_inst.RA] & ~mask) | (_rotl(rGPR[_inst.RS],_inst.SH) & mask);
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::rlwinmx(UGeckoInstruction _inst)
 {
 	u32 mask = Helper_Mask(_inst.MB,_inst.ME);
 	rGPR[_inst.RA] = _rotl(rGPR[_inst.RS],_inst.SH) & mask;
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::rlwnmx(UGeckoInstruction _inst)
 {
 	u32 mask = Helper_Mask(_inst.MB,_inst.ME);
 	rGPR[_inst.RA] = _rotl(rGPR[_inst.RS], rGPR[_inst.RB] & 0x1F) & mask;
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::andx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = rGPR[_inst.RS] & rGPR[_inst.RB];
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::andcx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = rGPR[_inst.RS] & ~rGPR[_inst.RB];
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
@@ -254,6 +261,7 @@ void Interpreter::cmpl(UGeckoInstruction _inst)
 	SetCRField(_inst.CRFD, fTemp);
 }
 
+template <int form>
 void Interpreter::cntlzwx(UGeckoInstruction _inst)
 {
 	u32 val = rGPR[_inst.RS];
@@ -268,75 +276,84 @@ void Interpreter::cntlzwx(UGeckoInstruction _inst)
 
 	rGPR[_inst.RA] = i;
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::eqvx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = ~(rGPR[_inst.RS] ^ rGPR[_inst.RB]);
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::extsbx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = (u32)(s32)(s8)rGPR[_inst.RS];
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::extshx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = (u32)(s32)(s16)rGPR[_inst.RS];
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::nandx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = ~(rGPR[_inst.RS] & rGPR[_inst.RB]);
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::norx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = ~(rGPR[_inst.RS] | rGPR[_inst.RB]);
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::orx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = rGPR[_inst.RS] | rGPR[_inst.RB];
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::orcx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = rGPR[_inst.RS] | (~rGPR[_inst.RB]);
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::slwx(UGeckoInstruction _inst)
 {
 	u32 amount = rGPR[_inst.RB];
 	rGPR[_inst.RA] = (amount & 0x20) ? 0 : rGPR[_inst.RS] << (amount & 0x1f);
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::srawx(UGeckoInstruction _inst)
 {
 	int rb = rGPR[_inst.RB];
@@ -374,10 +391,11 @@ void Interpreter::srawx(UGeckoInstruction _inst)
 		}
 	}
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::srawix(UGeckoInstruction _inst)
 {
 	int amount = _inst.SH;
@@ -398,16 +416,17 @@ void Interpreter::srawix(UGeckoInstruction _inst)
 		rGPR[_inst.RA] = rGPR[_inst.RS];
 	}
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::srwx(UGeckoInstruction _inst)
 {
 	u32 amount = rGPR[_inst.RB];
 	rGPR[_inst.RA] = (amount & 0x20) ? 0 : (rGPR[_inst.RS] >> (amount & 0x1f));
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
@@ -431,25 +450,28 @@ void Interpreter::tw(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::xorx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RA] = rGPR[_inst.RS] ^ rGPR[_inst.RB];
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RA]);
 }
 
+template <int form>
 void Interpreter::addx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RD] = rGPR[_inst.RA] + rGPR[_inst.RB];
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: addx");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::addcx(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -457,13 +479,14 @@ void Interpreter::addcx(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = a + b;
 	SetCarry(Helper_Carry(a,b));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: addcx");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::addex(UGeckoInstruction _inst)
 {
 	int carry = GetCarry();
@@ -472,13 +495,14 @@ void Interpreter::addex(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = a + b + carry;
 	SetCarry(Helper_Carry(a, b) || (carry != 0 && Helper_Carry(a + b, carry)));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: addex");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::addmex(UGeckoInstruction _inst)
 {
 	int carry = GetCarry();
@@ -486,13 +510,14 @@ void Interpreter::addmex(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = a + carry - 1;
 	SetCarry(Helper_Carry(a, carry - 1));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: addmex");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::addzex(UGeckoInstruction _inst)
 {
 	int carry = GetCarry();
@@ -500,13 +525,14 @@ void Interpreter::addzex(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = a + carry;
 	SetCarry(Helper_Carry(a, carry));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: addzex");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::divwx(UGeckoInstruction _inst)
 {
 	s32 a = rGPR[_inst.RA];
@@ -514,7 +540,7 @@ void Interpreter::divwx(UGeckoInstruction _inst)
 
 	if (b == 0 || ((u32)a == 0x80000000 && b == -1))
 	{
-		if (_inst.OE)
+		if (HasOE<form>(_inst))
 		{
 			// should set OV
 			PanicAlert("OE: divwx");
@@ -530,11 +556,12 @@ void Interpreter::divwx(UGeckoInstruction _inst)
 		rGPR[_inst.RD] = (u32)(a / b);
 	}
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
 
+template <int form>
 void Interpreter::divwux(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -542,7 +569,7 @@ void Interpreter::divwux(UGeckoInstruction _inst)
 
 	if (b == 0)
 	{
-		if (_inst.OE)
+		if (HasOE<form>(_inst))
 		{
 			// should set OV
 			PanicAlert("OE: divwux");
@@ -555,10 +582,11 @@ void Interpreter::divwux(UGeckoInstruction _inst)
 		rGPR[_inst.RD] = a / b;
 	}
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::mulhwx(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -566,10 +594,11 @@ void Interpreter::mulhwx(UGeckoInstruction _inst)
 	u32 d = (u32)((u64)(((s64)(s32)a * (s64)(s32)b) ) >> 32);  // This can be done better. Not in plain C/C++ though.
 	rGPR[_inst.RD] = d;
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::mulhwux(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -577,10 +606,11 @@ void Interpreter::mulhwux(UGeckoInstruction _inst)
 	u32 d = (u32)(((u64)a * (u64)b) >> 32);
 	rGPR[_inst.RD] = d;
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::mullwx(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -588,38 +618,41 @@ void Interpreter::mullwx(UGeckoInstruction _inst)
 	u32 d = (u32)((s32)a * (s32)b);
 	rGPR[_inst.RD] = d;
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: mullwx");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::negx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RD] = (~rGPR[_inst.RA]) + 1;
 
 	if (rGPR[_inst.RD] == 0x80000000)
 	{
-		if (_inst.OE)
+		if (HasOE<form>(_inst))
 			PanicAlert("OE: negx");
 	}
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::subfx(UGeckoInstruction _inst)
 {
 	rGPR[_inst.RD] = rGPR[_inst.RB] - rGPR[_inst.RA];
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: subfx");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::subfcx(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -627,13 +660,14 @@ void Interpreter::subfcx(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = b - a;
 	SetCarry(a == 0 || Helper_Carry(b, 0-a));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: subfcx");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
+template <int form>
 void Interpreter::subfex(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -642,14 +676,15 @@ void Interpreter::subfex(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = (~a) + b + carry;
 	SetCarry(Helper_Carry(~a, b) || Helper_Carry((~a) + b, carry));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: subfex");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
 // sub from minus one
+template <int form>
 void Interpreter::subfmex(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -657,14 +692,15 @@ void Interpreter::subfmex(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = (~a) + carry - 1;
 	SetCarry(Helper_Carry(~a, carry - 1));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: subfmex");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
 
 // sub from zero
+template <int form>
 void Interpreter::subfzex(UGeckoInstruction _inst)
 {
 	u32 a = rGPR[_inst.RA];
@@ -672,9 +708,46 @@ void Interpreter::subfzex(UGeckoInstruction _inst)
 	rGPR[_inst.RD] = (~a) + carry;
 	SetCarry(Helper_Carry(~a, carry));
 
-	if (_inst.OE)
+	if (HasOE<form>(_inst))
 		PanicAlert("OE: subfzex");
 
-	if (_inst.Rc)
+	if (HasRc<form>(_inst))
 		Helper_UpdateCR0(rGPR[_inst.RD]);
 }
+
+INSTANTIATE_RA0_FORMS(addi);
+INSTANTIATE_RA0_FORMS(addis);
+INSTANTIATE_RC_FORMS(rlwimix);
+INSTANTIATE_RC_FORMS(rlwinmx);
+INSTANTIATE_RC_FORMS(rlwnmx);
+INSTANTIATE_RC_FORMS(andx);
+INSTANTIATE_RC_FORMS(andcx);
+INSTANTIATE_RC_FORMS(cntlzwx);
+INSTANTIATE_RC_FORMS(eqvx);
+INSTANTIATE_RC_FORMS(extsbx);
+INSTANTIATE_RC_FORMS(extshx);
+INSTANTIATE_RC_FORMS(nandx);
+INSTANTIATE_RC_FORMS(norx);
+INSTANTIATE_RC_FORMS(orx);
+INSTANTIATE_RC_FORMS(orcx);
+INSTANTIATE_RC_FORMS(slwx);
+INSTANTIATE_RC_FORMS(srawx);
+INSTANTIATE_RC_FORMS(srawix);
+INSTANTIATE_RC_FORMS(srwx);
+INSTANTIATE_RC_FORMS(xorx);
+INSTANTIATE_RC_FORMS(mulhwx);
+INSTANTIATE_RC_FORMS(mulhwux);
+INSTANTIATE_RC_OE_FORMS(addx);
+INSTANTIATE_RC_OE_FORMS(addcx);
+INSTANTIATE_RC_OE_FORMS(addex);
+INSTANTIATE_RC_OE_FORMS(addmex);
+INSTANTIATE_RC_OE_FORMS(addzex);
+INSTANTIATE_RC_OE_FORMS(divwx);
+INSTANTIATE_RC_OE_FORMS(divwux);
+INSTANTIATE_RC_OE_FORMS(mullwx);
+INSTANTIATE_RC_OE_FORMS(negx);
+INSTANTIATE_RC_OE_FORMS(subfx);
+INSTANTIATE_RC_OE_FORMS(subfcx);
+INSTANTIATE_RC_OE_FORMS(subfex);
+INSTANTIATE_RC_OE_FORMS(subfmex);
+INSTANTIATE_RC_OE_FORMS(subfzex);
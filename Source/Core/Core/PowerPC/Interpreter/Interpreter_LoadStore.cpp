@@ -14,29 +14,20 @@
 bool Interpreter::g_bReserve;
 u32  Interpreter::g_reserveAddr;
 
-u32 Interpreter::Helper_Get_EA(const UGeckoInstruction _inst)
-{
-	return _inst.RA ? (rGPR[_inst.RA] + _inst.SIMM_16) : (u32)_inst.SIMM_16;
-}
-
 u32 Interpreter::Helper_Get_EA_U(const UGeckoInstruction _inst)
 {
 	return (rGPR[_inst.RA] + _inst.SIMM_16);
 }
 
-u32 Interpreter::Helper_Get_EA_X(const UGeckoInstruction _inst)
-{
-	return _inst.RA ? (rGPR[_inst.RA] + rGPR[_inst.RB]) : rGPR[_inst.RB];
-}
-
 u32 Interpreter::Helper_Get_EA_UX(const UGeckoInstruction _inst)
 {
 	return (rGPR[_inst.RA] + rGPR[_inst.RB]);
 }
 
+template <int form>
 void Interpreter::lbz(UGeckoInstruction _inst)
 {
-	u32 temp = (u32)PowerPC::Read_U8(Helper_Get_EA(_inst));
+	u32 temp = (u32)PowerPC::Read_U8(Helper_Get_EA<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 		rGPR[_inst.RD] = temp;
 }
@@ -52,9 +43,10 @@ void Interpreter::lbzu(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lfd(UGeckoInstruction _inst)
 {
-	u64 temp = PowerPC::Read_U64(Helper_Get_EA(_inst));
+	u64 temp = PowerPC::Read_U64(Helper_Get_EA<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 		riPS0(_inst.FD) = temp;
 }
@@ -81,16 +73,18 @@ void Interpreter::lfdux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lfdx(UGeckoInstruction _inst)
 {
-	u64 temp = PowerPC::Read_U64(Helper_Get_EA_X(_inst));
+	u64 temp = PowerPC::Read_U64(Helper_Get_EA_X<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 		riPS0(_inst.FD) = temp;
 }
 
+template <int form>
 void Interpreter::lfs(UGeckoInstruction _inst)
 {
-	u32 uTemp = PowerPC::Read_U32(Helper_Get_EA(_inst));
+	u32 uTemp = PowerPC::Read_U32(Helper_Get_EA<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		u64 value = ConvertToDouble(uTemp);
@@ -126,9 +120,10 @@ void Interpreter::lfsux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lfsx(UGeckoInstruction _inst)
 {
-	u32 uTemp = PowerPC::Read_U32(Helper_Get_EA_X(_inst));
+	u32 uTemp = PowerPC::Read_U32(Helper_Get_EA_X<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		u64 value = ConvertToDouble(uTemp);
@@ -137,9 +132,10 @@ void Interpreter::lfsx(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lha(UGeckoInstruction _inst)
 {
-	u32 temp = (u32)(s32)(s16)PowerPC::Read_U16(Helper_Get_EA(_inst));
+	u32 temp = (u32)(s32)(s16)PowerPC::Read_U16(Helper_Get_EA<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		rGPR[_inst.RD] = temp;
@@ -157,9 +153,10 @@ void Interpreter::lhau(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lhz(UGeckoInstruction _inst)
 {
-	u32 temp = (u32)(u16)PowerPC::Read_U16(Helper_Get_EA(_inst));
+	u32 temp = (u32)(u16)PowerPC::Read_U16(Helper_Get_EA<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		rGPR[_inst.RD] = temp;
@@ -213,9 +210,10 @@ void Interpreter::stmw(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lwz(UGeckoInstruction _inst)
 {
-	u32 uAddress = Helper_Get_EA(_inst);
+	u32 uAddress = Helper_Get_EA<form>(_inst);
 	u32 temp = PowerPC::Read_U32(uAddress);
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
@@ -234,9 +232,10 @@ void Interpreter::lwzu(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stb(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U8((u8)rGPR[_inst.RS], Helper_Get_EA(_inst));
+	PowerPC::Write_U8((u8)rGPR[_inst.RS], Helper_Get_EA<form>(_inst));
 }
 
 void Interpreter::stbu(UGeckoInstruction _inst)
@@ -249,9 +248,10 @@ void Interpreter::stbu(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stfd(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U64(riPS0(_inst.FS), Helper_Get_EA(_inst));
+	PowerPC::Write_U64(riPS0(_inst.FS), Helper_Get_EA<form>(_inst));
 }
 
 void Interpreter::stfdu(UGeckoInstruction _inst)
@@ -264,9 +264,10 @@ void Interpreter::stfdu(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stfs(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U32(ConvertToSingle(riPS0(_inst.FS)), Helper_Get_EA(_inst));
+	PowerPC::Write_U32(ConvertToSingle(riPS0(_inst.FS)), Helper_Get_EA<form>(_inst));
 }
 
 void Interpreter::stfsu(UGeckoInstruction _inst)
@@ -279,9 +280,10 @@ void Interpreter::stfsu(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::sth(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U16((u16)rGPR[_inst.RS], Helper_Get_EA(_inst));
+	PowerPC::Write_U16((u16)rGPR[_inst.RS], Helper_Get_EA<form>(_inst));
 }
 
 void Interpreter::sthu(UGeckoInstruction _inst)
@@ -294,9 +296,10 @@ void Interpreter::sthu(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stw(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U32(rGPR[_inst.RS], Helper_Get_EA(_inst));
+	PowerPC::Write_U32(rGPR[_inst.RS], Helper_Get_EA<form>(_inst));
 }
 
 void Interpreter::stwu(UGeckoInstruction _inst)
@@ -432,9 +435,10 @@ void Interpreter::lbzux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lbzx(UGeckoInstruction _inst)
 {
-	u32 temp = (u32)PowerPC::Read_U8(Helper_Get_EA_X(_inst));
+	u32 temp = (u32)PowerPC::Read_U8(Helper_Get_EA_X<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		rGPR[_inst.RD] = temp;
@@ -452,9 +456,10 @@ void Interpreter::lhaux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lhax(UGeckoInstruction _inst)
 {
-	s32 temp = (s32)(s16)PowerPC::Read_U16(Helper_Get_EA_X(_inst));
+	s32 temp = (s32)(s16)PowerPC::Read_U16(Helper_Get_EA_X<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		rGPR[_inst.RD] = temp;
@@ -481,9 +486,10 @@ void Interpreter::lhzux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lhzx(UGeckoInstruction _inst)
 {
-	u32 temp = (u32)PowerPC::Read_U16(Helper_Get_EA_X(_inst));
+	u32 temp = (u32)PowerPC::Read_U16(Helper_Get_EA_X<form>(_inst));
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
 		rGPR[_inst.RD] = temp;
@@ -546,9 +552,10 @@ void Interpreter::lwzux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::lwzx(UGeckoInstruction _inst)
 {
-	u32 uAddress = Helper_Get_EA_X(_inst);
+	u32 uAddress = Helper_Get_EA_X<form>(_inst);
 	u32 temp = PowerPC::Read_U32(uAddress);
 	if (!(PowerPC::ppcState.Exceptions & EXCEPTION_DSI))
 	{
@@ -566,9 +573,10 @@ void Interpreter::stbux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stbx(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U8((u8)rGPR[_inst.RS], Helper_Get_EA_X(_inst));
+	PowerPC::Write_U8((u8)rGPR[_inst.RS], Helper_Get_EA_X<form>(_inst));
 }
 
 void Interpreter::stfdux(UGeckoInstruction _inst)
@@ -581,9 +589,10 @@ void Interpreter::stfdux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stfdx(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U64(riPS0(_inst.FS), Helper_Get_EA_X(_inst));
+	PowerPC::Write_U64(riPS0(_inst.FS), Helper_Get_EA_X<form>(_inst));
 }
 
 // Stores Floating points into Integers indeXed
@@ -605,9 +614,10 @@ void Interpreter::stfsux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stfsx(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U32(ConvertToSingle(riPS0(_inst.FS)), Helper_Get_EA_X(_inst));
+	PowerPC::Write_U32(ConvertToSingle(riPS0(_inst.FS)), Helper_Get_EA_X<form>(_inst));
 }
 
 void Interpreter::sthbrx(UGeckoInstruction _inst)
@@ -625,9 +635,10 @@ void Interpreter::sthux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::sthx(UGeckoInstruction _inst)
 {
-	PowerPC::Write_U16((u16)rGPR[_inst.RS], Helper_Get_EA_X(_inst));
+	PowerPC::Write_U16((u16)rGPR[_inst.RS], Helper_Get_EA_X<form>(_inst));
 }
 
 // __________________________________________________________________________________________________
@@ -794,9 +805,10 @@ void Interpreter::stwux(UGeckoInstruction _inst)
 	}
 }
 
+template <int form>
 void Interpreter::stwx(UGeckoInstruction _inst)
 {
-	u32 uAddress = Helper_Get_EA_X(_inst);
+	u32 uAddress = Helper_Get_EA_X<form>(_inst);
 	PowerPC::Write_U32(rGPR[_inst.RS], uAddress);
 }
 
@@ -816,3 +828,26 @@ void Interpreter::tlbsync(UGeckoInstruction _inst)
 {
 	//MessageBox(0,"TLBsync","TLBsyncE",0);
 }
+
+INSTANTIATE_RA0_FORMS(lbz);
+INSTANTIATE_RA0_FORMS(lfd);
+INSTANTIATE_RA0_FORMS(lfs);
+INSTANTIATE_RA0_FORMS(lha);
+INSTANTIATE_RA0_FORMS(lhz);
+INSTANTIATE_RA0_FORMS(lwz);
+INSTANTIATE_RA0_FORMS(stb);
+INSTANTIATE_RA0_FORMS(stfd);
+INSTANTIATE_RA0_FORMS(stfs);
+INSTANTIATE_RA0_FORMS(sth);
+INSTANTIATE_RA0_FORMS(stw);
+INSTANTIATE_RA0_FORMS(lbzx);
+INSTANTIATE_RA0_FORMS(lfdx);
+INSTANTIATE_RA0_FORMS(lfsx);
+INSTANTIATE_RA0_FORMS(lhax);
+INSTANTIATE_RA0_FORMS(lhzx);
+INSTANTIATE_RA0_FORMS(lwzx);
+INSTANTIATE_RA0_FORMS(stbx);
+INSTANTIATE_RA0_FORMS(stfdx);
+INSTANTIATE_RA0_FORMS(stfsx);
+INSTANTIATE_RA0_FORMS(sthx);
+INSTANTIATE_RA0_FORMS(stwx);
@@ -4,7 +4,15 @@
 
 #pragma once
 
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+
 namespace InterpreterTables
 {
 	void InitTables();
+
+	// The handler specialised on the decoded form of _inst, or nullptr if its
+	// handler isn't specialised. Only for callers that decode an instruction
+	// once and run it many times.
+	Interpreter::Instruction GetDecodedOp(UGeckoInstruction _inst);
 }
@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <cinttypes>
 #include <map>
 #include <string>
 
@@ -11,6 +13,7 @@
 #endif
 
 #include "Common/CommonTypes.h"
+#include "Common/JitRegister.h"
 #include "Common/StringUtil.h"
 #include "Core/PatchEngine.h"
 #include "Core/HLE/HLE.h"
@@ -158,9 +161,9 @@ bool Jit64::HandleFault(uintptr_t access_address, SContext* ctx)
 		UnWriteProtectMemory(m_stack + GUARD_OFFSET, GUARD_SIZE);
 		// We're going to need to clear the whole cache to get rid of the bad
 		// CALLs, but we can't yet.  Fake the downcount so we're forced to the
-		// dispatcher (no block linking), and clear the cache so we're sent to
-		// Jit.  Yeah, it's kind of gross.
-		GetBlockCache()->InvalidateICache(0, 0xffffffff, true);
+		// dispatcher (no block linking), where SampleCodeRegionUse invalidates
+		// the cache so we're sent to Jit.  The compiler thread may hold the
+		// block cache, which can't be waited for in a fault handler.
 		CoreTiming::ForceExceptionCheck(0);
 		m_clear_cache_asap = true;
 
@@ -198,30 +201,193 @@ void Jit64::Init()
 		AllocStack();
 
 	blocks.Init();
-	asm_routines.Init(m_stack ? (m_stack + STACK_SIZE) : nullptr);
+	asm_routines.Init(m_stack ? (m_stack + STACK_SIZE) : nullptr, &Jit64::SampleCodeRegionUse);
 
 	// important: do this *after* generating the global asm routines, because we can't use farcode in them.
 	// it'll crash because the farcode functions get cleared on JIT clears.
 	farcode.Init(jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE);
+	InitCodeRegions();
 
 	code_block.m_stats = &js.st;
 	code_block.m_gpa = &js.gpa;
 	code_block.m_fpa = &js.fpa;
-	EnableOptimization();
+	EnableOptimization(analyzer);
+	if (SConfig::GetInstance().bSkipIdle)
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+
+	m_tiered_compile = SConfig::GetInstance().bJITTieredCompile && !SConfig::GetInstance().bEnableDebugging;
+	m_hot_block_threshold = std::max(SConfig::GetInstance().iJITHotBlockThreshold, 1);
+	m_hot_blocks.clear();
+
+	m_trace_formation = m_tiered_compile && SConfig::GetInstance().bJITTraceFormation;
+	m_taken_branches.clear();
+	analyzer.SetTakenBranches(&m_taken_branches);
+	m_async_analyzer = analyzer;
+
+	StartAsyncCompiler();
 }
 
 void Jit64::ClearCache()
 {
+	std::lock_guard<std::recursive_mutex> lk(compile_lock);
+
 	blocks.Clear();
+	// Requests that are still in flight refer to the old cache.
+	m_async_generation = blocks.GetGeneration();
+	m_async_queued.clear();
+	m_fastmem_sites.Clear();
+	// Blocks start over at the first tier.
+	m_hot_blocks.clear();
+
 	trampolines.ClearCodeSpace();
 	farcode.ClearCodeSpace();
 	ClearCodeSpace();
+	ResetCodeRegions();
 	UpdateMemoryOptions();
 	m_clear_cache_asap = false;
+	statistics.cache_clears++;
+}
+
+void Jit64::InitCodeRegions()
+{
+	// Called right after the code spaces are allocated, so the far code pointer
+	// is still at the start of its space.
+	size_t near_size = CODE_SIZE / NUM_CODE_REGIONS;
+	size_t far_size = (jo.memcheck ? FARCODE_SIZE_MMU : FARCODE_SIZE) / NUM_CODE_REGIONS;
+	u8* far_base = farcode.GetWritableCodePtr();
+	for (int i = 0; i < NUM_CODE_REGIONS; i++)
+	{
+		CodeRegion& r = m_code_regions[i];
+		r.near_start = region + i * near_size;
+		r.near_end = r.near_start + near_size;
+		r.far_start = far_base + i * far_size;
+		r.far_end = r.far_start + far_size;
+		r.generation = 0;
+	}
+	ResetCodeRegions();
+}
+
+void Jit64::ResetCodeRegions()
+{
+	for (CodeRegion& r : m_code_regions)
+	{
+		r.used = false;
+		r.last_used = 0;
+	}
+	m_region_clock = 0;
+	m_current_region = 0;
+	m_code_regions[0].used = true;
+}
+
+bool Jit64::IsCodeRegionAlmostFull() const
+{
+	// This should be bigger than the biggest block ever, like IsAlmostFull.
+	const CodeRegion& r = m_code_regions[m_current_region];
+	return GetCodePtr() + 0x10000 > r.near_end || farcode.GetCodePtr() + 0x10000 > r.far_end;
+}
+
+int Jit64::GetCodeRegion(const u8* ptr) const
+{
+	for (int i = 0; i < NUM_CODE_REGIONS; i++)
+	{
+		if (ptr >= m_code_regions[i].near_start && ptr < m_code_regions[i].near_end)
+			return i;
+	}
+	return -1;
+}
+
+bool Jit64::EvictCodeRegion()
+{
+	std::lock_guard<std::recursive_mutex> lk(compile_lock);
+
+	// Take a region nothing has been compiled into yet if there is one, unless
+	// it's the block numbers that ran out. Otherwise take the one that ran least
+	// recently.
+	bool need_blocks = blocks.IsFull();
+	int victim = -1;
+	for (int i = 0; i < NUM_CODE_REGIONS; i++)
+	{
+		const CodeRegion& r = m_code_regions[i];
+		if (i == m_current_region)
+			continue;
+		if (!r.used && !need_blocks)
+		{
+			victim = i;
+			break;
+		}
+		if (r.used && (victim < 0 || r.last_used < m_code_regions[victim].last_used))
+			victim = i;
+	}
+	if (victim < 0)
+		return false;
+
+	CodeRegion& r = m_code_regions[victim];
+	if (r.used)
+	{
+		std::vector<u32> evicted;
+		statistics.blocks_evicted += blocks.EvictBlocks(r.near_start, r.near_end, &evicted);
+		for (u32 address : evicted)
+			m_hot_blocks.erase(address);
+		m_fastmem_sites.EraseRange(r.near_start, r.near_end);
+		statistics.code_region_evictions++;
+		// Tells background compiles that went into this region that their code is gone.
+		r.generation++;
+	}
+	if (blocks.IsFull())
+		return false;
+
+	r.used = true;
+	r.last_used = ++m_region_clock;
+	m_current_region = victim;
+	SetCodePtr(r.near_start);
+	farcode.SetCodePtr(r.far_start);
+	return true;
+}
+
+void Jit64::ReclaimCodeSpace()
+{
+	// Trampolines aren't split into regions, and a pending clear has to throw
+	// away everything anyway.
+	if (m_clear_cache_asap || trampolines.IsAlmostFull() || !EvictCodeRegion())
+		ClearCache();
+}
+
+void Jit64::SampleCodeRegionUse()
+{
+	// Called at the end of every timeslice. The block that runs next is as good
+	// a sample of what's hot as any.
+	Jit64* self = static_cast<Jit64*>(jit);
+
+	// Left to do by HandleFault. Blocks that are still around may CALL further
+	// into the stack guard, so make the dispatcher go to Jit, which clears the
+	// cache and resets the stack.
+	if (self->m_clear_cache_asap)
+	{
+		self->blocks.InvalidateICache(0, 0xffffffff, true);
+		return;
+	}
+
+	int block_num = self->blocks.GetBlockNumberFromStartAddress(PC);
+	if (block_num < 0)
+		return;
+
+	const JitBlock* b = self->blocks.GetBlock(block_num);
+	if (b->pending)
+		return;
+
+	int region = self->GetCodeRegion(b->checkedEntry);
+	if (region >= 0)
+		self->m_code_regions[region].last_used = ++self->m_region_clock;
 }
 
 void Jit64::Shutdown()
 {
+	StopAsyncCompiler();
+	if (m_tiered_compile)
+		NOTICE_LOG(DYNA_REC, "Tiered compilation: %" PRIu64 " hot blocks recompiled", statistics.hot_recompiles);
+	NOTICE_LOG(DYNA_REC, "Code space: %" PRIu64 " regions evicted (%" PRIu64 " blocks), %" PRIu64 " full clears",
+	           statistics.code_region_evictions, statistics.blocks_evicted, statistics.cache_clears);
+
 	FreeStack();
 	FreeCodeSpace();
 
@@ -333,6 +499,17 @@ void Jit64::WriteExit(u32 destination, bool bl, u32 after)
 
 	Cleanup();
 
+	// Count the exit for trace formation. This has to happen before the
+	// downcount update, the destination block checks its flags.
+	u32* exit_count = nullptr;
+	if (js.firstTier && m_trace_formation)
+		exit_count = blocks.AllocateExitCounter();
+	if (exit_count)
+	{
+		MOV(64, R(RSCRATCH), Imm64((u64)exit_count));
+		ADD(32, MatR(RSCRATCH), Imm8(1));
+	}
+
 	if (bl)
 	{
 		MOV(32, R(RSCRATCH2), Imm32(after));
@@ -341,7 +518,9 @@ void Jit64::WriteExit(u32 destination, bool bl, u32 after)
 
 	SUB(32, PPCSTATE(downcount), Imm32(js.downcountAmount));
 
+	size_t exit_index = js.curBlock->linkData.size();
 	JustWriteExit(destination, bl, after);
+	js.curBlock->linkData[exit_index].exitCount = exit_count;
 }
 
 void Jit64::JustWriteExit(u32 destination, bool bl, u32 after)
@@ -350,16 +529,22 @@ void Jit64::JustWriteExit(u32 destination, bool bl, u32 after)
 	JitBlock *b = js.curBlock;
 	JitBlock::LinkData linkData;
 	linkData.exitAddress = destination;
+	linkData.exitFrom = js.compilerPC;
 	linkData.linkStatus = false;
 
-	// Link opportunity!
+	// pc is set even if the exit gets linked, so that the block cache can point
+	// the exit back at the dispatcher when the destination is evicted.
+	MOV(32, PPCSTATE(pc), Imm32(destination));
+	linkData.exitPtrs = GetWritableCodePtr();
+
+	// Link opportunity! Blocks compiled in the background get linked when
+	// they're installed, the block cache can't be looked at from here.
 	int block;
-	if (jo.enableBlocklink && (block = blocks.GetBlockNumberFromStartAddress(destination)) >= 0)
+	if (jo.enableBlocklink && !b->pending && (block = blocks.GetBlockNumberFromStartAddress(destination)) >= 0)
 	{
 		// It exists! Joy of joy!
 		JitBlock* jb = blocks.GetBlock(block);
 		const u8* addr = jb->checkedEntry;
-		linkData.exitPtrs = GetWritableCodePtr();
 		if (bl)
 			CALL(addr);
 		else
@@ -368,8 +553,6 @@ void Jit64::JustWriteExit(u32 destination, bool bl, u32 after)
 	}
 	else
 	{
-		MOV(32, PPCSTATE(pc), Imm32(destination));
-		linkData.exitPtrs = GetWritableCodePtr();
 		if (bl)
 			CALL(asm_routines.dispatcher);
 		else
@@ -465,6 +648,17 @@ void Jit64::WriteExternalExceptionExit()
 	JMP(asm_routines.dispatcher, true);
 }
 
+// Taken branch of a busy wait loop: skip to the next event instead of
+// spinning until it.
+void Jit64::WriteIdleExit(u32 destination)
+{
+	ABI_PushRegistersAndAdjustStack({}, 0);
+	ABI_CallFunctionC(reinterpret_cast<void *>(&CoreTiming::IdleLoop), destination);
+	ABI_PopRegistersAndAdjustStack({}, 0);
+	MOV(32, PPCSTATE(pc), Imm32(destination));
+	WriteExceptionExit();
+}
+
 void Jit64::Run()
 {
 	CompiledCode pExecAddr = (CompiledCode)asm_routines.enterCode;
@@ -502,21 +696,37 @@ void Jit64::Trace()
 
 void Jit64::Jit(u32 em_address)
 {
-	if (IsAlmostFull() || farcode.IsAlmostFull() || trampolines.IsAlmostFull() ||
-	    blocks.IsFull() ||
-	    SConfig::GetInstance().bJITNoBlockCache ||
-	    m_clear_cache_asap)
+	if (m_async_compile)
 	{
-		ClearCache();
+		InstallAsyncCompiles();
+		if (blocks.GetBlockNumberFromStartAddress(em_address) >= 0)
+			return;
+
+		if (blocks.IsFull() || trampolines.IsAlmostFull() || m_async_cache_full.TestAndClear() || m_clear_cache_asap)
+			ReclaimCodeSpace();
+
+		// Run the block in the interpreter until its code is ready.
+		if (m_async_queued.count(em_address) || QueueAsyncCompile(em_address, IsFirstTier(em_address)))
+		{
+			RunInterpreterBlock();
+			return;
+		}
 	}
 
+	std::lock_guard<std::recursive_mutex> lk(compile_lock);
+
+	if (SConfig::GetInstance().bJITNoBlockCache)
+		ClearCache();
+	else if (IsCodeRegionAlmostFull() || trampolines.IsAlmostFull() || blocks.IsFull() || m_clear_cache_asap)
+		ReclaimCodeSpace();
+
 	int blockSize = code_buffer.GetSize();
 
 	if (SConfig::GetInstance().bEnableDebugging)
 	{
 		// We can link blocks as long as we are not single stepping and there are no breakpoints here
 		EnableBlockLink();
-		EnableOptimization();
+		EnableOptimization(analyzer);
 
 		// Comment out the following to disable breakpoints (speed-up)
 		if (!Profiler::g_ProfileBlocks)
@@ -531,11 +741,16 @@ void Jit64::Jit(u32 em_address)
 				analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
 				analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
 				analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+				analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
 			}
 			Trace();
 		}
 	}
 
+	js.firstTier = IsFirstTier(em_address);
+	if (m_tiered_compile)
+		SetAnalyzerTier(analyzer, js.firstTier);
+
 	// Analyze the block, collect all instructions it is made of (including inlining,
 	// if that is enabled), reorder instructions for optimal performance, and join joinable instructions.
 	u32 nextPC = analyzer.Analyze(em_address, &code_block, &code_buffer, blockSize);
@@ -598,6 +813,22 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		// get start tic
 		PROFILER_QUERY_PERFORMANCE_COUNTER(&b->ticStart);
 	}
+	else if (js.firstTier)
+	{
+		// Count runs and have the block recompiled at the next tier once it's hot.
+		MOV(64, R(RSCRATCH), Imm64((u64)&b->runCount));
+		ADD(32, MatR(RSCRATCH), Imm8(1));
+		CMP(32, MatR(RSCRATCH), Imm32(m_hot_block_threshold));
+		FixupBranch hot = J_CC(CC_AE, true);
+		SwitchToFarCode();
+			SetJumpTarget(hot);
+			MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
+			ABI_PushRegistersAndAdjustStack({}, 0);
+			ABI_CallFunctionPC((void *)&Jit64::RecompileHotBlock, this, js.blockStart);
+			ABI_PopRegistersAndAdjustStack({}, 0);
+			JMP(asm_routines.dispatcherNoCheck, true);
+		SwitchToNearCode();
+	}
 #if defined(_DEBUG) || defined(DEBUGFAST) || defined(NAN_CHECK)
 	// should help logged stack-traces become more accurate
 	MOV(32, PPCSTATE(pc), Imm32(js.blockStart));
@@ -646,6 +877,9 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	}
 
 	// Translate instructions
+	b->debugEntries.clear();
+	const bool collect_debug_entries = JitRegister::IsEnabled();
+
 	for (u32 i = 0; i < code_block.m_num_instructions; i++)
 	{
 		js.compilerPC = ops[i].address;
@@ -659,6 +893,9 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 		js.revertGprLoad = -1;
 		js.revertFprLoad = -1;
 
+		if (collect_debug_entries)
+			b->debugEntries.push_back({GetCodePtr(), ops[i].address});
+
 		if (i == (code_block.m_num_instructions - 1))
 		{
 			if (Profiler::g_ProfileBlocks)
@@ -728,8 +965,19 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 					HLEFunction(function);
 					if (type == HLE::HLE_HOOK_REPLACE)
 					{
-						MOV(32, R(RSCRATCH), PPCSTATE(npc));
 						js.downcountAmount += js.st.numCycles;
+						if (jo.memcheck)
+						{
+							// The native routines return to their entry when they fault.
+							TEST(32, PPCSTATE(Exceptions), Imm32(EXCEPTION_DSI));
+							FixupBranch memException = J_CC(CC_NZ, true);
+							SwitchToFarCode();
+								SetJumpTarget(memException);
+								MOV(32, PPCSTATE(pc), Imm32(ops[i].address));
+								WriteExceptionExit();
+							SwitchToNearCode();
+						}
+						MOV(32, R(RSCRATCH), PPCSTATE(npc));
 						WriteExitDestInRSCRATCH();
 						break;
 					}
@@ -818,12 +1066,12 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 				SwitchToFarCode();
 					if (!js.fastmemLoadStore)
 					{
-						exceptionHandlerAtLoc[js.fastmemLoadStore] = nullptr;
+						m_emit_sites->exceptionHandlerAtLoc[js.fastmemLoadStore] = nullptr;
 						SetJumpTarget(js.fixupExceptionHandler ? js.exceptionHandler : memException);
 					}
 					else
 					{
-						exceptionHandlerAtLoc[js.fastmemLoadStore] = GetWritableCodePtr();
+						m_emit_sites->exceptionHandlerAtLoc[js.fastmemLoadStore] = GetWritableCodePtr();
 					}
 
 					BitSet32 gprToFlush = BitSet32::AllTrue(32);
@@ -874,7 +1122,7 @@ const u8* Jit64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitBloc
 	}
 
 	b->codeSize = (u32)(GetCodePtr() - start);
-	b->originalSize = code_block.m_num_instructions;
+	b->originalSize = code_block.m_span;
 
 #ifdef JIT_LOG_X86
 	LogGeneratedX86(code_block.m_num_instructions, code_buf, start, b);
@@ -903,10 +1151,78 @@ void Jit64::EnableBlockLink()
 		jo.enableBlocklink = false;
 }
 
-void Jit64::EnableOptimization()
+bool Jit64::IsFirstTier(u32 em_address) const
 {
-	analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
-	analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
-	analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
-	analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+	// The block profiler uses runCount too.
+	return m_tiered_compile && !Profiler::g_ProfileBlocks && !m_hot_blocks.count(em_address);
+}
+
+void Jit64::SetAnalyzerTier(PPCAnalyst::PPCAnalyzer& tier_analyzer, bool first_tier)
+{
+	if (!first_tier)
+	{
+		EnableOptimization(tier_analyzer);
+		if (m_trace_formation)
+			tier_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_TRACE);
+		return;
+	}
+
+	tier_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_TRACE);
+
+	// Merging and following branches costs analysis and regcache time that
+	// cold code doesn't make up for.
+	tier_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+	tier_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
+	tier_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
+	tier_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+	tier_analyzer.ClearOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
+}
+
+void Jit64::RecompileHotBlock(Jit64* self, u32 em_address)
+{
+	// Destroying the block unlinks its callers, they get linked to the new code
+	// once it's compiled. The caller jumps to the dispatcher right after this.
+	std::lock_guard<std::recursive_mutex> lk(self->compile_lock);
+	self->m_hot_blocks.insert(em_address);
+	int block_num = self->blocks.GetBlockNumberFromStartAddress(em_address);
+	if (block_num >= 0)
+	{
+		if (self->m_trace_formation)
+			self->RecordTakenBranches(*self->blocks.GetBlock(block_num));
+		self->blocks.InvalidateBlock(block_num);
+	}
+	self->statistics.hot_recompiles++;
+}
+
+void Jit64::RecordTakenBranches(const JitBlock& b)
+{
+	// Exits are recorded in code order, so the number of times an exit's
+	// instruction was reached is the run count minus the earlier exits taken.
+	// Exception exits aren't counted, which only makes this a bit optimistic.
+	u64 reached = static_cast<u32>(b.runCount);
+	for (const JitBlock::LinkData& e : b.linkData)
+	{
+		if (!e.exitCount)
+			continue;
+
+		u64 taken = std::min<u64>(*e.exitCount, reached);
+		// The fall-through exit of a branch that ends the block isn't a taken branch.
+		if (e.exitAddress != e.exitFrom + 4 && taken * 2 > reached)
+		{
+			if (m_taken_branches.insert(e.exitFrom).second)
+				statistics.hot_taken_branches++;
+		}
+		reached -= taken;
+	}
+}
+
+void Jit64::EnableOptimization(PPCAnalyst::PPCAnalyzer& optimized_analyzer)
+{
+	optimized_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+	optimized_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_BRANCH_MERGE);
+	optimized_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CROR_MERGE);
+	optimized_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CARRY_MERGE);
+	// Dropped instructions would skip their breakpoints.
+	if (!SConfig::GetInstance().bEnableDebugging)
+		optimized_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
 }
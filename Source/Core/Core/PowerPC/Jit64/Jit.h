@@ -18,6 +18,16 @@
 // ----------
 #pragma once
 
+#include <array>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include "Common/Event.h"
+#include "Common/Flag.h"
 #include "Common/x64ABI.h"
 #include "Common/x64Analyzer.h"
 #include "Common/x64Emitter.h"
@@ -54,13 +64,83 @@ private:
 	bool m_clear_cache_asap;
 	u8* m_stack;
 
+	// Tiered compilation: blocks are compiled with a cheap analysis first and
+	// recompiled with all optimizations once they've run often enough.
+	bool IsFirstTier(u32 em_address) const;
+	void SetAnalyzerTier(PPCAnalyst::PPCAnalyzer& tier_analyzer, bool first_tier);
+	static void RecompileHotBlock(Jit64* self, u32 em_address);
+
+	bool m_tiered_compile = false;
+	u32 m_hot_block_threshold = 0;
+	std::unordered_set<u32> m_hot_blocks;
+
+	// Trace formation: first tier blocks count how often each of their exits is
+	// taken, and the hot recompile follows the branches that usually are.
+	bool m_trace_formation = false;
+	std::unordered_set<u32> m_taken_branches;
+	void RecordTakenBranches(const JitBlock& b);
+
+	// The code space is split into regions that are filled one at a time. When
+	// the current one runs out, the least recently executed region is evicted
+	// and reused, so that only the blocks in it have to be recompiled.
+	static const int NUM_CODE_REGIONS = 8;
+	struct CodeRegion
+	{
+		u8* near_start;
+		u8* near_end;
+		u8* far_start;
+		u8* far_end;
+		u64 last_used;
+		bool used;
+		u32 generation;
+	};
+
+	void InitCodeRegions();
+	void ResetCodeRegions();
+	bool IsCodeRegionAlmostFull() const;
+	int GetCodeRegion(const u8* ptr) const;
+	bool EvictCodeRegion();
+	void ReclaimCodeSpace();
+	static void SampleCodeRegionUse();
+
+	std::array<CodeRegion, NUM_CODE_REGIONS> m_code_regions;
+	int m_current_region = 0;
+	u64 m_region_clock = 0;
+
+	// Background compilation, see JitAsync.cpp.
+	struct AsyncCompile;
+
+	void StartAsyncCompiler();
+	void StopAsyncCompiler();
+	bool QueueAsyncCompile(u32 em_address, bool first_tier);
+	void InstallAsyncCompiles();
+	void AsyncCompilerThread();
+	void RunInterpreterBlock();
+
+	bool m_async_compile = false;
+	// The block cache generation m_async_queued belongs to.
+	u32 m_async_generation = 0;
+	std::unordered_set<u32> m_async_queued;
+	std::vector<std::unique_ptr<AsyncCompile>> m_async_free;
+	// Analyzes the queued blocks on the CPU thread. The compiler thread reads
+	// the options of analyzer while it emits, and sets them for each request.
+	PPCAnalyst::PPCAnalyzer m_async_analyzer;
+
+	std::thread m_async_thread;
+	std::mutex m_async_queue_lock;
+	std::deque<std::unique_ptr<AsyncCompile>> m_async_queue;
+	std::deque<std::unique_ptr<AsyncCompile>> m_async_done;
+	Common::Event m_async_work;
+	Common::Flag m_async_exiting;
+	Common::Flag m_async_cache_full;
+
 public:
-	Jit64() : code_buffer(32000) {}
-	~Jit64() {}
+	Jit64();
+	~Jit64();
 
 	void Init() override;
 
-	void EnableOptimization();
+	void EnableOptimization(PPCAnalyst::PPCAnalyzer& optimized_analyzer);
 
 	void EnableBlockLink();
 
@@ -103,6 +183,7 @@ public:
 	void WriteBLRExit();
 	void WriteExceptionExit();
 	void WriteExternalExceptionExit();
+	void WriteIdleExit(u32 destination);
 	void WriteRfiExitDestInRSCRATCH();
 	bool Cleanup();
 
@@ -44,6 +44,8 @@ void Jit64AsmRoutineManager::Generate()
 
 	const u8* outerLoop = GetCodePtr();
 		ABI_PushRegistersAndAdjustStack({}, 0);
+		if (m_slice_hook)
+			ABI_CallFunction(reinterpret_cast<void *>(m_slice_hook));
 		ABI_CallFunction(reinterpret_cast<void *>(&CoreTiming::Advance));
 		ABI_PopRegistersAndAdjustStack({}, 0);
 		FixupBranch skipToRealDispatch = J(SConfig::GetInstance().bEnableDebugging); //skip the sync and compare first time
@@ -189,9 +191,15 @@ void Jit64AsmRoutineManager::Generate()
 			// Jit might have cleared the code cache
 			ResetStack();
 
+			// Jit might also have interpreted the block while it's being compiled
+			// in the background, so the downcount has to be checked again.
+			CMP(32, PPCSTATE(downcount), Imm8(0));
+			FixupBranch interpreted_timing = J_CC(CC_LE, true);
+
 			JMP(dispatcherNoCheck, true); // no point in special casing this
 
 		SetJumpTarget(bail);
+		SetJumpTarget(interpreted_timing);
 		doTiming = GetCodePtr();
 
 		// Test external exceptions.
@@ -27,11 +27,15 @@ private:
 	void ResetStack();
 	void GenerateCommon();
 	u8* m_stack_top;
+	void (*m_slice_hook)();
 
 public:
-	void Init(u8* stack_top)
+	// slice_hook, if set, is called at the end of every timeslice, right before
+	// CoreTiming::Advance.
+	void Init(u8* stack_top, void (*slice_hook)() = nullptr)
 	{
 		m_stack_top = stack_top;
+		m_slice_hook = slice_hook;
 		// NOTE: When making large additions to the AsmCommon code, you might
 		// want to ensure this number is big enough.
 		AllocCodeSpace(16384);
@@ -0,0 +1,280 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+// Background block compilation for Jit64.
+//
+// When a block misses in the dispatcher, the CPU thread analyzes it (the
+// analyzer reads guest memory, which is only consistent on the CPU thread),
+// reserves a pending block for it and hands the emission work to a compiler
+// thread. The block is then run through the interpreter until the compiled
+// code is installed by the CPU thread on a later dispatcher miss.
+//
+// There is a single compiler thread, since all blocks are emitted into the
+// same code space and the register caches and JitState are per JIT instance.
+// Everything that emits or patches code, or changes what the compiler thread
+// reads (the exits and blocks of the block cache, the exception address sets),
+// holds compile_lock. The fault handler doesn't, so everything it uses is only
+// changed on the CPU thread.
+
+#include <cinttypes>
+#include <mutex>
+#include <utility>
+
+#include "Common/CommonTypes.h"
+#include "Common/Thread.h"
+#include "Common/Timer.h"
+#include "Common/Logging/Log.h"
+
+#include "Core/ConfigManager.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+
+struct Jit64::AsyncCompile
+{
+	AsyncCompile() : code_buffer(32000) {}
+
+	u32 address;
+	u32 next_pc;
+	int block_num;
+	u32 generation;
+	u64 queued_us;
+	bool first_tier;
+	u32 analyzer_options;
+
+	// Written by the compiler thread, nullptr if the block wasn't compiled.
+	const u8* entry;
+	int region;
+	u32 region_generation;
+
+	PPCAnalyst::CodeBlock code_block;
+	PPCAnalyst::BlockStats st;
+	PPCAnalyst::BlockRegStats gpa;
+	PPCAnalyst::BlockRegStats fpa;
+	PPCAnalyst::CodeBuffer code_buffer;
+
+	// Filled in by the compiler thread, merged into m_fastmem_sites on install.
+	FastmemSites fastmem_sites;
+};
+
+Jit64::Jit64() : code_buffer(32000)
+{
+}
+
+Jit64::~Jit64()
+{
+}
+
+void Jit64::StartAsyncCompiler()
+{
+	m_async_compile = SConfig::GetInstance().bJITAsyncCompile &&
+	                  !SConfig::GetInstance().bEnableDebugging &&
+	                  !SConfig::GetInstance().bJITNoBlockCache;
+	if (!m_async_compile)
+		return;
+
+	m_async_generation = blocks.GetGeneration();
+	m_async_exiting.Clear();
+	m_async_cache_full.Clear();
+	m_async_thread = std::thread(&Jit64::AsyncCompilerThread, this);
+}
+
+void Jit64::StopAsyncCompiler()
+{
+	if (!m_async_compile)
+		return;
+
+	m_async_exiting.Set();
+	m_async_work.Set();
+	m_async_thread.join();
+	m_async_compile = false;
+
+	m_async_queue.clear();
+	m_async_done.clear();
+	m_async_queued.clear();
+	m_async_free.clear();
+
+	NOTICE_LOG(DYNA_REC, "Background compilation: %" PRIu64 " blocks installed, %" PRIu64 " dropped, "
+	           "%" PRIu64 " us average / %" PRIu64 " us worst time to native code",
+	           statistics.async_compiles, statistics.async_compiles_dropped,
+	           statistics.async_compiles ? statistics.time_to_native_us_total / statistics.async_compiles : 0,
+	           statistics.time_to_native_us_max);
+	statistics.compile_queue_depth = 0;
+}
+
+bool Jit64::QueueAsyncCompile(u32 em_address, bool first_tier)
+{
+	std::unique_ptr<AsyncCompile> request;
+	if (m_async_free.empty())
+	{
+		request.reset(new AsyncCompile());
+	}
+	else
+	{
+		request = std::move(m_async_free.back());
+		m_async_free.pop_back();
+	}
+
+	request->code_block.m_stats = &request->st;
+	request->code_block.m_gpa = &request->gpa;
+	request->code_block.m_fpa = &request->fpa;
+
+	SetAnalyzerTier(m_async_analyzer, first_tier);
+	u32 next_pc = m_async_analyzer.Analyze(em_address, &request->code_block, &request->code_buffer,
+	                               request->code_buffer.GetSize());
+	if (request->code_block.m_memory_exception)
+	{
+		// Let the synchronous path raise the ISI.
+		m_async_free.push_back(std::move(request));
+		return false;
+	}
+
+	request->address = em_address;
+	request->next_pc = next_pc;
+	request->generation = blocks.GetGeneration();
+	request->queued_us = Common::Timer::GetTimeUs();
+	request->first_tier = first_tier;
+	request->analyzer_options = m_async_analyzer.GetOptions();
+	request->entry = nullptr;
+	request->fastmem_sites.Clear();
+	request->block_num = blocks.AllocatePendingBlock(em_address, request->code_block.m_span);
+
+	m_async_queued.insert(em_address);
+	statistics.compile_queue_depth++;
+
+	{
+		std::lock_guard<std::mutex> lk(m_async_queue_lock);
+		m_async_queue.push_back(std::move(request));
+	}
+	m_async_work.Set();
+	return true;
+}
+
+void Jit64::InstallAsyncCompiles()
+{
+	// The block cache can also be cleared without going through ClearCache.
+	if (m_async_generation != blocks.GetGeneration())
+	{
+		m_async_generation = blocks.GetGeneration();
+		m_async_queued.clear();
+	}
+
+	std::deque<std::unique_ptr<AsyncCompile>> done;
+	{
+		std::lock_guard<std::mutex> lk(m_async_queue_lock);
+		done.swap(m_async_done);
+	}
+	if (done.empty())
+		return;
+
+	// Linking patches code the compiler thread may be reading the exits of.
+	std::lock_guard<std::recursive_mutex> lk(compile_lock);
+
+	for (auto& request : done)
+	{
+		statistics.compile_queue_depth--;
+
+		// A cache clear in the meantime throws away both the block number and
+		// the code the request refers to, evicting its code region only the code.
+		bool current = request->generation == m_async_generation;
+		if (current)
+			m_async_queued.erase(request->address);
+
+		if (!current || !request->entry || blocks.GetBlock(request->block_num)->invalid ||
+		    m_code_regions[request->region].generation != request->region_generation)
+		{
+			statistics.async_compiles_dropped++;
+			if (current)
+				blocks.DiscardPendingBlock(request->block_num);
+		}
+		else
+		{
+			u64 time_to_native = Common::Timer::GetTimeUs() - request->queued_us;
+			statistics.time_to_native_us_total += time_to_native;
+			if (time_to_native > statistics.time_to_native_us_max)
+				statistics.time_to_native_us_max = time_to_native;
+			statistics.async_compiles++;
+
+			m_fastmem_sites.Merge(request->fastmem_sites);
+			blocks.FinalizeBlock(request->block_num, jo.enableBlocklink, request->entry);
+		}
+
+		m_async_free.push_back(std::move(request));
+	}
+}
+
+void Jit64::RunInterpreterBlock()
+{
+	Interpreter* const interpreter = Interpreter::getInstance();
+
+	Interpreter::m_EndBlock = false;
+	int cycles = 0;
+	while (!Interpreter::m_EndBlock)
+		cycles += interpreter->SingleStepInner();
+	PowerPC::ppcState.downcount -= cycles;
+}
+
+void Jit64::AsyncCompilerThread()
+{
+	Common::SetCurrentThreadName("JIT compiler");
+
+	while (true)
+	{
+		m_async_work.Wait();
+
+		while (!m_async_exiting.IsSet())
+		{
+			std::unique_ptr<AsyncCompile> request;
+			{
+				std::lock_guard<std::mutex> lk(m_async_queue_lock);
+				if (m_async_queue.empty())
+					break;
+				request = std::move(m_async_queue.front());
+				m_async_queue.pop_front();
+			}
+
+			{
+				std::lock_guard<std::recursive_mutex> lk(compile_lock);
+
+				if (request->generation != blocks.GetGeneration())
+				{
+					// Stale, the CPU thread drops it.
+				}
+				else if (IsCodeRegionAlmostFull())
+				{
+					// Only the CPU thread may clear the cache.
+					m_async_cache_full.Set();
+				}
+				else
+				{
+					code_block = request->code_block;
+					code_block.m_stats = &js.st;
+					code_block.m_gpa = &js.gpa;
+					code_block.m_fpa = &js.fpa;
+					js.st = request->st;
+					js.gpa = request->gpa;
+					js.fpa = request->fpa;
+					js.firstTier = request->first_tier;
+					// DoJit emits merged branches and followed exits the way the
+					// block was analyzed.
+					analyzer.SetOptions(request->analyzer_options);
+
+					request->region = m_current_region;
+					request->region_generation = m_code_regions[m_current_region].generation;
+					// The fault handler reads m_fastmem_sites without locking.
+					m_emit_sites = &request->fastmem_sites;
+					request->entry = DoJit(request->address, &request->code_buffer,
+					                       blocks.GetBlock(request->block_num), request->next_pc);
+					m_emit_sites = &m_fastmem_sites;
+				}
+			}
+
+			std::lock_guard<std::mutex> lk(m_async_queue_lock);
+			m_async_done.push_back(std::move(request));
+		}
+
+		if (m_async_exiting.IsSet())
+			return;
+	}
+}
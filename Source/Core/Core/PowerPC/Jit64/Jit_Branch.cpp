@@ -84,11 +84,13 @@ void Jit64::bx(UGeckoInstruction inst)
 	if (inst.LK)
 		AND(32, PPCSTATE(cr), Imm32(~(0xFF000000)));
 #endif
+	if (js.op->branchIsIdleLoop)
+	{
+		WriteIdleExit(destination);
+		return;
+	}
 	if (destination == js.compilerPC)
 	{
-		//PanicAlert("Idle loop detected at %08x", destination);
-		// CALL(ProtectFunction(&CoreTiming::Idle, 0));
-		// JMP(Asm::testExceptions, true);
 		// make idle loops go faster
 		js.downcountAmount += 8;
 	}
@@ -122,6 +124,21 @@ void Jit64::bcx(UGeckoInstruction inst)
 		                                        !(inst.BO_2 & BO_BRANCH_IF_TRUE));
 	}
 
+	if (js.op->branchFollowed)
+	{
+		// The block continues at the branch target, not branching is the exit.
+		SwitchToFarCode();
+			if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
+				SetJumpTarget(pConditionDontBranch);
+			if ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0)
+				SetJumpTarget(pCTRDontBranch);
+			gpr.Flush(FLUSH_MAINTAIN_STATE);
+			fpr.Flush(FLUSH_MAINTAIN_STATE);
+			WriteExit(js.compilerPC + 4);
+		SwitchToNearCode();
+		return;
+	}
+
 	if (inst.LK)
 		MOV(32, PPCSTATE_LR, Imm32(js.compilerPC + 4));
 
@@ -133,7 +150,10 @@ void Jit64::bcx(UGeckoInstruction inst)
 
 	gpr.Flush(FLUSH_MAINTAIN_STATE);
 	fpr.Flush(FLUSH_MAINTAIN_STATE);
-	WriteExit(destination, inst.LK, js.compilerPC + 4);
+	if (js.op->branchIsIdleLoop)
+		WriteIdleExit(destination);
+	else
+		WriteExit(destination, inst.LK, js.compilerPC + 4);
 
 	if ((inst.BO & BO_DONT_CHECK_CONDITION) == 0)
 		SetJumpTarget(pConditionDontBranch);
@@ -227,8 +227,19 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 	               jit->js.op->fprIsDuplicated[b] &&
 	               jit->js.op->fprIsDuplicated[c]);
 
+	// While we don't know if any games are actually affected (replays seem to work with all the usual
+	// suspects for desyncing), netplay and other applications need absolute perfect determinism, so
+	// be extra careful and don't use FMA, even if in theory it might be okay.
+	// Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
+	// to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
+	// instances on different computers giving identical results.
+	bool use_fma = cpu_info.bFMA && !Core::g_want_determinism;
+
 	fpr.Lock(a, b, c, d);
 
+	// The (rounded) multiplicand. Without FMA, the multiply can read c directly
+	// when it doesn't need rounding, which saves a copy with AVX.
+	OpArg c_arg = R(XMM1);
 	switch(inst.SUBOP5)
 	{
 	case 14:
@@ -242,23 +253,20 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 			Force25BitPrecision(XMM1, R(XMM1), XMM0);
 		break;
 	default:
-		bool special = inst.SUBOP5 == 30 && (!cpu_info.bFMA || Core::g_want_determinism);
-		X64Reg tmp1 = special ? XMM0 : XMM1;
-		X64Reg tmp2 = special ? XMM1 : XMM0;
 		if (single && round_input)
-			Force25BitPrecision(tmp1, fpr.R(c), tmp2);
+			Force25BitPrecision(XMM1, fpr.R(c), XMM0);
+		else if (use_fma)
+		{
+			MOVAPD(XMM1, fpr.R(c));
+		}
 		else
-			MOVAPD(tmp1, fpr.R(c));
+		{
+			c_arg = fpr.R(c);
+		}
 		break;
 	}
 
-	// While we don't know if any games are actually affected (replays seem to work with all the usual
-	// suspects for desyncing), netplay and other applications need absolute perfect determinism, so
-	// be extra careful and don't use FMA, even if in theory it might be okay.
-	// Note that FMA isn't necessarily less correct (it may actually be closer to correct) compared
-	// to what the Gekko does here; in deterministic mode, the important thing is multiple Dolphin
-	// instances on different computers giving identical results.
-	if (cpu_info.bFMA && !Core::g_want_determinism)
+	if (use_fma)
 	{
 		// Statistics suggests b is a lot less likely to be unbound in practice, so
 		// if we have to pick one of a or b to bind, let's make it b.
@@ -297,40 +305,28 @@ void Jit64::fmaddXX(UGeckoInstruction inst)
 			break;
 		}
 	}
-	else if (inst.SUBOP5 == 30) //nmsub
-	{
-		// We implement nmsub a little differently ((b - a*c) instead of -(a*c - b)), so handle it separately.
-		MOVAPD(XMM1, fpr.R(b));
-		if (packed)
-		{
-			MULPD(XMM0, fpr.R(a));
-			SUBPD(XMM1, R(XMM0));
-		}
-		else
-		{
-			MULSD(XMM0, fpr.R(a));
-			SUBSD(XMM1, R(XMM0));
-		}
-	}
 	else
 	{
 		if (packed)
 		{
-			MULPD(XMM1, fpr.R(a));
-			if (inst.SUBOP5 == 28) //msub
+			avx_op(&XEmitter::VMULPD, &XEmitter::MULPD, XMM1, c_arg, fpr.R(a), true, true);
+			if (inst.SUBOP5 == 28 || inst.SUBOP5 == 30) //(n)msub
 				SUBPD(XMM1, fpr.R(b));
-			else                   //(n)madd(s[01])
+			else                                        //(n)madd(s[01])
 				ADDPD(XMM1, fpr.R(b));
 		}
 		else
 		{
-			MULSD(XMM1, fpr.R(a));
-			if (inst.SUBOP5 == 28)
+			avx_op(&XEmitter::VMULSD, &XEmitter::MULSD, XMM1, c_arg, fpr.R(a), true, true);
+			if (inst.SUBOP5 == 28 || inst.SUBOP5 == 30)
 				SUBSD(XMM1, fpr.R(b));
 			else
 				ADDSD(XMM1, fpr.R(b));
 		}
-		if (inst.SUBOP5 == 31) //nmadd
+		// Negating the result rather than computing b - a*c for nmsub keeps the
+		// sign of zero results, and the rounding in directed modes, the same as
+		// the interpreter.
+		if (inst.SUBOP5 == 30 || inst.SUBOP5 == 31) //n(madd|msub)
 			PXOR(XMM1, M(packed ? psSignBits2 : psSignBits));
 	}
 	fpr.BindToRegister(d, !single);
@@ -403,7 +399,11 @@ void Jit64::fselx(UGeckoInstruction inst)
 	else
 		CMPSD(XMM0, fpr.R(a), CMP_NLE);
 
-	if (cpu_info.bSSE4_1)
+	if (cpu_info.bAVX && fpr.R(c).IsSimpleReg())
+	{
+		VBLENDVPD(XMM1, fpr.RX(c), fpr.R(b), XMM0);
+	}
+	else if (cpu_info.bSSE4_1)
 	{
 		MOVAPD(XMM1, fpr.R(c));
 		BLENDVPD(XMM1, fpr.R(b));
@@ -334,6 +334,10 @@ bool Jit64::CheckMergedBranch(int crf)
 	if (!MergeAllowedNextInstructions(1))
 		return false;
 
+	// Followed branches don't exit when taken, bcx handles them.
+	if (js.op[1].branchFollowed)
+		return false;
+
 	const UGeckoInstruction& next = js.op[1].inst;
 	return (((next.OPCD == 16 /* bcx */) ||
 	        ((next.OPCD == 19) && (next.SUBOP10 == 528) /* bcctrx */) ||
@@ -358,7 +362,10 @@ void Jit64::DoMergedBranch()
 			destination = SignExt16(next.BD << 2);
 		else
 			destination = nextPC + SignExt16(next.BD << 2);
-		WriteExit(destination, next.LK, nextPC + 4);
+		if (js.op[1].branchIsIdleLoop)
+			WriteIdleExit(destination);
+		else
+			WriteExit(destination, next.LK, nextPC + 4);
 	}
 	else if ((next.OPCD == 19) && (next.SUBOP10 == 528)) // bcctrx
 	{
@@ -105,54 +105,6 @@ void Jit64::lXXx(UGeckoInstruction inst)
 		signExtend = true;
 	}
 
-	// TODO(ector): Make it dynamically enable/disable idle skipping where appropriate
-	// Will give nice boost to dual core mode
-	// (mb2): I agree,
-	// IMHO those Idles should always be skipped and replaced by a more controllable "native" Idle methode
-	// ... maybe the throttle one already do that :p
-	// TODO: We shouldn't use a debug read here.  It should be possible to get
-	// the following instructions out of the JIT state.
-	if (SConfig::GetInstance().bSkipIdle &&
-	    PowerPC::GetState() != PowerPC::CPU_STEPPING &&
-	    inst.OPCD == 32 &&
-	    MergeAllowedNextInstructions(2) &&
-	    (inst.hex & 0xFFFF0000) == 0x800D0000 &&
-	    (js.op[1].inst.hex == 0x28000000 ||
-	    (SConfig::GetInstance().bWii && js.op[1].inst.hex == 0x2C000000)) &&
-	    js.op[2].inst.hex == 0x4182fff8)
-	{
-		// TODO(LinesPrower):
-		// - Rewrite this!
-		// It seems to be ugly and inefficient, but I don't know JIT stuff enough to make it right
-		// It only demonstrates the idea
-
-		// do our job at first
-		s32 offset = (s32)(s16)inst.SIMM_16;
-		gpr.BindToRegister(a, true, false);
-		gpr.BindToRegister(d, false, true);
-		SafeLoadToReg(gpr.RX(d), gpr.R(a), accessSize, offset, CallerSavedRegistersInUse(), signExtend);
-
-		// if it's still 0, we can wait until the next event
-		TEST(32, gpr.R(d), gpr.R(d));
-		FixupBranch noIdle = J_CC(CC_NZ);
-
-		BitSet32 registersInUse = CallerSavedRegistersInUse();
-		ABI_PushRegistersAndAdjustStack(registersInUse, 0);
-
-		ABI_CallFunction((void *)&CoreTiming::Idle);
-
-		ABI_PopRegistersAndAdjustStack(registersInUse, 0);
-
-		// ! we must continue executing of the loop after exception handling, maybe there is still 0 in r0
-		//MOV(32, PPCSTATE(pc), Imm32(js.compilerPC));
-		WriteExceptionExit();
-
-		SetJumpTarget(noIdle);
-
-		//js.compilerPC += 8;
-		return;
-	}
-
 	// Determine whether this instruction updates inst.RA
 	bool update;
 	if (inst.OPCD == 31)
@@ -184,9 +136,9 @@ void Jit64::lXXx(UGeckoInstruction inst)
 	}
 	else
 	{
-		if ((inst.OPCD != 31) && gpr.R(a).IsImm() && !jo.memcheck)
+		if ((inst.OPCD != 31) && (gpr.R(a).IsImm() || js.op->hasConstantAddress) && !jo.memcheck)
 		{
-			u32 val = gpr.R(a).Imm32() + inst.SIMM_16;
+			u32 val = js.op->hasConstantAddress ? js.op->constantAddress : gpr.R(a).Imm32() + inst.SIMM_16;
 			opAddress = Imm32(val);
 			if (update)
 				gpr.SetImmediate32(a, val);
@@ -452,9 +404,9 @@ void Jit64::stX(UGeckoInstruction inst)
 	}
 
 	// If we already know the address of the write
-	if (!a || gpr.R(a).IsImm())
+	if (!a || gpr.R(a).IsImm() || js.op->hasConstantAddress)
 	{
-		u32 addr = (a ? gpr.R(a).Imm32() : 0) + offset;
+		u32 addr = js.op->hasConstantAddress ? js.op->constantAddress : (a ? gpr.R(a).Imm32() : 0) + offset;
 		bool exception = WriteToConstAddress(accessSize, gpr.R(s), addr, CallerSavedRegistersInUse());
 		if (update)
 		{
@@ -355,9 +355,12 @@ void JitIL::WriteExit(u32 destination)
 	JitBlock *b = js.curBlock;
 	JitBlock::LinkData linkData;
 	linkData.exitAddress = destination;
-	linkData.exitPtrs = GetWritableCodePtr();
 	linkData.linkStatus = false;
 
+	// pc is set even if the exit gets linked, see JitBlockCache::WriteUnlinkBlock.
+	MOV(32, PPCSTATE(pc), Imm32(destination));
+	linkData.exitPtrs = GetWritableCodePtr();
+
 	// Link opportunity!
 	int block;
 	if (jo.enableBlocklink && (block = blocks.GetBlockNumberFromStartAddress(destination)) >= 0)
@@ -368,7 +371,6 @@ void JitIL::WriteExit(u32 destination)
 	}
 	else
 	{
-		MOV(32, PPCSTATE(pc), Imm32(destination));
 		JMP(asm_routines.dispatcher, true);
 	}
 	b->linkData.push_back(linkData);
@@ -4,6 +4,7 @@
 
 #include "Common/Arm64Emitter.h"
 #include "Common/Common.h"
+#include "Common/JitRegister.h"
 #include "Common/PerformanceCounter.h"
 
 #include "Core/PatchEngine.h"
@@ -45,6 +46,10 @@ void JitArm64::Init()
 	code_block.m_gpa = &js.gpa;
 	code_block.m_fpa = &js.fpa;
 	analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+	if (!SConfig::GetInstance().bEnableDebugging)
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
+	if (SConfig::GetInstance().bSkipIdle)
+		analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
 
 	m_supports_cycle_counter = HasCycleCounters();
 }
@@ -239,6 +244,19 @@ void JitArm64::WriteExceptionExit()
 	gpr.Unlock(WA);
 }
 
+// Taken branch of a busy wait loop: skip to the next event instead of
+// spinning until it.
+void JitArm64::WriteIdleExit(u32 destination)
+{
+	MOVI2R(W0, destination);
+	MOVI2R(X30, (u64)&CoreTiming::IdleLoop);
+	BLR(X30);
+
+	ARM64Reg WA = gpr.GetReg();
+	MOVI2R(WA, destination);
+	WriteExceptionExit(WA);
+}
+
 void JitArm64::WriteExternalExceptionExit(ARM64Reg dest)
 {
 	STR(INDEX_UNSIGNED, dest, X29, PPCSTATE_OFF(pc));
@@ -472,6 +490,9 @@ const u8* JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitB
 		js.downcountAmount += PatchEngine::GetSpeedhackCycles(em_address);
 
 	// Translate instructions
+	b->debugEntries.clear();
+	const bool collect_debug_entries = JitRegister::IsEnabled();
+
 	for (u32 i = 0; i < code_block.m_num_instructions; i++)
 	{
 		js.compilerPC = ops[i].address;
@@ -480,6 +501,9 @@ const u8* JitArm64::DoJit(u32 em_address, PPCAnalyst::CodeBuffer *code_buf, JitB
 		const GekkoOPInfo *opinfo = ops[i].opinfo;
 		js.downcountAmount += opinfo->numCycles;
 
+		if (collect_debug_entries)
+			b->debugEntries.push_back({GetCodePtr(), ops[i].address});
+
 		if (i == (code_block.m_num_instructions - 1))
 		{
 			// WARNING - cmp->branch merging will screw this up.
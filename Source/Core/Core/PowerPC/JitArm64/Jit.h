@@ -283,6 +283,7 @@ private:
 	void WriteExit(u32 destination);
 	void WriteExceptionExit(Arm64Gen::ARM64Reg dest);
 	void WriteExceptionExit();
+	void WriteIdleExit(u32 destination);
 	void WriteExternalExceptionExit(ARM64Reg dest);
 	void WriteExitDestInR(Arm64Gen::ARM64Reg dest);
 
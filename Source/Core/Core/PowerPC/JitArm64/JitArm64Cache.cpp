@@ -35,3 +35,8 @@ void JitArm64BlockCache::WriteDestroyBlock(const u8* location, u32 address)
 	emit.FlushIcache();
 }
 
+void JitArm64BlockCache::WriteUnlinkBlock(u8* location, u32 address)
+{
+	// The exit had room for the unlinked code in JitArm64::WriteExit.
+	WriteDestroyBlock(location, address);
+}
@@ -14,4 +14,5 @@ class JitArm64BlockCache : public JitBaseBlockCache
 private:
 	void WriteLinkBlock(u8* location, const u8* address);
 	void WriteDestroyBlock(const u8* location, u32 address);
+	void WriteUnlinkBlock(u8* location, u32 address);
 };
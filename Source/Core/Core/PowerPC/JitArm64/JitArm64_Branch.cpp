@@ -100,16 +100,10 @@ void JitArm64::bx(UGeckoInstruction inst)
 		gpr.Unlock(WA);
 	}
 
-	if (destination == js.compilerPC)
+	if (js.op->branchIsIdleLoop)
 	{
-		// make idle loops go faster
-		ARM64Reg WA = gpr.GetReg();
-		ARM64Reg XA = EncodeRegTo64(WA);
-
-		MOVI2R(XA, (u64)&CoreTiming::Idle);
-		BLR(XA);
-		MOVI2R(WA, js.compilerPC);
-		WriteExceptionExit(WA);
+		WriteIdleExit(destination);
+		return;
 	}
 
 	WriteExit(destination);
@@ -163,7 +157,10 @@ void JitArm64::bcx(UGeckoInstruction inst)
 	gpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
 	fpr.Flush(FlushMode::FLUSH_MAINTAIN_STATE);
 
-	WriteExit(destination);
+	if (js.op->branchIsIdleLoop)
+		WriteIdleExit(destination);
+	else
+		WriteExit(destination);
 
 	SwitchToNearCode();
 
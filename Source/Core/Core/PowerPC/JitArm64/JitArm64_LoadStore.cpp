@@ -52,6 +52,11 @@ void JitArm64::SafeLoadToReg(u32 dest, s32 addr, s32 offsetReg, u32 flags, s32 o
 				is_immediate = true;
 				imm_addr = gpr.GetImm(addr) + offset;
 			}
+			else if (js.op->hasConstantAddress)
+			{
+				is_immediate = true;
+				imm_addr = js.op->constantAddress;
+			}
 			else
 			{
 				if (offset >= 0 && offset < 4096)
@@ -201,6 +206,11 @@ void JitArm64::SafeStoreFromReg(s32 dest, u32 value, s32 regOffset, u32 flags, s
 				is_immediate = true;
 				imm_addr = gpr.GetImm(dest) + offset;
 			}
+			else if (js.op->hasConstantAddress)
+			{
+				is_immediate = true;
+				imm_addr = js.op->constantAddress;
+			}
 			else
 			{
 				if (offset >= 0 && offset < 4096)
@@ -439,41 +449,6 @@ void JitArm64::lXX(UGeckoInstruction inst)
 	}
 
 	SafeLoadToReg(d, update ? a : (a ? a : -1), offsetReg, flags, offset, update);
-
-	// LWZ idle skipping
-	if (SConfig::GetInstance().bSkipIdle &&
-	    inst.OPCD == 32 &&
-	    (inst.hex & 0xFFFF0000) == 0x800D0000 &&
-	    (PowerPC::HostRead_U32(js.compilerPC + 4) == 0x28000000 ||
-	    (SConfig::GetInstance().bWii && PowerPC::HostRead_U32(js.compilerPC + 4) == 0x2C000000)) &&
-	    PowerPC::HostRead_U32(js.compilerPC + 8) == 0x4182fff8)
-	{
-		// if it's still 0, we can wait until the next event
-		FixupBranch noIdle = CBNZ(gpr.R(d));
-
-		FixupBranch far = B();
-		SwitchToFarCode();
-		SetJumpTarget(far);
-
-		gpr.Flush(FLUSH_MAINTAIN_STATE);
-		fpr.Flush(FLUSH_MAINTAIN_STATE);
-
-		ARM64Reg WA = gpr.GetReg();
-		ARM64Reg XA = EncodeRegTo64(WA);
-
-		MOVI2R(XA, (u64)&CoreTiming::Idle);
-		BLR(XA);
-
-		gpr.Unlock(WA);
-		WriteExceptionExit();
-
-		SwitchToNearCode();
-
-		SetJumpTarget(noIdle);
-
-		//js.compilerPC += 8;
-		return;
-	}
 }
 
 void JitArm64::stX(UGeckoInstruction inst)
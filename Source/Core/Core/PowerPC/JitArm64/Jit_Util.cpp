@@ -117,6 +117,10 @@ public:
 	{
 		CallLambda(8 * sizeof (T), lambda);
 	}
+	virtual void VisitPure(T (*func)(u32), const std::function<T(u32)>* lambda)
+	{
+		CallFunction(8 * sizeof (T), reinterpret_cast<const void*>(func));
+	}
 
 private:
 
@@ -191,6 +195,24 @@ private:
 			m_emit->UBFM(m_dst_reg, W0, 0, sbits - 1);
 	}
 
+	void CallFunction(int sbits, const void* func)
+	{
+		ARM64FloatEmitter float_emit(m_emit);
+
+		m_emit->ABI_PushRegisters(m_gprs_in_use);
+		float_emit.ABI_PushRegisters(m_fprs_in_use, X1);
+			m_emit->MOVI2R(W0, m_address);
+			m_emit->MOVI2R(X30, (u64)func);
+			m_emit->BLR(X30);
+		float_emit.ABI_PopRegisters(m_fprs_in_use, X1);
+		m_emit->ABI_PopRegisters(m_gprs_in_use);
+
+		if (m_sign_extend)
+			m_emit->SBFM(m_dst_reg, W0, 0, sbits - 1);
+		else
+			m_emit->UBFM(m_dst_reg, W0, 0, sbits - 1);
+	}
+
 	ARM64XEmitter* m_emit;
 	BitSet32 m_gprs_in_use;
 	BitSet32 m_fprs_in_use;
@@ -33,7 +33,21 @@ bool Jitx86Base::HandleFault(uintptr_t access_address, SContext* ctx)
 	if (access_address >= (uintptr_t)Memory::physical_base && access_address < (uintptr_t)Memory::physical_base + 0x100010000)
 		return BackPatch((u32)(access_address - (uintptr_t)Memory::physical_base), ctx);
 	if (access_address >= (uintptr_t)Memory::logical_base && access_address < (uintptr_t)Memory::logical_base + 0x100010000)
-		return BackPatch((u32)(access_address - (uintptr_t)Memory::logical_base), ctx);
+	{
+		u32 em_address = (u32)(access_address - (uintptr_t)Memory::logical_base);
+
+		// Rather than sending the access to the slow path for good, map the page
+		// it hit if the page table allows, and run it again.
+		u8* code_ptr = (u8*)ctx->CTX_PC;
+		InstructionInfo info = {};
+		if (Memory::IsPageTableMappingEnabled() && IsInSpace(code_ptr) && DisassembleMov(code_ptr, &info) &&
+		    PowerPC::MapLogicalPageForFastmem(em_address, info.isMemoryWrite))
+		{
+			return true;
+		}
+
+		return BackPatch(em_address, ctx);
+	}
 
 
 	return false;
@@ -67,8 +81,8 @@ bool Jitx86Base::BackPatch(u32 emAddress, SContext* ctx)
 		return false;
 	}
 
-	auto it = registersInUseAtLoc.find(codePtr);
-	if (it == registersInUseAtLoc.end())
+	auto it = m_fastmem_sites.registersInUseAtLoc.find(codePtr);
+	if (it == m_fastmem_sites.registersInUseAtLoc.end())
 	{
 		PanicAlert("BackPatch: no register use entry for address %p", codePtr);
 		return false;
@@ -79,8 +93,8 @@ bool Jitx86Base::BackPatch(u32 emAddress, SContext* ctx)
 	u8* exceptionHandler = nullptr;
 	if (jit->jo.memcheck)
 	{
-		auto it2 = exceptionHandlerAtLoc.find(codePtr);
-		if (it2 != exceptionHandlerAtLoc.end())
+		auto it2 = m_fastmem_sites.exceptionHandlerAtLoc.find(codePtr);
+		if (it2 != m_fastmem_sites.exceptionHandlerAtLoc.end())
 			exceptionHandler = it2->second;
 	}
 
@@ -165,8 +179,8 @@ bool Jitx86Base::BackPatch(u32 emAddress, SContext* ctx)
 	if (info.isMemoryWrite)
 	{
 		// TODO: special case FIFO writes.
-		auto it3 = pcAtLoc.find(codePtr);
-		if (it3 == pcAtLoc.end())
+		auto it3 = m_fastmem_sites.pcAtLoc.find(codePtr);
+		if (it3 == m_fastmem_sites.pcAtLoc.end())
 		{
 			PanicAlert("BackPatch: no pc entry for address %p", codePtr);
 			return false;
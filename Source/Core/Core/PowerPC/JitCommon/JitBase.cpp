@@ -70,7 +70,7 @@ bool JitBase::MergeAllowedNextInstructions(int count)
 		if (SConfig::GetInstance().bEnableDebugging &&
 			PowerPC::breakpoints.IsAddressBreakPoint(js.op[i].address))
 			return false;
-		if (js.op[i].isBranchTarget)
+		if (js.op[i].isBranchTarget || js.op[i].skip)
 			return false;
 	}
 	return true;
@@ -84,5 +84,7 @@ void JitBase::UpdateMemoryOptions()
 	jo.memcheck = SConfig::GetInstance().bMMU ||
 	              any_watchpoints;
 	jo.alwaysUseMemFuncs = any_watchpoints;
+	jo.fastTLB = SConfig::GetInstance().bMMU &&
+	             !any_watchpoints;
 
 }
@@ -8,6 +8,7 @@
 //#define JIT_LOG_GPR     // Enables logging of the PPC general purpose regs
 //#define JIT_LOG_FPR     // Enables logging of the PPC floating point regs
 
+#include <mutex>
 #include <unordered_set>
 
 #include "Common/x64ABI.h"
@@ -23,6 +24,7 @@
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 #include "Core/PowerPC/PPCTables.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/PowerPC/Jit64Common/Jit64AsmCommon.h"
 #include "Core/PowerPC/JitCommon/Jit_Util.h"
 #include "Core/PowerPC/JitCommon/JitCache.h"
@@ -64,6 +66,8 @@ protected:
 		bool fastmem;
 		bool memcheck;
 		bool alwaysUseMemFuncs;
+		// Probe PowerPC::fast_tlb before calling the MMU functions.
+		bool fastTLB;
 	};
 	struct JitState
 	{
@@ -86,6 +90,9 @@ protected:
 		int revertFprLoad;
 
 		bool assumeNoPairedQuantize;
+		// The block is compiled at the first tier and counts its runs to get
+		// recompiled once it's hot.
+		bool firstTier;
 		bool firstFPInstructionFound;
 		bool isLastInstruction;
 		int skipInstructions;
@@ -117,6 +124,12 @@ public:
 	// This should probably be removed from public:
 	JitOptions jo;
 	JitState js;
+	JitStatistics statistics = {};
+
+	// Held while emitting code, patching existing code, or changing the block
+	// cache and the exception address sets, which cores that compile off the
+	// CPU thread read while compiling. Never taken by the fault handler.
+	std::recursive_mutex compile_lock;
 
 	virtual JitBaseBlockCache *GetBlockCache() = 0;
 
@@ -9,13 +9,17 @@
 // performance hit, it's not enabled by default, but it's useful for
 // locating performance issues.
 
+#include <algorithm>
 #include <cstring>
+#include <mutex>
+#include <unordered_set>
 #include "disasm.h"
 
 #include "Common/CommonTypes.h"
 #include "Common/JitRegister.h"
 #include "Common/MemoryUtil.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/JitCommon/JitBase.h"
 
 #ifdef _WIN32
@@ -26,7 +30,7 @@ using namespace Gen;
 
 	bool JitBaseBlockCache::IsFull() const
 	{
-		return GetNumBlocks() >= MAX_NUM_BLOCKS - 1;
+		return GetNumBlocks() >= MAX_NUM_BLOCKS - 1 && free_blocks.empty();
 	}
 
 	void JitBaseBlockCache::Init()
@@ -59,6 +63,8 @@ using namespace Gen;
 	// is full and when saving and loading states.
 	void JitBaseBlockCache::Clear()
 	{
+		std::lock_guard<std::recursive_mutex> lk(jit->compile_lock);
+
 #if defined(_DEBUG) || defined(DEBUGFAST)
 		if (IsFull())
 			Core::DisplayMessage("Clearing block cache.", 3000);
@@ -71,13 +77,18 @@ using namespace Gen;
 		{
 			DestroyBlock(i, false);
 		}
-		links_to.clear();
-		block_map.clear();
+		page_blocks.fill(-1);
+		links_to.fill({-1, 0});
+		max_block_pages = 1;
+		num_exit_counters = 0;
+		free_exit_counters.clear();
+		free_blocks.clear();
 
 		valid_block.ClearAll();
 
 		num_blocks = 0;
 		blockCodePointers.fill(nullptr);
+		generation++;
 	}
 
 	void JitBaseBlockCache::Reset()
@@ -98,12 +109,56 @@ using namespace Gen;
 
 	int JitBaseBlockCache::AllocateBlock(u32 em_address)
 	{
-		JitBlock &b = blocks[num_blocks];
+		int block_num;
+		if (free_blocks.empty())
+		{
+			block_num = num_blocks++; //commit the current block
+		}
+		else
+		{
+			block_num = free_blocks.back();
+			free_blocks.pop_back();
+		}
+
+		JitBlock &b = blocks[block_num];
 		b.invalid = false;
+		b.pending = false;
 		b.originalAddress = em_address;
 		b.linkData.clear();
-		num_blocks++; //commit the current block
-		return num_blocks - 1;
+		b.pagePrev = -1;
+		b.pageNext = -1;
+		return block_num;
+	}
+
+	int JitBaseBlockCache::AllocatePendingBlock(u32 em_address, u32 original_size)
+	{
+		int block_num = AllocateBlock(em_address);
+		JitBlock &b = blocks[block_num];
+		b.pending = true;
+		b.originalSize = original_size;
+		// Marked valid right away, so that the fast paths of InvalidateICache
+		// don't skip it before its code is installed.
+		SetValidBits(b);
+		AddToPageIndex(block_num);
+		return block_num;
+	}
+
+	void JitBaseBlockCache::DiscardPendingBlock(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		if (!b.pending)
+			return;
+
+		DestroyBlock(block_num, false);
+		// The compiler may have got to it after it was destroyed.
+		FreeExitCounters(b);
+
+		// Nothing refers to the slot anymore, so it can be reused like an
+		// evicted one.
+		b.pending = false;
+		b.checkedEntry = nullptr;
+		blockCodePointers[block_num] = nullptr;
+		free_blocks.push_back(block_num);
 	}
 
 	void JitBaseBlockCache::FinalizeBlock(int block_num, bool block_link, const u8 *code_ptr)
@@ -111,29 +166,35 @@ using namespace Gen;
 		blockCodePointers[block_num] = code_ptr;
 		JitBlock &b = blocks[block_num];
 
-		std::memcpy(GetICachePtr(b.originalAddress), &block_num, sizeof(u32));
-
-		// Convert the logical address to a physical address for the block map
-		u32 pAddr = b.originalAddress & 0x1FFFFFFF;
+		if (b.pending)
+		{
+			RemoveFromPageIndex(block_num);
+			b.pending = false;
+		}
 
-		for (u32 block = pAddr / 32; block <= (pAddr + (b.originalSize - 1) * 4) / 32; ++block)
-			valid_block.Set(block);
+		std::memcpy(GetICachePtr(b.originalAddress), &block_num, sizeof(u32));
 
-		block_map[std::make_pair(pAddr + 4 * b.originalSize - 1, pAddr)] = block_num;
+		SetValidBits(b);
+		AddToPageIndex(block_num);
 
 		if (block_link)
 		{
-			for (const auto& e : b.linkData)
-			{
-				links_to.emplace(e.exitAddress, block_num);
-			}
+			AddExitLinks(block_num);
 
 			LinkBlock(block_num);
 			LinkBlockExits(block_num);
 		}
 
-		JitRegister::Register(blockCodePointers[block_num], b.codeSize,
-			"JIT_PPC_%08x", b.originalAddress);
+		if (JitRegister::IsEnabled())
+		{
+			// Name blocks after the guest function they belong to, and use it as the
+			// "source file" of the guest addresses in the debug info.
+			Symbol* symbol = g_symbolDB.GetSymbolFromAddr(b.originalAddress);
+			std::string function_name = symbol ? symbol->name : "unknown";
+			JitRegister::Register(blockCodePointers[block_num], b.codeSize, function_name,
+				b.debugEntries, "JIT_PPC_%s_%08x", function_name.c_str(), b.originalAddress);
+		}
+		b.debugEntries.clear();
 	}
 
 	const u8 **JitBaseBlockCache::GetCodePointers()
@@ -144,12 +205,138 @@ using namespace Gen;
 	u8* JitBaseBlockCache::GetICachePtr(u32 addr)
 	{
 		if (addr & JIT_ICACHE_VMEM_BIT)
-			return &jit->GetBlockCache()->iCacheVMEM[addr & JIT_ICACHE_MASK];
+			return &iCacheVMEM[addr & JIT_ICACHE_MASK];
 
 		if (addr & JIT_ICACHE_EXRAM_BIT)
-			return &jit->GetBlockCache()->iCacheEx[addr & JIT_ICACHEEX_MASK];
+			return &iCacheEx[addr & JIT_ICACHEEX_MASK];
+
+		return &iCache[addr & JIT_ICACHE_MASK];
+	}
+
+	void JitBaseBlockCache::AddToPageIndex(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		u32 pAddr = b.originalAddress & 0x1FFFFFFF;
+		u32 first_page = pAddr >> BLOCK_PAGE_SHIFT;
+		u32 last_page = (pAddr + 4 * std::max<u32>(b.originalSize, 1) - 1) >> BLOCK_PAGE_SHIFT;
+		max_block_pages = std::max(max_block_pages, last_page - first_page + 1);
+
+		int& head = page_blocks[first_page];
+		b.pagePrev = -1;
+		b.pageNext = head;
+		if (head != -1)
+			blocks[head].pagePrev = block_num;
+		head = block_num;
+	}
+
+	void JitBaseBlockCache::RemoveFromPageIndex(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		if (b.pagePrev != -1)
+		{
+			blocks[b.pagePrev].pageNext = b.pageNext;
+		}
+		else
+		{
+			u32 page = (b.originalAddress & 0x1FFFFFFF) >> BLOCK_PAGE_SHIFT;
+			int& head = page_blocks[page];
+			// Blocks that were never finalized aren't in any list.
+			if (head != block_num)
+				return;
+			head = b.pageNext;
+		}
+		if (b.pageNext != -1)
+			blocks[b.pageNext].pagePrev = b.pagePrev;
+		b.pagePrev = -1;
+		b.pageNext = -1;
+	}
+
+	void JitBaseBlockCache::AddExitLinks(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		for (u32 i = 0; i < b.linkData.size(); i++)
+		{
+			JitBlock::LinkData& e = b.linkData[i];
+			ExitRef& head = links_to[GetLinkBucket(e.exitAddress)];
+			e.nextBlock = head.block;
+			e.nextExit = head.exit;
+			head = {block_num, i};
+		}
+	}
+
+	void JitBaseBlockCache::RemoveExitLinks(int block_num)
+	{
+		JitBlock &b = blocks[block_num];
+		for (u32 i = 0; i < b.linkData.size(); i++)
+		{
+			ExitRef& head = links_to[GetLinkBucket(b.linkData[i].exitAddress)];
+			int* prev_block = &head.block;
+			u32* prev_exit = &head.exit;
+			while (*prev_block != -1)
+			{
+				JitBlock::LinkData& e = blocks[*prev_block].linkData[*prev_exit];
+				if (*prev_block == block_num && *prev_exit == i)
+				{
+					*prev_block = e.nextBlock;
+					*prev_exit = e.nextExit;
+					break;
+				}
+				prev_block = &e.nextBlock;
+				prev_exit = &e.nextExit;
+			}
+		}
+	}
+
+	int JitBaseBlockCache::EvictBlocks(const u8* start, const u8* end, std::vector<u32>* addresses)
+	{
+		int evicted = 0;
+		for (int i = 0; i < num_blocks; i++)
+		{
+			JitBlock &b = blocks[i];
+			// Pending blocks have no code yet, and their owner still refers to them.
+			if (b.pending || b.checkedEntry < start || b.checkedEntry >= end)
+				continue;
+
+			if (!b.invalid)
+			{
+				DestroyBlock(i, false);
+				evicted++;
+				if (addresses)
+					addresses->push_back(b.originalAddress);
+			}
+
+			// The slot gets reused, so nothing may refer to it anymore.
+			RemoveExitLinks(i);
+			b.checkedEntry = nullptr;
+			blockCodePointers[i] = nullptr;
+			free_blocks.push_back(i);
+		}
+		return evicted;
+	}
 
-		return &jit->GetBlockCache()->iCache[addr & JIT_ICACHE_MASK];
+	// Calls func(exit) for every exit of a live block that jumps to address.
+	template <typename Func>
+	void JitBaseBlockCache::ForEachExitTo(u32 address, Func func)
+	{
+		ExitRef& head = links_to[GetLinkBucket(address)];
+		int* prev_block = &head.block;
+		u32* prev_exit = &head.exit;
+		while (*prev_block != -1)
+		{
+			JitBlock &source = blocks[*prev_block];
+			JitBlock::LinkData& e = source.linkData[*prev_exit];
+			if (source.invalid)
+			{
+				// Drop exits of destroyed blocks from the chain as we come across them.
+				*prev_block = e.nextBlock;
+				*prev_exit = e.nextExit;
+				continue;
+			}
+			if (e.exitAddress == address)
+				func(e);
+			prev_block = &e.nextBlock;
+			prev_exit = &e.nextExit;
+		}
 	}
 
 	int JitBaseBlockCache::GetBlockNumberFromStartAddress(u32 addr)
@@ -206,38 +393,66 @@ using namespace Gen;
 	{
 		LinkBlockExits(i);
 		JitBlock &b = blocks[i];
-		// equal_range(b) returns pair<iterator,iterator> representing the range
-		// of element with key b
-		auto ppp = links_to.equal_range(b.originalAddress);
-
-		if (ppp.first == ppp.second)
-			return;
-
-		for (auto iter = ppp.first; iter != ppp.second; ++iter)
-		{
-			// PanicAlert("Linking block %i to block %i", iter->second, i);
-			LinkBlockExits(iter->second);
-		}
+		ForEachExitTo(b.originalAddress, [&](JitBlock::LinkData& e) {
+			if (!e.linkStatus)
+			{
+				WriteLinkBlock(e.exitPtrs, b.checkedEntry);
+				e.linkStatus = true;
+			}
+		});
 	}
 
 	void JitBaseBlockCache::UnlinkBlock(int i)
 	{
 		JitBlock &b = blocks[i];
-		auto ppp = links_to.equal_range(b.originalAddress);
+		// The exits stay in the table so that they get relinked once the
+		// address is compiled again. Their jumps have to go, as evicted code gets
+		// overwritten by other blocks.
+		ForEachExitTo(b.originalAddress, [&](JitBlock::LinkData& e) {
+			if (e.linkStatus)
+			{
+				WriteUnlinkBlock(e.exitPtrs, e.exitAddress);
+				e.linkStatus = false;
+			}
+		});
+	}
 
-		if (ppp.first == ppp.second)
-			return;
+	u32* JitBaseBlockCache::AllocateExitCounter()
+	{
+		u32* counter;
+		if (!free_exit_counters.empty())
+		{
+			counter = free_exit_counters.back();
+			free_exit_counters.pop_back();
+		}
+		else if (num_exit_counters < MAX_NUM_EXIT_COUNTERS)
+		{
+			counter = &exit_counters[num_exit_counters++];
+		}
+		else
+		{
+			return nullptr;
+		}
 
-		for (auto iter = ppp.first; iter != ppp.second; ++iter)
+		*counter = 0;
+		return counter;
+	}
+
+	void JitBaseBlockCache::FreeExitCounters(JitBlock& b)
+	{
+		for (JitBlock::LinkData& e : b.linkData)
 		{
-			JitBlock &sourceBlock = blocks[iter->second];
-			for (auto& e : sourceBlock.linkData)
+			if (e.exitCount)
 			{
-				if (e.exitAddress == b.originalAddress)
-					e.linkStatus = false;
+				free_exit_counters.push_back(e.exitCount);
+				e.exitCount = nullptr;
 			}
 		}
-		links_to.erase(b.originalAddress);
+	}
+
+	void JitBaseBlockCache::InvalidateBlock(int block_num)
+	{
+		DestroyBlock(block_num, true);
 	}
 
 	void JitBaseBlockCache::DestroyBlock(int block_num, bool invalidate)
@@ -255,9 +470,19 @@ using namespace Gen;
 			return;
 		}
 		b.invalid = true;
+		FreeExitCounters(b);
+
+		if (b.pending)
+		{
+			// There's no code yet, the owner notices and drops the block.
+			RemoveFromPageIndex(block_num);
+			return;
+		}
+
 		std::memcpy(GetICachePtr(b.originalAddress), &JIT_ICACHE_INVALID_WORD, sizeof(u32));
 
 		UnlinkBlock(block_num);
+		RemoveFromPageIndex(block_num);
 
 		// Send anyone who tries to run this block back to the dispatcher.
 		// Not entirely ideal, but .. pretty good.
@@ -265,8 +490,41 @@ using namespace Gen;
 		WriteDestroyBlock(b.checkedEntry, b.originalAddress);
 	}
 
+	void JitBaseBlockCache::SetValidBits(const JitBlock& b)
+	{
+		// Convert the logical address to a physical address for the block map
+		u32 pAddr = b.originalAddress & 0x1FFFFFFF;
+
+		for (u32 block = pAddr / 32; block <= (pAddr + (b.originalSize - 1) * 4) / 32; ++block)
+			valid_block.Set(block);
+	}
+
+	// Erases the addresses in [address, address + length) from the set, walking
+	// whichever of the two is smaller.
+	static void EraseAddressRange(std::unordered_set<u32>& addresses, u32 address, u32 length)
+	{
+		if (addresses.size() < length / 4)
+		{
+			for (auto it = addresses.begin(); it != addresses.end();)
+			{
+				if (*it - address < length)
+					it = addresses.erase(it);
+				else
+					++it;
+			}
+		}
+		else
+		{
+			for (u64 i = address; i < (u64)address + length; i += 4)
+				addresses.erase((u32)i);
+		}
+	}
+
 	void JitBaseBlockCache::InvalidateICache(u32 address, const u32 length, bool forced)
 	{
+		// The compiler thread reads the block table and the exception address sets.
+		std::lock_guard<std::recursive_mutex> lk(jit->compile_lock);
+
 		// Convert the logical address to a physical address for the block map
 		u32 pAddr = address & 0x1FFFFFFF;
 
@@ -279,23 +537,36 @@ using namespace Gen;
 			else
 				valid_block.Clear(pAddr / 32);
 		}
+		else if (length > 32 && (u64)pAddr + length <= 0x20000000)
+		{
+			// Ranges written by DMA are mostly data; skip the page walk when no
+			// block was ever compiled from them.
+			destroy_block = valid_block.TestRange(pAddr / 32, (pAddr + length - 1) / 32);
+		}
 
 		// destroy JIT blocks
-		// !! this works correctly under assumption that any two overlapping blocks end at the same address
 		if (destroy_block)
 		{
-			std::map<std::pair<u32,u32>, u32>::iterator it1 = block_map.lower_bound(std::make_pair(pAddr, 0)), it2 = it1;
-			while (it2 != block_map.end() && it2->first.second < pAddr + length)
+			// Blocks are listed under the page they start in, so a block overlapping the
+			// range starts at most max_block_pages - 1 pages before the range does.
+			u64 end = (u64)pAddr + std::max<u32>(length, 1);
+			u32 first_page = pAddr >> BLOCK_PAGE_SHIFT;
+			first_page -= std::min(first_page, max_block_pages - 1);
+			u32 last_page = (u32)std::min<u64>((end - 1) >> BLOCK_PAGE_SHIFT, NUM_BLOCK_PAGES - 1);
+
+			for (u32 page = first_page; page <= last_page; page++)
 			{
-				JitBlock &b = blocks[it2->second];
-				std::memcpy(GetICachePtr(b.originalAddress), &JIT_ICACHE_INVALID_WORD, sizeof(u32));
-
-				DestroyBlock(it2->second, true);
-				++it2;
-			}
-			if (it1 != it2)
-			{
-				block_map.erase(it1, it2);
+				int block_num = page_blocks[page];
+				while (block_num != -1)
+				{
+					JitBlock &b = blocks[block_num];
+					int next = b.pageNext;
+					u32 block_start = b.originalAddress & 0x1FFFFFFF;
+					u32 block_end = block_start + 4 * b.originalSize;
+					if (block_start < (u64)pAddr + length && block_end > pAddr)
+						DestroyBlock(block_num, true);
+					block_num = next;
+				}
 			}
 
 			// If the code was actually modified, we need to clear the relevant entries from the
@@ -304,11 +575,8 @@ using namespace Gen;
 			// being in the right place between instructions).
 			if (!forced)
 			{
-				for (u32 i = address; i < address + length; i += 4)
-				{
-					jit->js.fifoWriteAddresses.erase(i);
-					jit->js.pairedQuantizeAddresses.erase(i);
-				}
+				EraseAddressRange(jit->js.fifoWriteAddresses, address, length);
+				EraseAddressRange(jit->js.pairedQuantizeAddresses, address, length);
 			}
 		}
 	}
@@ -339,3 +607,15 @@ using namespace Gen;
 		emit.MOV(32, PPCSTATE(pc), Imm32(address));
 		emit.JMP(jit->GetAsmRoutines()->dispatcher, true);
 	}
+
+	void JitBlockCache::WriteUnlinkBlock(u8* location, u32 address)
+	{
+		// Exits set pc before the jump, linked or not, so putting back the jump
+		// to the dispatcher is enough. A NOPed out jump to the next block had
+		// room for a JMP too.
+		XEmitter emit(location);
+		if (*location == 0xE8)
+			emit.CALL(jit->GetAsmRoutines()->dispatcher);
+		else
+			emit.JMP(jit->GetAsmRoutines()->dispatcher, true);
+	}
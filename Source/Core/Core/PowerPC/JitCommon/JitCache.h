@@ -6,10 +6,10 @@
 
 #include <array>
 #include <bitset>
-#include <map>
 #include <memory>
 #include <vector>
 
+#include "Common/JitRegister.h"
 #include "Core/PowerPC/Gekko.h"
 #include "Core/PowerPC/PPCAnalyst.h"
 
@@ -35,15 +35,34 @@ struct JitBlock
 	int runCount;  // for profiling.
 
 	bool invalid;
+	// Reserved by AllocatePendingBlock and still waiting for its code.
+	bool pending;
 
 	struct LinkData
 	{
 		u8 *exitPtrs;    // to be able to rewrite the exit jum
 		u32 exitAddress;
 		bool linkStatus; // is it already linked?
+
+		// Next exit in the same bucket of the block cache's exit-target table.
+		int nextBlock;
+		u32 nextExit;
+
+		// Address of the instruction the exit belongs to, and how often it was
+		// taken if the JIT counts it (see JitBaseBlockCache::AllocateExitCounter).
+		u32 exitFrom = 0;
+		u32* exitCount = nullptr;
 	};
 	std::vector<LinkData> linkData;
 
+	// Host address of each guest instruction, only collected while a profiler
+	// is listening (see JitRegister::IsEnabled). Cleared once registered.
+	std::vector<JitRegister::DebugEntry> debugEntries;
+
+	// Neighbours in the list of blocks starting in the same physical page.
+	int pagePrev;
+	int pageNext;
+
 	// we don't really need to save start and stop
 	// TODO (mb2): ticStart and ticStop -> "local var" mean "in block" ... low priority ;)
 	u64 ticStart;   // for profiling - time.
@@ -91,6 +110,26 @@ public:
 	{
 		return (m_valid_block[bit / 32] & (1u << (bit % 32))) != 0;
 	}
+
+	// Whether any bit in [first, last] is set.
+	bool TestRange(u32 first, u32 last)
+	{
+		u32 first_word = first / 32;
+		u32 last_word = last / 32;
+		u32 first_mask = ~0u << (first % 32);
+		u32 last_mask = ~0u >> (31 - last % 32);
+		if (first_word == last_word)
+			return (m_valid_block[first_word] & first_mask & last_mask) != 0;
+
+		if (m_valid_block[first_word] & first_mask)
+			return true;
+		for (u32 word = first_word + 1; word < last_word; word++)
+		{
+			if (m_valid_block[word])
+				return true;
+		}
+		return (m_valid_block[last_word] & last_mask) != 0;
+	}
 };
 
 class JitBaseBlockCache
@@ -98,30 +137,83 @@ class JitBaseBlockCache
 	enum
 	{
 		MAX_NUM_BLOCKS = 65536 * 2,
+
+		// Blocks are indexed by the 4 KiB physical page their first instruction is in.
+		BLOCK_PAGE_SHIFT = 12,
+		NUM_BLOCK_PAGES = 0x20000000 >> BLOCK_PAGE_SHIFT,
+
+		// Buckets of the exit-target hash table. Must be a power of two.
+		NUM_LINK_BUCKETS = 0x10000,
+
+		MAX_NUM_EXIT_COUNTERS = 0x40000,
+	};
+
+	// Reference to one exit (JitBlock::linkData entry) of a block.
+	struct ExitRef
+	{
+		int block;
+		u32 exit;
 	};
 
 	std::array<const u8*, MAX_NUM_BLOCKS> blockCodePointers;
 	std::array<JitBlock, MAX_NUM_BLOCKS> blocks;
 	int num_blocks;
-	std::multimap<u32, int> links_to;
-	std::map<std::pair<u32, u32>, u32> block_map; // (end_addr, start_addr) -> number
+
+	// Physical page -> first block starting in that page (-1 if none). The rest of
+	// the blocks in the page are chained through JitBlock::pageNext/pagePrev.
+	std::array<int, NUM_BLOCK_PAGES> page_blocks;
+	// Largest number of pages covered by a single block since the last Clear().
+	u32 max_block_pages;
+
+	// Hash of exit address -> chain of the linkable exits jumping there, chained
+	// through JitBlock::LinkData::nextBlock/nextExit. Exits of destroyed blocks are
+	// pruned lazily while walking a chain.
+	std::array<ExitRef, NUM_LINK_BUCKETS> links_to;
+
+	std::array<u32, MAX_NUM_EXIT_COUNTERS> exit_counters;
+	u32 num_exit_counters;
+	// Counters of destroyed blocks, reused by AllocateExitCounter.
+	std::vector<u32*> free_exit_counters;
+
+	// Slots of evicted blocks, reused by AllocateBlock.
+	std::vector<int> free_blocks;
+
 	ValidBlockBitSet valid_block;
 
+	u32 generation;
+
 	bool m_initialized;
 
+	static u32 GetLinkBucket(u32 address)
+	{
+		return (address >> 2) & (NUM_LINK_BUCKETS - 1);
+	}
+
+	void SetValidBits(const JitBlock& b);
+	void AddToPageIndex(int block_num);
+	void RemoveFromPageIndex(int block_num);
+	void AddExitLinks(int block_num);
+	void RemoveExitLinks(int block_num);
+	template <typename Func>
+	void ForEachExitTo(u32 address, Func func);
+
 	void LinkBlockExits(int i);
 	void LinkBlock(int i);
 	void UnlinkBlock(int i);
 
 	u8* GetICachePtr(u32 addr);
 	void DestroyBlock(int block_num, bool invalidate);
+	void FreeExitCounters(JitBlock& b);
 
 	// Virtual for overloaded
 	virtual void WriteLinkBlock(u8* location, const u8* address) = 0;
 	virtual void WriteDestroyBlock(const u8* location, u32 address) = 0;
+	// Points a linked exit back at the dispatcher, because the code it jumps to
+	// is going away.
+	virtual void WriteUnlinkBlock(u8* location, u32 address) = 0;
 
 public:
-	JitBaseBlockCache() : num_blocks(0), m_initialized(false)
+	JitBaseBlockCache() : num_blocks(0), max_block_pages(1), num_exit_counters(0), generation(0), m_initialized(false)
 	{
 	}
 
@@ -132,6 +224,13 @@ public:
 	int AllocateBlock(u32 em_address);
 	void FinalizeBlock(int block_num, bool block_link, const u8 *code_ptr);
 
+	// Reserves a block whose code is generated off the CPU thread. The block can't
+	// be found by the dispatcher until it is finalized, but invalidating any part of
+	// its range before that marks it invalid, in which case the caller must
+	// discard it instead.
+	int AllocatePendingBlock(u32 em_address, u32 original_size);
+	void DiscardPendingBlock(int block_num);
+
 	void Clear();
 	void Init();
 	void Shutdown();
@@ -139,6 +238,13 @@ public:
 
 	bool IsFull() const;
 
+	// Incremented by every Clear(). Block numbers handed out before a clear
+	// refer to other blocks afterwards.
+	u32 GetGeneration() const
+	{
+		return generation;
+	}
+
 	// Code Cache
 	JitBlock *GetBlock(int block_num);
 	int GetNumBlocks() const;
@@ -155,6 +261,19 @@ public:
 	// DOES NOT WORK CORRECTLY WITH INLINING
 	void InvalidateICache(u32 address, const u32 length, bool forced);
 
+	// Destroys a single block, e.g. to have it recompiled differently.
+	void InvalidateBlock(int block_num);
+
+	// Destroys every block whose code starts in [start, end) so that the JIT can
+	// reuse that part of its code space, and frees their slots. Returns the
+	// number of blocks evicted, and appends their addresses to addresses if
+	// it isn't null.
+	int EvictBlocks(const u8* start, const u8* end, std::vector<u32>* addresses = nullptr);
+
+	// Returns a zeroed counter for generated code to count an exit with, valid
+	// until its block is destroyed, or nullptr if there are none left.
+	u32* AllocateExitCounter();
+
 	u32* GetBlockBitSet() const
 	{
 		return valid_block.m_valid_block.get();
@@ -167,4 +286,5 @@ class JitBlockCache : public JitBaseBlockCache
 private:
 	void WriteLinkBlock(u8* location, const u8* address) override;
 	void WriteDestroyBlock(const u8* location, u32 address) override;
+	void WriteUnlinkBlock(u8* location, u32 address) override;
 };
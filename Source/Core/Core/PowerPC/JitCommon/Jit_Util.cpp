@@ -2,6 +2,8 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <cstddef>
+
 #include "Common/CommonTypes.h"
 #include "Common/Intrinsics.h"
 #include "Common/MathUtil.h"
@@ -12,6 +14,43 @@
 
 using namespace Gen;
 
+void EmuCodeBlock::FastmemSites::Clear()
+{
+	registersInUseAtLoc.clear();
+	pcAtLoc.clear();
+	exceptionHandlerAtLoc.clear();
+}
+
+void EmuCodeBlock::FastmemSites::Merge(FastmemSites& other)
+{
+	for (const auto& entry : other.registersInUseAtLoc)
+		registersInUseAtLoc[entry.first] = entry.second;
+	for (const auto& entry : other.pcAtLoc)
+		pcAtLoc[entry.first] = entry.second;
+	for (const auto& entry : other.exceptionHandlerAtLoc)
+		exceptionHandlerAtLoc[entry.first] = entry.second;
+	other.Clear();
+}
+
+template <typename Map>
+static void EraseCodeRange(Map& map, const u8* start, const u8* end)
+{
+	for (auto it = map.begin(); it != map.end();)
+	{
+		if (it->first >= start && it->first < end)
+			it = map.erase(it);
+		else
+			++it;
+	}
+}
+
+void EmuCodeBlock::FastmemSites::EraseRange(const u8* start, const u8* end)
+{
+	EraseCodeRange(registersInUseAtLoc, start, end);
+	EraseCodeRange(pcAtLoc, start, end);
+	EraseCodeRange(exceptionHandlerAtLoc, start, end);
+}
+
 void EmuCodeBlock::MemoryExceptionCheck()
 {
 	if (jit->jo.memcheck && !jit->js.fastmemLoadStore && !jit->js.fixupExceptionHandler)
@@ -96,6 +135,10 @@ public:
 	{
 		CallLambda(8 * sizeof (T), lambda);
 	}
+	void VisitPure(T (*func)(u32), const std::function<T(u32)>* lambda) override
+	{
+		CallFunction(8 * sizeof (T), reinterpret_cast<const void*>(func));
+	}
 
 private:
 	// Generates code to load a constant to the destination register. In
@@ -149,6 +192,14 @@ private:
 		MoveOpArgToReg(sbits, R(ABI_RETURN));
 	}
 
+	void CallFunction(int sbits, const void* func)
+	{
+		m_code->ABI_PushRegistersAndAdjustStack(m_registers_in_use, 0);
+		m_code->ABI_CallFunctionC(func, m_address);
+		m_code->ABI_PopRegistersAndAdjustStack(m_registers_in_use, 0);
+		MoveOpArgToReg(sbits, R(ABI_RETURN));
+	}
+
 	Gen::X64CodeBlock* m_code;
 	BitSet32 m_registers_in_use;
 	Gen::X64Reg m_dst_reg;
@@ -186,6 +237,153 @@ void EmuCodeBlock::MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value,
 	}
 }
 
+// Visitor that generates code to write a MMIO value.
+template <typename T>
+class MMIOWriteCodeGenerator : public MMIO::WriteHandlingMethodVisitor<T>
+{
+public:
+	MMIOWriteCodeGenerator(Gen::X64CodeBlock* code, BitSet32 registers_in_use,
+	                       const Gen::OpArg& value, u32 address)
+		: m_code(code), m_registers_in_use(registers_in_use), m_value(value),
+		  m_address(address)
+	{
+	}
+
+	void VisitNop() override
+	{
+	}
+	void VisitDirect(T* addr, u32 mask) override
+	{
+		WriteRegToAddrMask(8 * sizeof (T), addr, mask);
+	}
+	void VisitComplex(const std::function<void(u32, T)>* lambda) override
+	{
+		CallLambda(lambda);
+	}
+
+private:
+	void WriteRegToAddrMask(int sbits, void* ptr, u32 mask)
+	{
+		u32 all_ones = (1ULL << sbits) - 1;
+		if (m_value.IsImm())
+		{
+			u32 value = ImmValue() & mask;
+			m_code->MOV(64, R(RSCRATCH), ImmPtr(ptr));
+			m_code->MOV(sbits, MatR(RSCRATCH), sbits == 8 ? Imm8((u8)value) : sbits == 16 ? Imm16((u16)value) : Imm32(value));
+			return;
+		}
+
+		LoadValueToScratch();
+		if ((all_ones & mask) != all_ones)
+			m_code->AND(32, R(RSCRATCH), Imm32(mask));
+		m_code->MOV(64, R(RSCRATCH2), ImmPtr(ptr));
+		m_code->MOV(sbits, MatR(RSCRATCH2), R(RSCRATCH));
+	}
+
+	void CallLambda(const std::function<void(u32, T)>* lambda)
+	{
+		LoadValueToScratch();
+		if (sizeof(T) < 4)
+			m_code->MOVZX(32, 8 * sizeof(T), RSCRATCH, R(RSCRATCH));
+		m_code->ABI_PushRegistersAndAdjustStack(m_registers_in_use, 0);
+		m_code->ABI_CallLambdaCR(lambda, m_address, RSCRATCH);
+		m_code->ABI_PopRegistersAndAdjustStack(m_registers_in_use, 0);
+	}
+
+	u32 ImmValue() const
+	{
+		switch (m_value.GetImmBits())
+		{
+		case 8: return m_value.Imm8();
+		case 16: return m_value.Imm16();
+		default: return m_value.Imm32();
+		}
+	}
+
+	void LoadValueToScratch()
+	{
+		if (m_value.IsImm())
+			m_code->MOV(32, R(RSCRATCH), Imm32(ImmValue()));
+		else if (!m_value.IsSimpleReg(RSCRATCH))
+			m_code->MOV(32, R(RSCRATCH), m_value);
+	}
+
+	Gen::X64CodeBlock* m_code;
+	BitSet32 m_registers_in_use;
+	Gen::OpArg m_value;
+	u32 m_address;
+};
+
+void EmuCodeBlock::MMIOWriteRegToAddr(MMIO::Mapping* mmio, const Gen::OpArg& value,
+                                      BitSet32 registers_in_use, u32 address,
+                                      int access_size)
+{
+	switch (access_size)
+	{
+	case 8:
+		{
+			MMIOWriteCodeGenerator<u8> gen(this, registers_in_use, value, address);
+			mmio->GetHandlerForWrite<u8>(address).Visit(gen);
+			break;
+		}
+	case 16:
+		{
+			MMIOWriteCodeGenerator<u16> gen(this, registers_in_use, value, address);
+			mmio->GetHandlerForWrite<u16>(address).Visit(gen);
+			break;
+		}
+	case 32:
+		{
+			MMIOWriteCodeGenerator<u32> gen(this, registers_in_use, value, address);
+			mmio->GetHandlerForWrite<u32>(address).Visit(gen);
+			break;
+		}
+	}
+}
+
+FixupBranch EmitFastTLBLookup(XEmitter* emit, X64Reg reg_addr, s32 offset, int access_size, bool write,
+                              X64Reg scratch1, X64Reg scratch2)
+{
+	static_assert(sizeof(PowerPC::fast_tlb_entry) == 16, "The lookup scales the index by 16");
+	const u32 page_mask = ~((1 << HW_PAGE_INDEX_SHIFT) - 1);
+
+	emit->LEA(32, scratch1, MDisp(reg_addr, offset));
+	emit->SHR(32, R(scratch1), Imm8(HW_PAGE_INDEX_SHIFT - 4));
+	emit->AND(32, R(scratch1), Imm32((FAST_TLB_SIZE - 1) << 4));
+	emit->MOV(64, R(scratch2), ImmPtr(&PowerPC::fast_tlb[write]));
+	emit->ADD(64, R(scratch1), R(scratch2));
+
+	// Compare against the page of the last byte, so that accesses crossing into
+	// the next page miss.
+	emit->LEA(32, scratch2, MDisp(reg_addr, offset + access_size / 8 - 1));
+	emit->AND(32, R(scratch2), Imm32(page_mask));
+	emit->CMP(32, R(scratch2), MDisp(scratch1, offsetof(PowerPC::fast_tlb_entry, tag)));
+	FixupBranch miss = emit->J_CC(CC_NE, true);
+
+	emit->MOV(64, R(scratch1), MDisp(scratch1, offsetof(PowerPC::fast_tlb_entry, host_base)));
+	emit->LEA(32, scratch2, MDisp(reg_addr, offset));
+	emit->ADD(64, R(scratch1), R(scratch2));
+	return miss;
+}
+
+bool GetFastTLBScratchRegisters(BitSet32 registers_in_use, X64Reg* scratch1, X64Reg* scratch2)
+{
+	int found = 0;
+	for (int reg : ABI_ALL_CALLER_SAVED & BitSet32(0xFFFF) & ~registers_in_use)
+	{
+		if (found++ == 0)
+		{
+			*scratch1 = (X64Reg)reg;
+		}
+		else
+		{
+			*scratch2 = (X64Reg)reg;
+			return true;
+		}
+	}
+	return false;
+}
+
 FixupBranch EmuCodeBlock::CheckIfSafeAddress(const OpArg& reg_value, X64Reg reg_addr, BitSet32 registers_in_use, u32 mem_mask)
 {
 	registers_in_use[reg_addr] = true;
@@ -235,7 +433,7 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 	{
 		u8 *mov = UnsafeLoadToReg(reg_value, opAddress, accessSize, offset, signExtend);
 
-		registersInUseAtLoc[mov] = registersInUse;
+		m_emit_sites->registersInUseAtLoc[mov] = registersInUse;
 		jit->js.fastmemLoadStore = mov;
 		return;
 	}
@@ -298,7 +496,8 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 		LEA(32, RSCRATCH, MDisp(opAddress.GetSimpleReg(), offset));
 	}
 
-	FixupBranch exit;
+	FixupBranch exit, tlb_hit;
+	bool use_fast_tlb = false;
 	if (!jit->jo.alwaysUseMemFuncs)
 	{
 		FixupBranch slow = CheckIfSafeAddress(R(reg_value), reg_addr, registersInUse, mem_mask);
@@ -308,6 +507,19 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 		else
 			exit = J(true);
 		SetJumpTarget(slow);
+
+		BitSet32 tlb_in_use = registersInUse;
+		tlb_in_use[reg_addr] = true;
+		tlb_in_use[reg_value] = true;
+		X64Reg tlb_host, tlb_scratch;
+		use_fast_tlb = jit->jo.fastTLB && GetFastTLBScratchRegisters(tlb_in_use, &tlb_host, &tlb_scratch);
+		if (use_fast_tlb)
+		{
+			FixupBranch tlb_miss = EmitFastTLBLookup(this, reg_addr, 0, accessSize, false, tlb_host, tlb_scratch);
+			LoadAndSwap(accessSize, reg_value, MatR(tlb_host), signExtend);
+			tlb_hit = J(true);
+			SetJumpTarget(tlb_miss);
+		}
 	}
 	size_t rsp_alignment = (flags & SAFE_LOADSTORE_NO_PROLOG) ? 8 : 0;
 	ABI_PushRegistersAndAdjustStack(registersInUse, rsp_alignment);
@@ -347,6 +559,8 @@ void EmuCodeBlock::SafeLoadToReg(X64Reg reg_value, const Gen::OpArg & opAddress,
 			SwitchToNearCode();
 		}
 		SetJumpTarget(exit);
+		if (use_fast_tlb)
+			SetJumpTarget(tlb_hit);
 	}
 }
 
@@ -434,6 +648,14 @@ bool EmuCodeBlock::WriteToConstAddress(int accessSize, OpArg arg, u32 address, B
 		WriteToConstRamAddress(accessSize, arg, address);
 		return false;
 	}
+	else if (u32 mmioAddress = accessSize != 64 ? PowerPC::IsOptimizableMMIOAccess(address, accessSize) : 0)
+	{
+		// Helps external systems know which instruction triggered the write
+		MOV(32, PPCSTATE(pc), Imm32(jit->js.compilerPC));
+
+		MMIOWriteRegToAddr(Memory::mmio_mapping, arg, registersInUse, mmioAddress, accessSize);
+		return false;
+	}
 	else
 	{
 		// Helps external systems know which instruction triggered the write
@@ -478,8 +700,8 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 			NOP(padding);
 		}
 
-		registersInUseAtLoc[mov] = registersInUse;
-		pcAtLoc[mov] = jit->js.compilerPC;
+		m_emit_sites->registersInUseAtLoc[mov] = registersInUse;
+		m_emit_sites->pcAtLoc[mov] = jit->js.compilerPC;
 		jit->js.fastmemLoadStore = mov;
 		return;
 	}
@@ -504,7 +726,7 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 
 	bool swap = !(flags & SAFE_LOADSTORE_NO_SWAP);
 
-	FixupBranch slow, exit;
+	FixupBranch slow, exit, tlb_hit;
 	slow = CheckIfSafeAddress(reg_value, reg_addr, registersInUse, mem_mask);
 	UnsafeWriteRegToReg(reg_value, reg_addr, accessSize, 0, swap);
 	if (farcode.Enabled())
@@ -513,6 +735,33 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 		exit = J(true);
 	SetJumpTarget(slow);
 
+	BitSet32 tlb_in_use = registersInUse;
+	tlb_in_use[reg_addr] = true;
+	if (reg_value.IsSimpleReg())
+		tlb_in_use[reg_value.GetSimpleReg()] = true;
+	X64Reg tlb_host, tlb_scratch;
+	bool use_fast_tlb = jit->jo.fastTLB && GetFastTLBScratchRegisters(tlb_in_use, &tlb_host, &tlb_scratch);
+	if (use_fast_tlb)
+	{
+		FixupBranch tlb_miss = EmitFastTLBLookup(this, reg_addr, 0, accessSize, true, tlb_host, tlb_scratch);
+		if (reg_value.IsImm())
+		{
+			MOV(accessSize, MatR(tlb_host), swap ? SwapImmediate(accessSize, reg_value) : reg_value);
+		}
+		else if (swap && accessSize > 8)
+		{
+			// Don't clobber reg_value, it's still needed if the write misses.
+			MOV(accessSize == 64 ? 64 : 32, R(tlb_scratch), reg_value);
+			SwapAndStore(accessSize, MatR(tlb_host), tlb_scratch);
+		}
+		else
+		{
+			MOV(accessSize, MatR(tlb_host), reg_value);
+		}
+		tlb_hit = J(true);
+		SetJumpTarget(tlb_miss);
+	}
+
 	// PC is used by memory watchpoints (if enabled) or to print accurate PC locations in debug logs
 	MOV(32, PPCSTATE(pc), Imm32(jit->js.compilerPC));
 
@@ -553,6 +802,8 @@ void EmuCodeBlock::SafeWriteRegToReg(OpArg reg_value, X64Reg reg_addr, int acces
 		SwitchToNearCode();
 	}
 	SetJumpTarget(exit);
+	if (use_fast_tlb)
+		SetJumpTarget(tlb_hit);
 }
 
 void EmuCodeBlock::WriteToConstRamAddress(int accessSize, OpArg arg, u32 address, bool swap)
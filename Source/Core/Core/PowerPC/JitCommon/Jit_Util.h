@@ -46,6 +46,16 @@ static const int FARCODE_SIZE_MMU = 1024 * 1024 * 48;
 static const int TRAMPOLINE_CODE_SIZE = 1024 * 1024 * 8;
 static const int TRAMPOLINE_CODE_SIZE_MMU = 1024 * 1024 * 32;
 
+// Emits an inline lookup of PowerPC::fast_tlb for an access of access_size
+// bits at reg_addr + offset. On a hit, execution falls through with the host
+// address of the access in scratch1. The returned branch is taken on a miss,
+// which has to go through the full translation. Clobbers both scratch registers.
+Gen::FixupBranch EmitFastTLBLookup(Gen::XEmitter* emit, Gen::X64Reg reg_addr, s32 offset, int access_size, bool write,
+                                   Gen::X64Reg scratch1, Gen::X64Reg scratch2);
+// Picks two caller saved registers that aren't in registers_in_use, returns
+// false if there aren't enough.
+bool GetFastTLBScratchRegisters(BitSet32 registers_in_use, Gen::X64Reg* scratch1, Gen::X64Reg* scratch2);
+
 // Like XCodeBlock but has some utilities for memory access.
 class EmuCodeBlock : public Gen::X64CodeBlock
 {
@@ -83,6 +93,7 @@ public:
 	// Generate a load/write from the MMIO handler for a given address. Only
 	// call for known addresses in MMIO range (MMIO::IsMMIOAddress).
 	void MMIOLoadToReg(MMIO::Mapping* mmio, Gen::X64Reg reg_value, BitSet32 registers_in_use, u32 address, int access_size, bool sign_extend);
+	void MMIOWriteRegToAddr(MMIO::Mapping* mmio, const Gen::OpArg& value, BitSet32 registers_in_use, u32 address, int access_size);
 
 	enum SafeLoadStoreFlags
 	{
@@ -129,7 +140,25 @@ public:
 	void ConvertDoubleToSingle(Gen::X64Reg dst, Gen::X64Reg src);
 	void SetFPRF(Gen::X64Reg xmm);
 protected:
-	std::unordered_map<u8 *, BitSet32> registersInUseAtLoc;
-	std::unordered_map<u8 *, u32> pcAtLoc;
-	std::unordered_map<u8 *, u8 *> exceptionHandlerAtLoc;
+	// What the fault handler needs to know about each fastmem access.
+	struct FastmemSites
+	{
+		std::unordered_map<u8 *, BitSet32> registersInUseAtLoc;
+		std::unordered_map<u8 *, u32> pcAtLoc;
+		std::unordered_map<u8 *, u8 *> exceptionHandlerAtLoc;
+
+		void Clear();
+		// Moves the entries of other into this.
+		void Merge(FastmemSites& other);
+		// Drops the entries of code in [start, end).
+		void EraseRange(const u8* start, const u8* end);
+	};
+
+	// Only changed on the CPU thread, so that the fault handler doesn't have
+	// to lock.
+	FastmemSites m_fastmem_sites;
+	// Where code being emitted records its sites. Code emitted off the CPU
+	// thread records them separately, and they get merged into m_fastmem_sites
+	// when the code is installed.
+	FastmemSites* m_emit_sites = &m_fastmem_sites;
 };
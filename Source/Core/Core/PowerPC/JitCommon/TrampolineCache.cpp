@@ -43,6 +43,20 @@ const u8* TrampolineCache::GenerateReadTrampoline(const InstructionInfo &info, B
 	const u8* trampoline = GetCodePtr();
 	X64Reg addrReg = (X64Reg)info.scaledReg;
 	X64Reg dataReg = (X64Reg)info.regOperandReg;
+
+	BitSet32 tlb_in_use = registersInUse;
+	tlb_in_use[addrReg] = true;
+	tlb_in_use[dataReg] = true;
+	X64Reg tlb_host, tlb_scratch;
+	if (jit->jo.fastTLB && GetFastTLBScratchRegisters(tlb_in_use, &tlb_host, &tlb_scratch))
+	{
+		FixupBranch tlb_miss = EmitFastTLBLookup(this, addrReg, info.displacement, info.operandSize * 8, false,
+		                                         tlb_host, tlb_scratch);
+		LoadAndSwap(info.operandSize * 8, dataReg, MatR(tlb_host), info.signExtend);
+		JMP(returnPtr, true);
+		SetJumpTarget(tlb_miss);
+	}
+
 	int stack_offset = 0;
 	bool push_param1 = registersInUse[ABI_PARAM1];
 
@@ -111,6 +125,34 @@ const u8* TrampolineCache::GenerateWriteTrampoline(const InstructionInfo &info,
 	X64Reg dataReg = (X64Reg)info.regOperandReg;
 	X64Reg addrReg = (X64Reg)info.scaledReg;
 
+	BitSet32 tlb_in_use = registersInUse;
+	tlb_in_use[addrReg] = true;
+	if (!info.hasImmediate)
+		tlb_in_use[dataReg] = true;
+	X64Reg tlb_host, tlb_scratch;
+	if (jit->jo.fastTLB && !(info.hasImmediate && info.operandSize == 8) &&
+	    GetFastTLBScratchRegisters(tlb_in_use, &tlb_host, &tlb_scratch))
+	{
+		FixupBranch tlb_miss = EmitFastTLBLookup(this, addrReg, info.displacement, info.operandSize * 8, true,
+		                                         tlb_host, tlb_scratch);
+		// The immediate is already in guest byte order.
+		if (info.hasImmediate && info.operandSize == 4)
+			MOV(32, MatR(tlb_host), Imm32((u32)info.immediate));
+		else if (info.hasImmediate && info.operandSize == 2)
+			MOV(16, MatR(tlb_host), Imm16((u16)info.immediate));
+		else if (info.hasImmediate)
+			MOV(8, MatR(tlb_host), Imm8((u8)info.immediate));
+		else if (info.operandSize == 1)
+			MOV(8, MatR(tlb_host), R(dataReg));
+		else
+		{
+			MOV(info.operandSize == 8 ? 64 : 32, R(tlb_scratch), R(dataReg));
+			SwapAndStore(info.operandSize * 8, MatR(tlb_host), tlb_scratch);
+		}
+		JMP(returnPtr, true);
+		SetJumpTarget(tlb_miss);
+	}
+
 	// Don't treat FIFO writes specially for now because they require a burst
 	// check anyway.
 
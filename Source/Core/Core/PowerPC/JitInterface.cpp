@@ -4,7 +4,10 @@
 
 #include <algorithm>
 #include <cinttypes>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -38,11 +41,41 @@ bool bMMU = false;
 
 namespace JitInterface
 {
-	void DoState(PointerWrap &p)
+	// The ranges passed to InvalidateICache since the last save with rollback.
+	static bool s_log_invalidations;
+	static std::vector<std::pair<u32, u32>> s_invalidations;
+
+	void DoState(PointerWrap &p, bool rollback)
 	{
-		if (jit && p.GetMode() == PointerWrap::MODE_READ)
-			jit->GetBlockCache()->Clear();
+		if (p.GetMode() == PointerWrap::MODE_WRITE && rollback)
+		{
+			s_invalidations.clear();
+			s_log_invalidations = true;
+		}
+		else if (p.GetMode() == PointerWrap::MODE_READ)
+		{
+			// The blocks compiled from the code that was there at the save are
+			// still valid, as are the ones compiled since from code that is
+			// unchanged.
+			if (jit && rollback && s_log_invalidations)
+			{
+				for (const auto& range : s_invalidations)
+					jit->GetBlockCache()->InvalidateICache(range.first, range.second, false);
+			}
+			else if (jit)
+			{
+				jit->ClearCache();
+			}
+			DiscardRollback();
+		}
 	}
+
+	void DiscardRollback()
+	{
+		s_invalidations.clear();
+		s_log_invalidations = false;
+	}
+
 	CPUCoreBase *InitJitCore(int core)
 	{
 		bMMU = SConfig::GetInstance().bMMU;
@@ -209,6 +242,14 @@ namespace JitInterface
 		return 0;
 	}
 
+	void GetStatistics(JitStatistics* stats)
+	{
+		if (jit)
+			*stats = jit->statistics;
+		else
+			*stats = {};
+	}
+
 	bool HandleFault(uintptr_t access_address, SContext* ctx)
 	{
 		// Prevent nullptr dereference on a crash with no JIT present
@@ -237,6 +278,8 @@ namespace JitInterface
 
 	void InvalidateICache(u32 address, u32 size, bool forced)
 	{
+		if (s_log_invalidations)
+			s_invalidations.emplace_back(address, size);
 		if (jit)
 			jit->GetBlockCache()->InvalidateICache(address, size, forced);
 	}
@@ -246,6 +289,7 @@ namespace JitInterface
 		if (!jit)
 			return;
 
+		std::lock_guard<std::recursive_mutex> lk(jit->compile_lock);
 		std::unordered_set<u32>* exception_addresses = nullptr;
 
 		switch (type)
@@ -276,6 +320,7 @@ namespace JitInterface
 
 	void Shutdown()
 	{
+		DiscardRollback();
 		if (jit)
 		{
 			jit->Shutdown();
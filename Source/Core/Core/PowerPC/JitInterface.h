@@ -18,7 +18,12 @@ namespace JitInterface
 		EXCEPTIONS_PAIRED_QUANTIZE
 	};
 
-	void DoState(PointerWrap &p);
+	// Loading a state clears the cache. Loading with rollback, a state that was
+	// saved with rollback a few frames earlier, only invalidates the code that
+	// was invalidated since the save.
+	void DoState(PointerWrap &p, bool rollback = false);
+	// Forgets the save with rollback, when its state isn't going to be loaded.
+	void DiscardRollback();
 
 	CPUCoreBase *InitJitCore(int core);
 	void InitTables(int core);
@@ -28,6 +33,7 @@ namespace JitInterface
 	void WriteProfileResults(const std::string& filename);
 	void GetProfileResults(ProfileStats* prof_stats);
 	int GetHostCode(u32* address, const u8** code, u32* code_size);
+	void GetStatistics(JitStatistics* stats);
 
 	// Memory Utilities
 	bool HandleFault(uintptr_t access_address, SContext* ctx);
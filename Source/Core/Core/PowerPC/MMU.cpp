@@ -25,6 +25,8 @@ namespace PowerPC
 
 #define HW_PAGE_SIZE 4096
 
+fast_tlb_entry fast_tlb[2][FAST_TLB_SIZE];
+
 // EFB RE
 /*
 GXPeekZ
@@ -782,6 +784,10 @@ u32 IsOptimizableMMIOAccess(u32 address, u32 accessSize)
 	if ((address & 0xF0000000) != 0xC0000000)
 		return 0;
 
+	// Profiling counts accesses in MMIO::Mapping, which inlined code skips.
+	if (Memory::mmio_mapping->IsProfilingEnabled())
+		return 0;
+
 	unsigned translated = address & 0x0FFFFFFF;
 	bool aligned = (translated & ((accessSize >> 3) - 1)) == 0;
 	if (!aligned || !MMIO::IsMMIOAddress(translated))
@@ -946,6 +952,7 @@ void SDRUpdated()
 	}
 	PowerPC::ppcState.pagetable_base = htaborg<<16;
 	PowerPC::ppcState.pagetable_hashmask = ((xx<<10)|0x3ff);
+	InvalidateFastTLB();
 }
 
 enum TLBLookupResult
@@ -1020,8 +1027,49 @@ static __forceinline void UpdateTLBEntry(const XCheckTLBFlag flag, UPTE2 PTE2, c
 	tlbe->tag[index] = tag;
 }
 
+static __forceinline void UpdateFastTLBEntry(const XCheckTLBFlag flag, const u32 address, const u32 translated)
+{
+	// Only RAM is accessed directly. Segments 0 and 1 are left out because
+	// they're untranslated when MSR.DR is off, which the JIT doesn't check.
+	if ((flag != FLAG_READ && flag != FLAG_WRITE) || address < 0x20000000 || translated >= Memory::REALRAM_SIZE)
+		return;
+
+	fast_tlb_entry* e = &fast_tlb[flag == FLAG_WRITE][(address >> HW_PAGE_INDEX_SHIFT) & (FAST_TLB_SIZE - 1)];
+	e->tag = address & ~(HW_PAGE_SIZE - 1);
+	e->host_base = (uintptr_t)Memory::physical_base + (translated & ~(HW_PAGE_SIZE - 1)) - e->tag;
+}
+
+void InvalidateFastTLB()
+{
+	for (auto& table : fast_tlb)
+	{
+		for (fast_tlb_entry& e : table)
+			e.tag = TLB_TAG_INVALID;
+	}
+	Memory::UnmapAllLogicalPages();
+}
+
+bool MapLogicalPageForFastmem(u32 address, bool write)
+{
+	// Only the segments that aren't covered by the hardcoded BAT views.
+	if (!Memory::IsPageTableMappingEnabled() || !UReg_MSR(MSR).DR || !BitSet32(0xCFE)[address >> 28])
+		return false;
+
+	u32 translated = write ? TranslateAddress<FLAG_WRITE>(address) : TranslateAddress<FLAG_READ>(address);
+	if (translated == 0)
+		return false;
+
+	return Memory::MapLogicalPage(address, translated, write);
+}
+
 void InvalidateTLBEntry(u32 address)
 {
+	// tlbie ignores the segment, which the fast TLB doesn't index by either.
+	fast_tlb[0][(address >> HW_PAGE_INDEX_SHIFT) & (FAST_TLB_SIZE - 1)].tag = TLB_TAG_INVALID;
+	fast_tlb[1][(address >> HW_PAGE_INDEX_SHIFT) & (FAST_TLB_SIZE - 1)].tag = TLB_TAG_INVALID;
+	for (u32 segment = 0; segment < 16; segment++)
+		Memory::UnmapLogicalPage((segment << 28) | (address & 0x0FFFF000));
+
 	PowerPC::tlb_entry *tlbe = &PowerPC::ppcState.tlb[0][(address >> HW_PAGE_INDEX_SHIFT) & HW_PAGE_INDEX_MASK];
 	tlbe->tag[0] = TLB_TAG_INVALID;
 	tlbe->tag[1] = TLB_TAG_INVALID;
@@ -1039,7 +1087,10 @@ static __forceinline u32 TranslatePageAddress(const u32 address, const XCheckTLB
 	u32 translatedAddress = 0;
 	TLBLookupResult res = LookupTLBPageAddress(flag , address, &translatedAddress);
 	if (res == TLB_FOUND)
+	{
+		UpdateFastTLBEntry(flag, address, translatedAddress);
 		return translatedAddress;
+	}
 
 	u32 sr = PowerPC::ppcState.sr[EA_SR(address)];
 
@@ -1086,6 +1137,7 @@ static __forceinline u32 TranslatePageAddress(const u32 address, const XCheckTLB
 				if (res != TLB_UPDATE_C)
 					UpdateTLBEntry(flag, PTE2, address);
 
+				UpdateFastTLBEntry(flag, address, (PTE2.RPN << 12) | offset);
 				return (PTE2.RPN << 12) | offset;
 			}
 		}
@@ -10,6 +10,7 @@
 
 #include "Core/ConfigManager.h"
 #include "Core/GeckoCode.h"
+#include "Core/HLE/HLE.h"
 #include "Core/HW/Memmap.h"
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PPCAnalyst.h"
@@ -35,6 +36,9 @@ static const int CODEBUFFER_SIZE = 32000;
 // 0 does not perform block merging
 static const u32 FUNCTION_FOLLOWING_THRESHOLD = 16;
 
+// Maximum number of branches followed when forming a trace.
+static const u32 TRACE_FOLLOWING_THRESHOLD = 8;
+
 CodeBuffer::CodeBuffer(int size)
 {
 	codebuffer = new PPCAnalyst::CodeOp[size];
@@ -484,6 +488,141 @@ void PPCAnalyzer::ReorderInstructions(u32 instructions, CodeOp *code)
 		ReorderInstructionsCore(instructions, code, false, REORDER_CMP);
 }
 
+// Integer instructions whose only effect is writing one GPR.
+static bool IsPureGPRWrite(const CodeOp& op)
+{
+	const UGeckoInstruction inst = op.inst;
+	switch (inst.OPCD)
+	{
+	case 14: // addi
+	case 15: // addis
+	case 24: // ori
+	case 25: // oris
+		return true;
+	case 21: // rlwinmx
+		return !inst.Rc;
+	case 31:
+		// SUBOP10 includes OE, so this doesn't match the forms that set XER.
+		switch (inst.SUBOP10)
+		{
+		case 28:  // andx
+		case 40:  // subfx
+		case 266: // addx
+		case 444: // orx
+			return !inst.Rc;
+		}
+		return false;
+	default:
+		return false;
+	}
+}
+
+// Returns the register an li/lis/addi/addis/ori/oris sets to a known value, or
+// -1 if the instruction isn't one of those or its source isn't known.
+static int GetConstantResult(UGeckoInstruction inst, BitSet32 known, const u32* values, u32* result)
+{
+	switch (inst.OPCD)
+	{
+	case 14: // addi
+	case 15: // addis
+	{
+		u32 imm = inst.OPCD == 14 ? (u32)(s32)inst.SIMM_16 : (u32)inst.SIMM_16 << 16;
+		if (inst.RA == 0)
+		{
+			*result = imm;
+			return inst.RD;
+		}
+		if (known[inst.RA])
+		{
+			*result = values[inst.RA] + imm;
+			return inst.RD;
+		}
+		return -1;
+	}
+	case 24: // ori
+	case 25: // oris
+		if (known[inst.RS])
+		{
+			*result = values[inst.RS] | (inst.OPCD == 24 ? inst.UIMM : inst.UIMM << 16);
+			return inst.RA;
+		}
+		return -1;
+	default:
+		return -1;
+	}
+}
+
+void PPCAnalyzer::PropagateConstants(u32 instructions, CodeOp *code)
+{
+	BitSet32 known;
+	u32 values[32];
+
+	for (u32 i = 0; i < instructions; i++)
+	{
+		CodeOp& op = code[i];
+		const UGeckoInstruction inst = op.inst;
+
+		// HLE hooks run native code before the instruction, and lmw/lswi write
+		// more registers than regsOut says.
+		if (op.isBranchTarget || (op.opinfo->flags & FL_EVIL) || HLE::GetFunctionIndex(op.address))
+			known = BitSet32(0);
+
+		if (op.skip)
+			continue;
+
+		// lwz through stfdu, except lmw/stmw
+		if (inst.OPCD >= 32 && inst.OPCD <= 55 && inst.OPCD != 46 && inst.OPCD != 47 &&
+		    inst.RA != 0 && known[inst.RA])
+		{
+			op.hasConstantAddress = true;
+			op.constantAddress = values[inst.RA] + (u32)(s32)inst.SIMM_16;
+		}
+
+		u32 result = 0;
+		int dest = GetConstantResult(inst, known, values, &result);
+
+		known &= ~op.regsOut;
+		if (dest >= 0)
+		{
+			known[dest] = true;
+			values[dest] = result;
+		}
+	}
+}
+
+void PPCAnalyzer::EliminateDeadCode(u32 instructions, CodeOp *code)
+{
+	// GPRs whose value at this point is overwritten before it's read, without
+	// anything in between that could leave the block or raise an exception
+	// (and so make the value visible).
+	BitSet32 dead;
+
+	for (int i = instructions - 1; i >= 0; i--)
+	{
+		CodeOp& op = code[i];
+		if (op.skip)
+			continue;
+
+		if (IsPureGPRWrite(op) && !(op.regsOut & ~dead))
+		{
+			op.skip = true;
+		}
+		else if (op.canEndBlock || op.opinfo->type != OPTYPE_INTEGER ||
+		         (op.opinfo->flags & (FL_EVIL | FL_LOADSTORE | FL_USE_FPU)))
+		{
+			dead = BitSet32(0);
+		}
+		else
+		{
+			dead |= op.regsOut;
+			dead &= ~op.regsIn;
+		}
+
+		if (op.isBranchTarget || HLE::GetFunctionIndex(op.address))
+			dead = BitSet32(0);
+	}
+}
+
 void PPCAnalyzer::SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInfo *opinfo, u32 index)
 {
 	code->wantsCR0 = false;
@@ -623,6 +762,132 @@ void PPCAnalyzer::SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInf
 	}
 }
 
+void PPCAnalyzer::FindIdleLoop(CodeBlock *block, u32 instructions, CodeOp *code)
+{
+	// An iteration that doesn't store, and doesn't overwrite any register or CR
+	// field it read before writing it, leaves the state unchanged unless memory
+	// changes. The next iteration then takes the same path and branches back
+	// again. Branches out of the loop are fine, they aren't taken.
+	//
+	// Memory only changes in events if it's RAM. MMIO registers like the VI
+	// beam position or the AI sample counter change as time passes, so loops
+	// polling them must keep running.
+	BitSet32 read_first, written;
+	BitSet8 cr_read_first, cr_written;
+	BitSet32 known;
+	u32 values[32];
+
+	for (u32 i = 0; i < instructions; i++)
+	{
+		const CodeOp& op = code[i];
+		if (op.branchFollowed || HLE::GetFunctionIndex(op.address))
+			return;
+
+		// bx and bcx are in the tables as OPTYPE_SYSTEM.
+		if (op.inst.OPCD == 16 || op.inst.OPCD == 18 || op.opinfo->type == OPTYPE_BRANCH)
+		{
+			u32 destination;
+			if (op.inst.OPCD == 18 && !op.inst.LK)
+			{
+				destination = op.inst.AA ? SignExt26(op.inst.LI << 2) : op.address + SignExt26(op.inst.LI << 2);
+			}
+			else if (op.inst.OPCD == 16 && !op.inst.LK && (op.inst.BO & BO_DONT_DECREMENT_FLAG))
+			{
+				destination = op.inst.AA ? SignExt16(op.inst.BD << 2) : op.address + SignExt16(op.inst.BD << 2);
+				if ((op.inst.BO & BO_DONT_CHECK_CONDITION) == 0 && !cr_written[op.inst.BI >> 2])
+					cr_read_first[op.inst.BI >> 2] = true;
+			}
+			else
+			{
+				return;
+			}
+
+			if (destination == block->m_address)
+			{
+				code[i].branchIsIdleLoop = true;
+				return;
+			}
+			continue;
+		}
+
+		if ((op.opinfo->type != OPTYPE_INTEGER && op.opinfo->type != OPTYPE_LOAD) || op.canEndBlock ||
+		    (op.opinfo->flags & (FL_EVIL | FL_READ_CA)))
+			return;
+
+		if (op.opinfo->type == OPTYPE_LOAD)
+		{
+			// lwz, lbz, lhz and lha. The small data anchors r2 and r13 always point
+			// to RAM, other bases need a value set in the loop.
+			const UGeckoInstruction inst = op.inst;
+			if (inst.OPCD != 32 && inst.OPCD != 34 && inst.OPCD != 40 && inst.OPCD != 42)
+				return;
+			if (inst.RA == 0 || known[inst.RA])
+			{
+				u32 address = (inst.RA ? values[inst.RA] : 0) + (u32)(s32)inst.SIMM_16;
+				if (!PowerPC::HostIsRAMAddress(address))
+					return;
+			}
+			else if ((inst.RA != 2 && inst.RA != 13) || written[inst.RA])
+			{
+				return;
+			}
+		}
+
+		read_first |= op.regsIn & ~written;
+		if (op.regsOut & read_first)
+			return;
+		written |= op.regsOut;
+
+		u32 result = 0;
+		int dest = GetConstantResult(op.inst, known, values, &result);
+		known &= ~op.regsOut;
+		if (dest >= 0)
+		{
+			known[dest] = true;
+			values[dest] = result;
+		}
+
+		int cr_out = -1;
+		if (op.opinfo->flags & FL_SET_CRn)
+			cr_out = op.inst.CRFD;
+		else if (op.outputCR0)
+			cr_out = 0;
+		if (cr_out >= 0)
+		{
+			if (cr_read_first[cr_out])
+				return;
+			cr_written[cr_out] = true;
+		}
+	}
+}
+
+bool PPCAnalyzer::CanFollowBranch(u32 address, UGeckoInstruction inst, u32* destination) const
+{
+	bool conditional;
+	if (inst.OPCD == 18 && !inst.LK)
+	{
+		conditional = false;
+		*destination = inst.AA ? SignExt26(inst.LI << 2) : address + SignExt26(inst.LI << 2);
+	}
+	else if (inst.OPCD == 16 && !inst.LK &&
+	         ((inst.BO & BO_DONT_DECREMENT_FLAG) == 0 || (inst.BO & BO_DONT_CHECK_CONDITION) == 0))
+	{
+		conditional = true;
+		*destination = inst.AA ? SignExt16(inst.BD << 2) : address + SignExt16(inst.BD << 2);
+	}
+	else
+	{
+		return false;
+	}
+
+	if (conditional && (!m_taken_branches || !m_taken_branches->count(address)))
+		return false;
+
+	// Only forward and within the page, so the block's range still covers all
+	// of its instructions and the address translation stays the same.
+	return *destination > address && (*destination & ~0xfff) == (address & ~0xfff);
+}
+
 u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32 blockSize)
 {
 	// Clear block stats
@@ -642,6 +907,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 	block->m_broken = false;
 	block->m_memory_exception = false;
 	block->m_num_instructions = 0;
+	block->m_span = 0;
 	block->m_gqr_used = BitSet8(0);
 
 	CodeOp *code = buffer->codebuffer;
@@ -674,6 +940,7 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 		prev_inst_from_bat = result.from_bat;
 
 		num_inst++;
+		block->m_span = std::max(block->m_span, (address - block->m_address) / 4 + 1);
 		memset(&code[i], 0, sizeof(CodeOp));
 		GekkoOPInfo *opinfo = GetOpInfo(inst);
 
@@ -768,6 +1035,16 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 			}
 		}
 
+		if (HasOption(OPTION_TRACE) && !follow && numFollows < TRACE_FOLLOWING_THRESHOLD &&
+		    i + 1 < blockSize && CanFollowBranch(address, inst, &destination))
+		{
+			code[i].branchTo = destination;
+			code[i].branchFollowed = true;
+			numFollows++;
+			address = destination;
+			continue;
+		}
+
 		if (!follow)
 		{
 			address += 4;
@@ -793,9 +1070,19 @@ u32 PPCAnalyzer::Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32
 
 	block->m_num_instructions = num_inst;
 
+	// In program order, before compares are moved next to their branches.
+	if (HasOption(OPTION_IDLE_LOOPS))
+		FindIdleLoop(block, block->m_num_instructions, code);
+
 	if (block->m_num_instructions > 1)
 		ReorderInstructions(block->m_num_instructions, code);
 
+	if (HasOption(OPTION_CONSTANT_PROPAGATION))
+	{
+		PropagateConstants(block->m_num_instructions, code);
+		EliminateDeadCode(block->m_num_instructions, code);
+	}
+
 	if ((!found_exit && num_inst > 0) || blockSize == 1)
 	{
 		// We couldn't find an exit
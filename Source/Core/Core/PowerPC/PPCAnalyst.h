@@ -8,6 +8,7 @@
 #include <cstdlib>
 #include <map>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "Common/BitSet.h"
@@ -43,6 +44,16 @@ struct CodeOp //16B
 	bool outputCA;
 	bool canEndBlock;
 	bool skip;  // followed BL-s for example
+	// The block continues at branchTo instead of the next instruction, so
+	// not taking the branch leaves the block.
+	bool branchFollowed;
+	// Taking this branch starts another iteration of a busy wait loop, which
+	// would do exactly what the last one did (OPTION_IDLE_LOOPS).
+	bool branchIsIdleLoop;
+	// D-form load/store whose base register is known to be constant at this
+	// point in the block (OPTION_CONSTANT_PROPAGATION): the effective address.
+	bool hasConstantAddress;
+	u32 constantAddress;
 	// which registers are still needed after this instruction in this block
 	BitSet32 fprInUse;
 	BitSet32 gprInUse;
@@ -147,6 +158,10 @@ struct CodeBlock
 	// Gives us the size of the block.
 	u32 m_num_instructions;
 
+	// Number of instruction words from m_address to the last instruction. Only
+	// differs from m_num_instructions when the block follows branches.
+	u32 m_span;
+
 	// Some basic statistics about the block.
 	BlockStats *m_stats;
 
@@ -180,9 +195,15 @@ private:
 	void ReorderInstructionsCore(u32 instructions, CodeOp* code, bool reverse, ReorderType type);
 	void ReorderInstructions(u32 instructions, CodeOp *code);
 	void SetInstructionStats(CodeBlock *block, CodeOp *code, GekkoOPInfo *opinfo, u32 index);
+	void PropagateConstants(u32 instructions, CodeOp *code);
+	void EliminateDeadCode(u32 instructions, CodeOp *code);
+	void FindIdleLoop(CodeBlock *block, u32 instructions, CodeOp *code);
 
 	// Options
 	u32 m_options;
+	const std::unordered_set<u32>* m_taken_branches;
+
+	bool CanFollowBranch(u32 address, UGeckoInstruction inst, u32* destination) const;
 public:
 
 	enum AnalystOption
@@ -221,15 +242,43 @@ public:
 
 		// Reorder cror instructions next to their associated fcmp.
 		OPTION_CROR_MERGE =  (1 << 6),
+
+		// Form traces: follow forward branches that are usually taken (see
+		// SetTakenBranches) and unconditional ones, so the block covers the hot
+		// path and the not-taken side becomes an exit.
+		// Requires JIT support for CodeOp::branchFollowed.
+		OPTION_TRACE = (1 << 7),
+
+		// Track GPRs holding constants (li/lis/addi/ori chains) and record the
+		// effective address of loads and stores based on them. Also marks
+		// integer ops as skip when their result is overwritten before it's read,
+		// with nothing in between that can leave the block.
+		// Requires JIT support for CodeOp::hasConstantAddress and CodeOp::skip.
+		OPTION_CONSTANT_PROPAGATION = (1 << 8),
+
+		// Find busy wait loops: blocks that branch back to their start after
+		// only loading from RAM, computing and comparing, such as polling a
+		// flag set by an interrupt handler. Loads must use a constant RAM
+		// address or r2/r13; loops polling MMIO are not idle, as registers like
+		// the VI beam position change without an event. Skipping to the next
+		// event can't change what the guest sees there, as only events change RAM.
+		// Requires JIT support for CodeOp::branchIsIdleLoop.
+		OPTION_IDLE_LOOPS = (1 << 9),
 	};
 
 
-	PPCAnalyzer() : m_options(0) {}
+	PPCAnalyzer() : m_options(0), m_taken_branches(nullptr) {}
 
 	// Option setting/getting
 	void SetOption(AnalystOption option) { m_options |= option; }
 	void ClearOption(AnalystOption option) { m_options &= ~(option); }
 	bool HasOption(AnalystOption option) const { return !!(m_options & option); }
+	u32 GetOptions() const { return m_options; }
+	void SetOptions(u32 options) { m_options = options; }
+
+	// Addresses of conditional branches that were taken most of the time, as
+	// recorded by the JIT. Used by OPTION_TRACE.
+	void SetTakenBranches(const std::unordered_set<u32>* branches) { m_taken_branches = branches; }
 
 	u32 Analyze(u32 address, CodeBlock *block, CodeBuffer *buffer, u32 blockSize);
 };
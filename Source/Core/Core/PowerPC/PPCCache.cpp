@@ -75,6 +75,17 @@ namespace PowerPC
 		Reset();
 	}
 
+	// The lookup table entry of the line cached with this tag in this set.
+	u8* InstructionCache::GetLookup(u32 tag, u32 set)
+	{
+		if (tag & (ICACHE_VMEM_BIT >> 12))
+			return &lookup_table_vmem[((tag << 7) | set) & 0xfffff];
+		else if (tag & (ICACHE_EXRAM_BIT >> 12))
+			return &lookup_table_ex[((tag << 7) | set) & 0x1fffff];
+		else
+			return &lookup_table[((tag << 7) | set) & 0xfffff];
+	}
+
 	void InstructionCache::Invalidate(u32 addr)
 	{
 		if (!HID0.ICE)
@@ -83,18 +94,56 @@ namespace PowerPC
 		u32 set = (addr >> 5) & 0x7f;
 		for (int i = 0; i < 8; i++)
 			if (valid[set] & (1 << i))
-			{
-				if (tags[set][i] & (ICACHE_VMEM_BIT >> 12))
-					lookup_table_vmem[((tags[set][i] << 7) | set) & 0xfffff] = 0xff;
-				else if (tags[set][i] & (ICACHE_EXRAM_BIT >> 12))
-					lookup_table_ex[((tags[set][i] << 7) | set) & 0x1fffff] = 0xff;
-				else
-					lookup_table[((tags[set][i] << 7) | set) & 0xfffff] = 0xff;
-			}
+				*GetLookup(tags[set][i], set) = 0xff;
 		valid[set] = 0;
 		JitInterface::InvalidateICache(addr & ~0x1f, 32, false);
 	}
 
+	void InstructionCache::InvalidateRange(u32 addr, u32 size)
+	{
+		if (!size)
+			return;
+
+		u32 first_line = addr >> 5;
+		u32 last_line = (u32)(((u64)addr + size - 1) >> 5);
+
+		if (HID0.ICE)
+		{
+			if (last_line - first_line >= ICACHE_SETS * ICACHE_WAYS)
+			{
+				// More lines than the cache holds. Dropping everything is cheaper than
+				// working out which lines alias the range, and refetching is harmless.
+				for (u32 set = 0; set < ICACHE_SETS; set++)
+				{
+					for (u32 way = 0; way < ICACHE_WAYS; way++)
+					{
+						if (valid[set] & (1 << way))
+							*GetLookup(tags[set][way], set) = 0xff;
+					}
+					valid[set] = 0;
+				}
+			}
+			else
+			{
+				// The lookup tables give the way of each cached line directly, so
+				// only the lines actually in the cache are touched.
+				for (u32 line = first_line; line <= last_line; line++)
+				{
+					u32 tag = line >> 7;
+					u32 set = line & 0x7f;
+					u8* lookup = GetLookup(tag, set);
+					if (*lookup != 0xff)
+					{
+						valid[set] &= ~(1 << *lookup);
+						*lookup = 0xff;
+					}
+				}
+			}
+		}
+
+		JitInterface::InvalidateICache(first_line << 5, (last_line - first_line + 1) << 5, false);
+	}
+
 	u32 InstructionCache::ReadInstruction(u32 addr)
 	{
 		if (!HID0.ICE) // instruction cache is disabled
@@ -128,14 +177,7 @@ namespace PowerPC
 			// load
 			Memory::CopyFromEmu((u8*)data[set][t], (addr & ~0x1f), 32);
 			if (valid[set] & (1 << t))
-			{
-				if (tags[set][t] & (ICACHE_VMEM_BIT >> 12))
-					lookup_table_vmem[((tags[set][t] << 7) | set) & 0xfffff] = 0xff;
-				else if (tags[set][t] & (ICACHE_EXRAM_BIT >> 12))
-					lookup_table_ex[((tags[set][t] << 7) | set) & 0x1fffff] = 0xff;
-				else
-					lookup_table[((tags[set][t] << 7) | set) & 0xfffff] = 0xff;
-			}
+				*GetLookup(tags[set][t], set) = 0xff;
 
 			if (addr & ICACHE_VMEM_BIT)
 				lookup_table_vmem[(addr >> 5) & 0xfffff] = t;
@@ -34,8 +34,15 @@ namespace PowerPC
 		InstructionCache();
 		u32 ReadInstruction(u32 addr);
 		void Invalidate(u32 addr);
+		// Drops the cached lines and the JIT blocks covering [addr, addr + size)
+		// at once, for memory rewritten behind the CPU's back (DMA, patches).
+		// Unlike Invalidate, it doesn't need the cache to be enabled.
+		void InvalidateRange(u32 addr, u32 size);
 		void Init();
 		void Reset();
+
+	private:
+		u8* GetLookup(u32 tag, u32 set);
 	};
 
 }
@@ -65,6 +65,11 @@ GekkoOPInfo *GetOpInfo(UGeckoInstruction _inst)
 
 Interpreter::Instruction GetInterpreterOp(UGeckoInstruction _inst)
 {
+	// The callers decode each instruction once, so they can skip the field
+	// checks that the plain handlers make on every execution.
+	if (Interpreter::Instruction decoded = InterpreterTables::GetDecodedOp(_inst))
+		return decoded;
+
 	const GekkoOPInfo *info = m_infoTable[_inst.OPCD];
 	if ((info->type & 0xFFFFFF) == OPTYPE_SUBTABLE)
 	{
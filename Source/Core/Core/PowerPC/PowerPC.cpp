@@ -20,6 +20,7 @@
 #include "Core/PowerPC/JitInterface.h"
 #include "Core/PowerPC/PowerPC.h"
 #include "Core/PowerPC/PPCTables.h"
+#include "Core/PowerPC/Profiler.h"
 #include "Core/PowerPC/Interpreter/Interpreter.h"
 
 
@@ -59,7 +60,7 @@ void ExpandCR(u32 cr)
 	}
 }
 
-void DoState(PointerWrap &p)
+void DoState(PointerWrap &p, bool rollback)
 {
 	// some of this code has been disabled, because
 	// it changes registers even in MODE_MEASURE (which is suspicious and seems like it could cause desyncs)
@@ -69,11 +70,13 @@ void DoState(PointerWrap &p)
 	// *((u64 *)&TL) = SystemTimers::GetFakeTimeBase(); //works since we are little endian and TL comes first :)
 
 	p.DoPOD(ppcState);
+	if (p.GetMode() == PointerWrap::MODE_READ)
+		InvalidateFastTLB();
 
 	// SystemTimers::DecrementerSet();
 	// SystemTimers::TimeBaseSet();
 
-	JitInterface::DoState(p);
+	JitInterface::DoState(p, rollback);
 }
 
 static void ResetRegisters()
@@ -135,6 +138,7 @@ void Init(int cpu_core)
 			}
 		}
 	}
+	InvalidateFastTLB();
 
 	ResetRegisters();
 	PPCTables::InitTables(cpu_core);
@@ -173,10 +177,13 @@ void Init(int cpu_core)
 
 	if (SConfig::GetInstance().bEnableDebugging)
 		breakpoints.ClearAllTemporary();
+
+	Profiler::Init();
 }
 
 void Shutdown()
 {
+	Profiler::Shutdown();
 	JitInterface::Shutdown();
 	interpreter->Shutdown();
 	cpu_core_base = nullptr;
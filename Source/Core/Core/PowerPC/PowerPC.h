@@ -56,6 +56,19 @@ struct tlb_entry
 	u8 recent;
 };
 
+// A direct-mapped cache of page table translations to RAM, which the JIT
+// probes inline in MMU mode before falling back to the full translation.
+// fast_tlb[0] is used for reads and fast_tlb[1] for writes; a page only goes
+// into the latter once its C bit is set.
+#define FAST_TLB_SIZE 1024
+
+struct fast_tlb_entry
+{
+	u32 tag;             // Effective address of the page, or TLB_TAG_INVALID.
+	u32 padding;
+	uintptr_t host_base; // Host address of the page minus tag.
+};
+
 // This contains the entire state of the emulated PowerPC "Gekko" CPU.
 struct PowerPCState
 {
@@ -144,7 +157,8 @@ extern PPCDebugInterface debug_interface;
 
 void Init(int cpu_core);
 void Shutdown();
-void DoState(PointerWrap &p);
+// rollback keeps the JIT blocks, see State::LoadFromBufferOnCPUThread.
+void DoState(PointerWrap &p, bool rollback = false);
 
 CoreMode GetMode();
 void SetMode(CoreMode _coreType);
@@ -264,6 +278,13 @@ void ClearCacheLine(const u32 address); // Zeroes 32 bytes; address should be 32
 // TLB functions
 void SDRUpdated();
 void InvalidateTLBEntry(u32 address);
+// Also drops the page table mappings in the logical fastmem arena.
+void InvalidateFastTLB();
+// Called when a JIT fastmem access to the logical arena faults. Maps the page
+// if the page table translates it to RAM, so that the access can be retried.
+bool MapLogicalPageForFastmem(u32 address, bool write);
+
+extern fast_tlb_entry fast_tlb[2][FAST_TLB_SIZE];
 
 // Result changes based on the BAT registers and MSR.DR.  Returns whether
 // it's safe to optimize a read or write to this address to an unguarded
@@ -2,8 +2,28 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <chrono>
+#include <map>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Event.h"
+#include "Common/FileUtil.h"
+#include "Common/Logging/Log.h"
+#include "Common/StringUtil.h"
+#include "Common/Thread.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
 #include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCSymbolDB.h"
 #include "Core/PowerPC/Profiler.h"
 
 namespace Profiler
@@ -16,4 +36,273 @@ void WriteProfileResults(const std::string& filename)
 	JitInterface::WriteProfileResults(filename);
 }
 
+// Deep enough for any sane guest call chain, and bounds the walk when the
+// back chain is garbage.
+static const int MAX_STACK_DEPTH = 64;
+
+static std::thread s_sampler_thread;
+static Common::Event s_sampler_wakeup;
+static std::atomic<bool> s_sampling{false};
+// Set by the sampler thread, and polled by CoreTiming::Advance. Requests
+// don't pile up while the emulation is paused, and as no event is scheduled
+// for them, they never end up in savestates.
+static std::atomic<bool> s_sample_requested{false};
+
+// Raw stacks, innermost address first. Attributing them to functions is left
+// to the readers, as symbols may be loaded after the samples were taken.
+static std::mutex s_samples_lock;
+static std::map<std::vector<u32>, u64> s_stacks;
+static u64 s_sample_count;
+
+static bool IsStackBottom(u32 addr)
+{
+	return !addr || !PowerPC::HostIsRAMAddress(addr);
+}
+
+static void TakeSample()
+{
+	std::vector<u32> stack;
+	stack.push_back(PC);
+	// LR is the return address of a leaf function, which doesn't show up in
+	// the back chain. For other functions, it's the same as the first saved
+	// LR once the prologue is done.
+	if (LR)
+		stack.push_back(LR);
+
+	u32 sp = PowerPC::ppcState.gpr[1];
+	if (!IsStackBottom(sp))
+	{
+		u32 frame = PowerPC::HostRead_U32(sp);
+		while (!IsStackBottom(frame) && stack.size() < MAX_STACK_DEPTH)
+		{
+			u32 return_address = PowerPC::HostRead_U32(frame + 4);
+			if (!return_address)
+				break;
+			if (stack.size() != 2 || return_address != stack.back())
+				stack.push_back(return_address);
+			frame = PowerPC::HostRead_U32(frame);
+		}
+	}
+
+	std::lock_guard<std::mutex> lk(s_samples_lock);
+	s_stacks[stack]++;
+	s_sample_count++;
+}
+
+static void SamplerThread(u32 interval_us)
+{
+	Common::SetCurrentThreadName("Sampling profiler");
+
+	const std::chrono::microseconds interval(interval_us);
+	while (s_sampling.load(std::memory_order_relaxed))
+	{
+		s_sampler_wakeup.WaitFor(interval);
+		if (!s_sampling.load(std::memory_order_relaxed))
+			break;
+
+		if (!Core::g_want_determinism)
+			s_sample_requested.store(true, std::memory_order_relaxed);
+	}
+}
+
+void TakeRequestedSample()
+{
+	if (!s_sample_requested.load(std::memory_order_relaxed))
+		return;
+
+	s_sample_requested.store(false, std::memory_order_relaxed);
+	if (s_sampling.load(std::memory_order_relaxed))
+		TakeSample();
+}
+
+void Init()
+{
+	if (SConfig::GetInstance().bSamplingProfiler)
+	{
+		ClearSamples();
+		StartSampling();
+	}
+}
+
+void Shutdown()
+{
+	StopSampling();
+
+	if (SConfig::GetInstance().bSamplingProfiler && GetSampleCount())
+	{
+		std::string filename = File::GetUserPath(D_DUMP_IDX) + "Profiler/" +
+		                       SConfig::GetInstance().GetUniqueID() + ".folded";
+		File::CreateFullPath(filename);
+		WriteFoldedStacks(filename);
+		NOTICE_LOG(POWERPC, "Wrote %" PRIu64 " profiler samples to %s", GetSampleCount(), filename.c_str());
+	}
+
+	if (SConfig::GetInstance().bIdleLoopStats && !CoreTiming::GetIdleLoopStats().empty())
+	{
+		std::string filename = File::GetUserPath(D_DUMP_IDX) + "Profiler/" +
+		                       SConfig::GetInstance().GetUniqueID() + ".idle.txt";
+		File::CreateFullPath(filename);
+		WriteIdleLoopStats(filename);
+		NOTICE_LOG(POWERPC, "Wrote idle loop statistics to %s", filename.c_str());
+	}
+}
+
+void StartSampling(u32 interval_us)
+{
+	if (s_sampling)
+		return;
+
+	// The samples are scheduled from the host clock, so they would change the
+	// timing of the emulated CPU.
+	if (Core::g_want_determinism)
+	{
+		WARN_LOG(POWERPC, "The sampling profiler is not available during netplay or movie play/record.");
+		return;
+	}
+
+	s_sampling = true;
+	s_sample_requested = false;
+	s_sampler_thread = std::thread(SamplerThread, interval_us);
+}
+
+void StopSampling()
+{
+	if (!s_sampling)
+		return;
+
+	s_sampling = false;
+	s_sampler_wakeup.Set();
+	s_sampler_thread.join();
+}
+
+bool IsSampling()
+{
+	return s_sampling;
+}
+
+void ClearSamples()
+{
+	std::lock_guard<std::mutex> lk(s_samples_lock);
+	s_stacks.clear();
+	s_sample_count = 0;
+}
+
+u64 GetSampleCount()
+{
+	std::lock_guard<std::mutex> lk(s_samples_lock);
+	return s_sample_count;
+}
+
+// Maps a stack of addresses to function start addresses, collapsing the
+// frames of recursive calls and of PC and LR in the same function.
+static std::vector<u32> ResolveStack(const std::vector<u32>& stack)
+{
+	std::vector<u32> functions;
+	for (u32 address : stack)
+	{
+		Symbol* symbol = g_symbolDB.GetSymbolFromAddr(address);
+		u32 function = symbol ? symbol->address : address;
+		if (functions.empty() || functions.back() != function)
+			functions.push_back(function);
+	}
+	return functions;
+}
+
+static std::string GetFunctionName(u32 function)
+{
+	Symbol* symbol = g_symbolDB.GetSymbolFromAddr(function);
+	if (symbol && !symbol->name.empty())
+		return symbol->name;
+	return StringFromFormat("%08x", function);
+}
+
+std::vector<FunctionSamples> GetFunctionSamples()
+{
+	std::map<u32, FunctionSamples> functions;
+	{
+		std::lock_guard<std::mutex> lk(s_samples_lock);
+		for (const auto& stack : s_stacks)
+		{
+			std::vector<u32> resolved = ResolveStack(stack.first);
+			for (size_t i = 0; i < resolved.size(); ++i)
+			{
+				// Count recursive functions once per stack.
+				if (std::find(resolved.begin(), resolved.begin() + i, resolved[i]) != resolved.begin() + i)
+					continue;
+
+				FunctionSamples& samples = functions[resolved[i]];
+				samples.address = resolved[i];
+				samples.total += stack.second;
+				if (i == 0)
+					samples.self += stack.second;
+			}
+		}
+	}
+
+	std::vector<FunctionSamples> result;
+	for (auto& function : functions)
+	{
+		function.second.name = GetFunctionName(function.first);
+		result.push_back(function.second);
+	}
+	std::sort(result.begin(), result.end(), [](const FunctionSamples& a, const FunctionSamples& b) {
+		return a.self != b.self ? a.self > b.self : a.total > b.total;
+	});
+	return result;
+}
+
+void WriteFoldedStacks(const std::string& filename)
+{
+	std::map<std::string, u64> folded;
+	{
+		std::lock_guard<std::mutex> lk(s_samples_lock);
+		for (const auto& stack : s_stacks)
+		{
+			std::vector<u32> resolved = ResolveStack(stack.first);
+			std::string line;
+			for (auto it = resolved.rbegin(); it != resolved.rend(); ++it)
+			{
+				if (!line.empty())
+					line += ';';
+				line += GetFunctionName(*it);
+			}
+			folded[line] += stack.second;
+		}
+	}
+
+	File::IOFile f(filename, "w");
+	if (!f)
+	{
+		PanicAlert("Failed to open %s", filename.c_str());
+		return;
+	}
+	for (const auto& stack : folded)
+		fprintf(f.GetHandle(), "%s %" PRIu64 "\n", stack.first.c_str(), stack.second);
+}
+
+void WriteIdleLoopStats(const std::string& filename)
+{
+	std::vector<CoreTiming::IdleLoopStats> loops = CoreTiming::GetIdleLoopStats();
+	u64 total_cycles = 0;
+	for (const auto& loop : loops)
+		total_cycles += loop.cycles;
+
+	File::IOFile f(filename, "w");
+	if (!f)
+	{
+		PanicAlert("Failed to open %s", filename.c_str());
+		return;
+	}
+	fprintf(f.GetHandle(), "address   skips        cycles             %%      function\n");
+	for (const auto& loop : loops)
+	{
+		Symbol* symbol = g_symbolDB.GetSymbolFromAddr(loop.address);
+		fprintf(f.GetHandle(), "%08x  %-11" PRIu64 "  %-17" PRIu64 "  %5.2f  %s\n", loop.address, loop.count,
+		        loop.cycles, total_cycles ? 100.0 * loop.cycles / total_cycles : 0.0,
+		        symbol ? symbol->name.c_str() : "");
+	}
+	fprintf(f.GetHandle(), "total cycles skipped: %" PRIu64 ", idle ticks: %" PRIu64 "\n", total_cycles,
+	        CoreTiming::GetIdleTicks());
+}
+
 }  // namespace
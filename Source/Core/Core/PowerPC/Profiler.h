@@ -7,6 +7,7 @@
 
 #include <cstddef>
 #include <string>
+#include <vector>
 
 #include "Common/CommonTypes.h"
 
@@ -64,9 +65,69 @@ struct ProfileStats
 	u64 countsPerSec;
 };
 
+// Counters kept by the JIT cores, see JitInterface::GetStatistics.
+struct JitStatistics
+{
+	// Background compilation (Jit64).
+	u32 compile_queue_depth;
+	u64 async_compiles;
+	u64 async_compiles_dropped;
+	u64 time_to_native_us_total;
+	u64 time_to_native_us_max;
+
+	// Tiered compilation (Jit64).
+	u64 hot_recompiles;
+	// Conditional branches found to be taken most of the time, which hot
+	// blocks follow when trace formation is enabled.
+	u64 hot_taken_branches;
+
+	// Code space reclamation (Jit64).
+	u64 code_region_evictions;
+	u64 blocks_evicted;
+	u64 cache_clears;
+};
+
+// Samples attributed to a guest function by the sampling profiler.
+struct FunctionSamples
+{
+	std::string name;
+	u32 address;
+	u64 self;  // samples taken in the function itself
+	u64 total; // samples with the function anywhere on the stack
+};
+
 namespace Profiler
 {
 extern bool g_ProfileBlocks;
 
 void WriteProfileResults(const std::string& filename);
+
+// Sampling profiler. A host thread periodically requests a sample, which the
+// CPU thread takes at the next CoreTiming slice boundary: there, the guest PC,
+// LR and stack are consistent and no generated code has to be instrumented.
+// Call stacks are reconstructed from the guest back chain and attributed to
+// functions through g_symbolDB when the results are read.
+void Init();
+void Shutdown();
+
+void StartSampling(u32 interval_us = 1000);
+void StopSampling();
+
+// Takes the sample the sampler thread asked for, if any. Called by
+// CoreTiming::Advance.
+void TakeRequestedSample();
+
+bool IsSampling();
+void ClearSamples();
+u64 GetSampleCount();
+
+// Sorted by self samples.
+std::vector<FunctionSamples> GetFunctionSamples();
+// One "outer;...;inner count" line per distinct call stack, the input format
+// of flamegraph.pl.
+void WriteFoldedStacks(const std::string& filename);
+
+// The busy wait loops the JIT skipped (CoreTiming::GetIdleLoopStats), with
+// their functions.
+void WriteIdleLoopStats(const std::string& filename);
 }
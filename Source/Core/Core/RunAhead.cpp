@@ -0,0 +1,194 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cinttypes>
+#include <vector>
+
+#include "AudioCommon/AudioCommon.h"
+#include "Common/CommonTypes.h"
+#include "Common/Logging/Log.h"
+#include "Common/Timer.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/RunAhead.h"
+#include "Core/State.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "VideoCommon/VideoBackendBase.h"
+
+namespace RunAhead
+{
+
+enum Phase
+{
+	// Every field is run once and shown.
+	PHASE_OFF,
+	// The field after a load, which is kept but not shown.
+	PHASE_REAL,
+	// The fields after a save, which are rolled back. Only the last is shown.
+	PHASE_AHEAD,
+};
+
+static int s_frames;
+static Phase s_phase;
+// The number of the current field after the save, in PHASE_AHEAD.
+static int s_field;
+// Kept between the rollbacks, so that saving doesn't allocate.
+static std::vector<u8> s_state;
+
+static u64 s_start_us;
+static u64 s_save_us;
+static u64 s_count;
+static u64 s_save_sum;
+static u64 s_load_sum;
+static u64 s_time_sum;
+static u64 s_time_max;
+
+static void SetOutput(bool video, bool audio)
+{
+	g_video_backend->Video_SetRendering(video);
+	if (g_sound_stream)
+		g_sound_stream->GetMixer()->SetDropSamples(!audio);
+}
+
+void Init()
+{
+	s_frames = std::max(SConfig::GetInstance().iRunAheadFrames, 0);
+	if (s_frames && SConfig::GetInstance().bWii)
+	{
+		// What IPC_HLE does on the host, such as writing NAND files or sending
+		// network requests, isn't part of the state. Fields that are rolled
+		// back would do it, and then the real field would do it again.
+		WARN_LOG(COMMON, "Run-ahead is disabled on Wii, where the host side of IPC_HLE isn't rolled back.");
+		s_frames = 0;
+	}
+	s_phase = PHASE_OFF;
+	s_field = 0;
+	s_count = 0;
+	s_save_sum = 0;
+	s_load_sum = 0;
+	s_time_sum = 0;
+	s_time_max = 0;
+}
+
+void Shutdown()
+{
+	if (s_phase != PHASE_OFF)
+		SetOutput(true, true);
+	// Stopped before the rollback.
+	if (s_phase == PHASE_AHEAD)
+		JitInterface::DiscardRollback();
+	s_phase = PHASE_OFF;
+	std::vector<u8>().swap(s_state);
+
+	Stats stats = GetStats();
+	if (stats.count)
+	{
+		NOTICE_LOG(COMMON, "Run-ahead of %d fields: %" PRIu64 " us per field (max %" PRIu64 " us), of which saving %"
+		           PRIu64 " us and loading %" PRIu64 " us", s_frames, stats.mean_us, stats.max_us, stats.save_us,
+		           stats.load_us);
+	}
+}
+
+static void Save()
+{
+	s_start_us = Common::Timer::GetTimeUs();
+	State::SaveToBufferOnCPUThread(s_state);
+	s_save_us = Common::Timer::GetTimeUs() - s_start_us;
+
+	s_phase = PHASE_AHEAD;
+	s_field = 1;
+	SetOutput(s_frames == 1, false);
+}
+
+static void Load()
+{
+	u64 load_start = Common::Timer::GetTimeUs();
+	// The video caches and the JIT blocks are kept: the caches check guest
+	// memory anyway, and the blocks over code that changed are invalidated.
+	State::LoadFromBufferOnCPUThread(s_state);
+	u64 end = Common::Timer::GetTimeUs();
+
+	s_phase = PHASE_REAL;
+	// After the load, as the rendering flag is part of the state.
+	SetOutput(false, true);
+
+	u64 time = end - s_start_us;
+	s_count++;
+	s_save_sum += s_save_us;
+	s_load_sum += end - load_start;
+	s_time_sum += time;
+	s_time_max = std::max(s_time_max, time);
+}
+
+void EndField()
+{
+	if (!s_frames)
+		return;
+
+	switch (s_phase)
+	{
+	case PHASE_OFF:
+	case PHASE_REAL:
+		// Movies and netplay need every field to run once with the input of
+		// that field.
+		if (Core::g_want_determinism)
+		{
+			if (s_phase == PHASE_REAL)
+				SetOutput(true, true);
+			s_phase = PHASE_OFF;
+			return;
+		}
+		Save();
+		break;
+
+	case PHASE_AHEAD:
+		if (s_field < s_frames)
+		{
+			s_field++;
+			if (s_field == s_frames)
+			{
+				// The GPU thread may still be working on the previous field.
+				g_video_backend->PauseAndLock(true);
+				SetOutput(true, false);
+				g_video_backend->PauseAndLock(false);
+			}
+		}
+		else
+		{
+			Load();
+		}
+		break;
+	}
+}
+
+bool IsActive()
+{
+	return s_phase != PHASE_OFF;
+}
+
+bool IsRunningAhead()
+{
+	return s_phase == PHASE_AHEAD;
+}
+
+bool IsPresentingField()
+{
+	return s_phase == PHASE_OFF || (s_phase == PHASE_AHEAD && s_field == s_frames);
+}
+
+Stats GetStats()
+{
+	Stats stats = {};
+	stats.count = s_count;
+	if (!s_count)
+		return stats;
+	stats.save_us = s_save_sum / s_count;
+	stats.load_us = s_load_sum / s_count;
+	stats.mean_us = s_time_sum / s_count;
+	stats.max_us = s_time_max;
+	return stats;
+}
+
+}
@@ -0,0 +1,46 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include "Common/CommonTypes.h"
+
+// Hides the game's own input lag by showing a field from a few fields ahead.
+// After each field, the state is saved to memory, the next fields are run with
+// the output suppressed except for the last one, which is presented, and then
+// the state is loaded back. Used when SConfig::iRunAheadFrames is set, and not
+// during netplay or movies. Not on Wii either, as the NAND files and network
+// requests of IPC_HLE live on the host, and a load doesn't roll them back.
+namespace RunAhead
+{
+
+struct Stats
+{
+	u64 count;
+	// Means over the rollbacks.
+	u64 save_us;
+	u64 load_us;
+	// Host time per presented field spent on fields that were rolled back,
+	// including the save and the load.
+	u64 mean_us;
+	u64 max_us;
+};
+
+void Init();
+void Shutdown();
+
+// Called by VideoInterface at the end of each field, after the video backend.
+void EndField();
+
+// Whether fields are being rolled back at all.
+bool IsActive();
+// Whether the current field is going to be rolled back. The throttling skips
+// these fields.
+bool IsRunningAhead();
+// Whether the current field is shown. Always true when run-ahead isn't active.
+bool IsPresentingField();
+
+Stats GetStats();
+
+}
@@ -18,11 +18,13 @@
 #include "Core/ConfigManager.h"
 #include "Core/Core.h"
 #include "Core/CoreTiming.h"
+#include "Core/DSPEmulator.h"
 #include "Core/Host.h"
 #include "Core/Movie.h"
 #include "Core/State.h"
 #include "Core/HW/CPU.h"
 #include "Core/HW/DSP.h"
+#include "Core/HW/EXI.h"
 #include "Core/HW/HW.h"
 #include "Core/HW/Memmap.h"
 #include "Core/HW/SystemTimers.h"
@@ -69,7 +71,7 @@ static Common::Event g_compressAndDumpStateSyncEvent;
 static std::thread g_save_thread;
 
 // Don't forget to increase this after doing changes on the savestate system
-static const u32 STATE_VERSION = 49; // Last changed in PR 2149
+static const u32 STATE_VERSION = 50; // Last changed for the DVD thread read queue
 
 // Maps savestate versions to Dolphin versions.
 // Versions after 42 don't need to be added to this list,
@@ -160,7 +162,7 @@ static bool DoStateVersion(PointerWrap& p, std::string* version_created_by)
 	return true;
 }
 
-static std::string DoState(PointerWrap& p)
+static std::string DoState(PointerWrap& p, bool rollback = false)
 {
 	std::string version_created_by;
 	if (!DoStateVersion(p, &version_created_by))
@@ -173,14 +175,14 @@ static std::string DoState(PointerWrap& p)
 	}
 
 	// Begin with video backend, so that it gets a chance to clear its caches and writeback modified things to RAM
-	g_video_backend->DoState(p);
+	g_video_backend->DoState(p, rollback);
 	p.DoMarker("video_backend");
 
 	if (SConfig::GetInstance().bWii)
 		Wiimote::DoState(p);
 	p.DoMarker("Wiimote");
 
-	PowerPC::DoState(p);
+	PowerPC::DoState(p, rollback);
 	p.DoMarker("PowerPC");
 	HW::DoState(p);
 	p.DoMarker("HW");
@@ -207,24 +209,53 @@ void LoadFromBuffer(std::vector<u8>& buffer)
 	Core::PauseAndLock(false, wasUnpaused);
 }
 
-void SaveToBuffer(std::vector<u8>& buffer)
+static void SaveToBuffer(std::vector<u8>& buffer, bool rollback)
 {
-	bool wasUnpaused = Core::PauseAndLock(true);
-
 	u8* ptr = nullptr;
 	PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
 
-	DoState(p);
+	DoState(p, rollback);
 	const size_t buffer_size = reinterpret_cast<size_t>(ptr);
 	buffer.resize(buffer_size);
 
 	ptr = &buffer[0];
 	p.SetMode(PointerWrap::MODE_WRITE);
-	DoState(p);
+	DoState(p, rollback);
+}
 
+void SaveToBuffer(std::vector<u8>& buffer)
+{
+	bool wasUnpaused = Core::PauseAndLock(true);
+	SaveToBuffer(buffer, false);
 	Core::PauseAndLock(false, wasUnpaused);
 }
 
+// Core::PauseAndLock without the CPU, which is the caller. Its depth counter
+// belongs to the host threads, so it's left alone.
+static void LockOtherThreads(bool lock)
+{
+	_assert_msg_(COMMON, Core::IsCPUThread(), "Rollback state used off the CPU thread");
+	ExpansionInterface::PauseAndLock(lock, true);
+	DSP::GetDSPEmulator()->PauseAndLock(lock, true);
+	g_video_backend->PauseAndLock(lock, true);
+}
+
+void SaveToBufferOnCPUThread(std::vector<u8>& buffer)
+{
+	LockOtherThreads(true);
+	SaveToBuffer(buffer, true);
+	LockOtherThreads(false);
+}
+
+void LoadFromBufferOnCPUThread(std::vector<u8>& buffer)
+{
+	LockOtherThreads(true);
+	u8* ptr = &buffer[0];
+	PointerWrap p(&ptr, PointerWrap::MODE_READ);
+	DoState(p, true);
+	LockOtherThreads(false);
+}
+
 void VerifyBuffer(std::vector<u8>& buffer)
 {
 	bool wasUnpaused = Core::PauseAndLock(true);
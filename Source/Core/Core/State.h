@@ -50,10 +50,19 @@ void SaveAs(const std::string &filename, bool wait = false);
 void LoadAs(const std::string &filename);
 void VerifyAt(const std::string &filename);
 
+// The buffer is only reallocated when the state got bigger, so reusing it is
+// cheap.
 void SaveToBuffer(std::vector<u8>& buffer);
 void LoadFromBuffer(std::vector<u8>& buffer);
 void VerifyBuffer(std::vector<u8>& buffer);
 
+// For going back by a few frames (run-ahead), from the CPU thread in between
+// CoreTiming events. Only the threads running beside the CPU are stopped.
+// Loading keeps the video caches, and the JIT blocks other than the ones over
+// code invalidated since the save.
+void SaveToBufferOnCPUThread(std::vector<u8>& buffer);
+void LoadFromBufferOnCPUThread(std::vector<u8>& buffer);
+
 void LoadLastSaved(int i = 1);
 void SaveFirstSaved();
 void UndoSaveState();
@@ -182,6 +182,9 @@ void CCodeWindow::CreateMenuSymbols(wxMenuBar *pMenuBar)
 	pProfilerMenu->Append(IDM_PROFILE_BLOCKS, _("&Profile blocks"), wxEmptyString, wxITEM_CHECK);
 	pProfilerMenu->AppendSeparator();
 	pProfilerMenu->Append(IDM_WRITE_PROFILE, _("&Write to profile.txt, show"));
+	pProfilerMenu->AppendSeparator();
+	pProfilerMenu->Append(IDM_PROFILE_SAMPLING, _("&Sample guest functions"), wxEmptyString, wxITEM_CHECK);
+	pProfilerMenu->Append(IDM_WRITE_FOLDED_STACKS, _("Write sampled stacks to &folded.txt"));
 	pMenuBar->Append(pProfilerMenu, _("&Profiler"));
 }
 
@@ -196,6 +199,24 @@ void CCodeWindow::OnProfilerMenu(wxCommandEvent& event)
 		Profiler::g_ProfileBlocks = GetMenuBar()->IsChecked(IDM_PROFILE_BLOCKS);
 		Core::SetState(Core::CORE_RUN);
 		break;
+	case IDM_PROFILE_SAMPLING:
+		if (GetMenuBar()->IsChecked(IDM_PROFILE_SAMPLING))
+		{
+			Profiler::ClearSamples();
+			Profiler::StartSampling();
+		}
+		else
+		{
+			Profiler::StopSampling();
+		}
+		break;
+	case IDM_WRITE_FOLDED_STACKS:
+	{
+		std::string filename = File::GetUserPath(D_DUMP_IDX) + "Debug/folded.txt";
+		File::CreateFullPath(filename);
+		Profiler::WriteFoldedStacks(filename);
+		break;
+	}
 	case IDM_WRITE_PROFILE:
 		if (Core::GetState() == Core::CORE_RUN)
 			Core::SetState(Core::CORE_PAUSE);
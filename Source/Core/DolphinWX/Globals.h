@@ -244,6 +244,8 @@ enum
 	// Profiler
 	IDM_PROFILE_BLOCKS,
 	IDM_WRITE_PROFILE,
+	IDM_PROFILE_SAMPLING,
+	IDM_WRITE_FOLDED_STACKS,
 	// --------------------------------------------------------------
 
 	// --------------------------------------------------------------
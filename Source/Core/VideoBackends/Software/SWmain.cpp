@@ -94,7 +94,7 @@ bool VideoSoftware::Initialize(void *window_handle)
 	return true;
 }
 
-void VideoSoftware::DoState(PointerWrap& p)
+void VideoSoftware::DoState(PointerWrap& p, bool keep_caches)
 {
 	bool software = true;
 	p.Do(software);
@@ -53,7 +53,7 @@ class VideoSoftware : public VideoBackend
 	unsigned int PeekMessages() override;
 
 	void PauseAndLock(bool doLock, bool unpauseOnUnlock=true) override;
-	void DoState(PointerWrap &p) override;
+	void DoState(PointerWrap &p, bool keep_caches = false) override;
 
 public:
 	void CheckInvalidState() override;
@@ -189,10 +189,11 @@ void VideoBackendHardware::InitializeShared()
 	s_FifoShuttingDown.Clear();
 	memset((void*)&s_beginFieldArgs, 0, sizeof(s_beginFieldArgs));
 	m_invalid = false;
+	m_keep_caches = false;
 }
 
 // Run from the CPU thread
-void VideoBackendHardware::DoState(PointerWrap& p)
+void VideoBackendHardware::DoState(PointerWrap& p, bool keep_caches)
 {
 	bool software = false;
 	p.Do(software);
@@ -213,6 +214,7 @@ void VideoBackendHardware::DoState(PointerWrap& p)
 	if (p.GetMode() == PointerWrap::MODE_READ)
 	{
 		m_invalid = true;
+		m_keep_caches = keep_caches;
 
 		// Clear all caches that touch RAM
 		// (? these don't appear to touch any emulation state that gets saved. moved to on load only.)
@@ -227,7 +229,8 @@ void VideoBackendHardware::CheckInvalidState()
 		m_invalid = false;
 
 		BPReload();
-		TextureCacheBase::Invalidate();
+		if (!m_keep_caches)
+			TextureCacheBase::Invalidate();
 	}
 }
 
@@ -111,7 +111,9 @@ public:
 	virtual void PauseAndLock(bool doLock, bool unpauseOnUnlock = true) = 0;
 
 	// the implementation needs not do synchronization logic, because calls to it are surrounded by PauseAndLock now
-	virtual void DoState(PointerWrap &p) = 0;
+	// keep_caches is set for the quick loads of run-ahead, which go back by a few frames of the same game. The
+	// caches check the guest memory they were built from anyway, so they don't need to be thrown away then.
+	virtual void DoState(PointerWrap &p, bool keep_caches = false) = 0;
 
 	virtual void CheckInvalidState() = 0;
 
@@ -150,11 +152,12 @@ class VideoBackendHardware : public VideoBackend
 	void RegisterCPMMIO(MMIO::Mapping* mmio, u32 base) override;
 
 	void PauseAndLock(bool doLock, bool unpauseOnUnlock = true) override;
-	void DoState(PointerWrap &p) override;
+	void DoState(PointerWrap &p, bool keep_caches = false) override;
 
 	void UpdateWantDeterminism(bool want) override;
 
 	bool m_invalid;
+	bool m_keep_caches;
 
 public:
 	void CheckInvalidState() override;
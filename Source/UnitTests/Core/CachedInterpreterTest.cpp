@@ -0,0 +1,212 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_Tables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+static const u32 CODE_ADDRESS = 0x00003000;
+static const u32 DATA_ADDRESS = 0x00010000;
+static const u32 DATA_SIZE = 0x100;
+// r1 points at the data, and is never written by the generated code.
+static const u32 BASE_REGISTER = 1;
+
+struct RegisterState
+{
+	u32 gpr[32];
+	u64 cr_val[8];
+	u8 xer_ca;
+	u8 xer_so_ov;
+};
+
+static RegisterState SaveState()
+{
+	RegisterState state;
+	std::memcpy(state.gpr, PowerPC::ppcState.gpr, sizeof(state.gpr));
+	std::memcpy(state.cr_val, PowerPC::ppcState.cr_val, sizeof(state.cr_val));
+	state.xer_ca = PowerPC::ppcState.xer_ca;
+	state.xer_so_ov = PowerPC::ppcState.xer_so_ov;
+	return state;
+}
+
+static void LoadState(const RegisterState& state)
+{
+	std::memcpy(PowerPC::ppcState.gpr, state.gpr, sizeof(state.gpr));
+	std::memcpy(PowerPC::ppcState.cr_val, state.cr_val, sizeof(state.cr_val));
+	PowerPC::ppcState.xer_ca = state.xer_ca;
+	PowerPC::ppcState.xer_so_ov = state.xer_so_ov;
+}
+
+class CachedInterpreterTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		SConfig::GetInstance().bJITNoBlockCache = false;
+		// The code ends in a branch to itself, which isn't meant to idle.
+		SConfig::GetInstance().bSkipIdle = false;
+		InterpreterTables::InitTables();
+
+		// Only RAM is needed, Memory::Init would also want the devices behind MMIO.
+		m_ram.resize(Memory::RAM_SIZE);
+		Memory::m_pRAM = m_ram.data();
+		Memory::physical_base = m_ram.data();
+		// Address translation off.
+		MSR = 0;
+		PowerPC::ppcState.Exceptions = 0;
+
+		CoreTiming::Init();
+		jit = &m_cached_interpreter;
+		m_cached_interpreter.Init();
+	}
+
+	void TearDown() override
+	{
+		m_cached_interpreter.Shutdown();
+		jit = nullptr;
+		CoreTiming::Shutdown();
+		Memory::m_pRAM = nullptr;
+		Memory::physical_base = nullptr;
+		SConfig::Shutdown();
+	}
+
+	u32 RandomRegister()
+	{
+		// Leaves r0 out as well, which means 0 rather than a register to some
+		// instructions.
+		u32 reg;
+		do
+			reg = m_rng() % 32;
+		while (reg == 0 || reg == BASE_REGISTER);
+		return reg;
+	}
+
+	// Forms the cached interpreter has handlers for, the record forms of some
+	// of them, and a few instructions which go through the interpreter table.
+	u32 RandomInstruction()
+	{
+		u32 d = RandomRegister(), a = RandomRegister(), b = RandomRegister();
+		u32 imm = m_rng() & 0xFFFF;
+		u32 rc = m_rng() % 4 == 0;
+		u32 crf = m_rng() % 8;
+		switch (m_rng() % 20)
+		{
+		case 0:  return (14u << 26) | (d << 21) | (0 << 16) | imm;      // li
+		case 1:  return (14u << 26) | (d << 21) | (a << 16) | imm;      // addi
+		case 2:  return (15u << 26) | (d << 21) | (0 << 16) | imm;      // lis
+		case 3:  return (15u << 26) | (d << 21) | (a << 16) | imm;      // addis
+		case 4:  return (24u << 26) | (d << 21) | (a << 16) | imm;      // ori
+		case 5:  return (25u << 26) | (d << 21) | (a << 16) | imm;      // oris
+		case 6:  return (21u << 26) | (d << 21) | (a << 16) | ((m_rng() & 0x7FFF) << 1) | rc; // rlwinm
+		case 7:  return (31u << 26) | (d << 21) | (a << 16) | (b << 11) | (266 << 1) | rc; // add
+		case 8:  return (31u << 26) | (d << 21) | (a << 16) | (b << 11) | (40 << 1) | rc;  // subf
+		case 9:  return (31u << 26) | (d << 21) | (a << 16) | (b << 11) | (444 << 1) | rc; // or
+		case 10: return (31u << 26) | (d << 21) | (a << 16) | (b << 11) | (28 << 1) | rc;  // and
+		case 11: return (11u << 26) | (crf << 23) | (a << 16) | imm;    // cmpi
+		case 12: return (10u << 26) | (crf << 23) | (a << 16) | imm;    // cmpli
+		case 13: return (31u << 26) | (crf << 23) | (a << 16) | (b << 11) | (0 << 1);  // cmp
+		case 14: return (31u << 26) | (crf << 23) | (a << 16) | (b << 11) | (32 << 1); // cmpl
+		case 15: return (31u << 26) | (d << 21) | (a << 16) | (b << 11) | (316 << 1) | rc; // xor
+		case 16: return (31u << 26) | (d << 21) | (a << 16) | (b << 11) | (10 << 1);   // addc
+		default:
+		{
+			// lwz, lhz, lbz, stw, sth, stb off the base register
+			static const u32 opcodes[] = {32, 40, 34, 36, 44, 38};
+			static const u32 sizes[] = {4, 2, 1, 4, 2, 1};
+			u32 i = m_rng() % 6;
+			u32 offset = (m_rng() % DATA_SIZE) & ~(sizes[i] - 1);
+			return (opcodes[i] << 26) | (d << 21) | (BASE_REGISTER << 16) | offset;
+		}
+		}
+	}
+
+	void RandomizeState()
+	{
+		for (u32& gpr : PowerPC::ppcState.gpr)
+			gpr = m_rng() % 4 ? m_rng() : m_rng() % 64;
+		PowerPC::ppcState.gpr[BASE_REGISTER] = DATA_ADDRESS;
+		for (int i = 0; i < 8; i++)
+			SetCRField(i, m_rng() & 0xF);
+		PowerPC::ppcState.xer_ca = m_rng() & 1;
+		PowerPC::ppcState.xer_so_ov = m_rng() & 3;
+		for (u32 i = 0; i < DATA_SIZE; i++)
+			m_ram[DATA_ADDRESS + i] = (u8)m_rng();
+	}
+
+	std::vector<u8> m_ram;
+	CachedInterpreter m_cached_interpreter;
+	std::mt19937 m_rng{1234};
+};
+
+TEST_F(CachedInterpreterTest, MatchesInterpreter)
+{
+	const u32 NUM_INSTRUCTIONS = 64;
+	const u32 end_address = CODE_ADDRESS + NUM_INSTRUCTIONS * 4;
+
+	for (int run = 0; run < 100; run++)
+	{
+		for (u32 i = 0; i < NUM_INSTRUCTIONS; i++)
+			Memory::Write_U32(RandomInstruction(), CODE_ADDRESS + i * 4);
+		// b .
+		Memory::Write_U32(0x48000000, end_address);
+		m_cached_interpreter.ClearCache();
+
+		RandomizeState();
+		RegisterState before = SaveState();
+		std::vector<u8> data_before(&m_ram[DATA_ADDRESS], &m_ram[DATA_ADDRESS + DATA_SIZE]);
+
+		PC = CODE_ADDRESS;
+		while (PC != end_address)
+			Interpreter::getInstance()->SingleStep();
+		RegisterState expected = SaveState();
+		std::vector<u8> expected_data(&m_ram[DATA_ADDRESS], &m_ram[DATA_ADDRESS + DATA_SIZE]);
+
+		LoadState(before);
+		std::copy(data_before.begin(), data_before.end(), &m_ram[DATA_ADDRESS]);
+		PC = CODE_ADDRESS;
+		// The first step compiles the block.
+		while (PC != end_address)
+			m_cached_interpreter.SingleStep();
+		RegisterState actual = SaveState();
+		std::vector<u8> actual_data(&m_ram[DATA_ADDRESS], &m_ram[DATA_ADDRESS + DATA_SIZE]);
+
+		ASSERT_EQ(0, std::memcmp(expected.gpr, actual.gpr, sizeof(expected.gpr))) << "run " << run;
+		ASSERT_EQ(0, std::memcmp(expected.cr_val, actual.cr_val, sizeof(expected.cr_val))) << "run " << run;
+		ASSERT_EQ(expected.xer_ca, actual.xer_ca) << "run " << run;
+		ASSERT_EQ(expected.xer_so_ov, actual.xer_so_ov) << "run " << run;
+		ASSERT_TRUE(expected_data == actual_data) << "run " << run;
+	}
+}
+
+TEST_F(CachedInterpreterTest, CompilesBlockOnce)
+{
+	// li r3, 1; addi r3, r3, 1; b .
+	Memory::Write_U32(0x38600001, CODE_ADDRESS);
+	Memory::Write_U32(0x38630001, CODE_ADDRESS + 4);
+	Memory::Write_U32(0x48000000, CODE_ADDRESS + 8);
+
+	PC = CODE_ADDRESS;
+	m_cached_interpreter.SingleStep();
+	// Compiling doesn't run anything.
+	EXPECT_EQ(CODE_ADDRESS, PC);
+	EXPECT_LE(0, m_cached_interpreter.GetBlockCache()->GetBlockNumberFromStartAddress(CODE_ADDRESS));
+
+	m_cached_interpreter.SingleStep();
+	EXPECT_EQ(CODE_ADDRESS + 8, PC);
+	EXPECT_EQ(2u, rGPR[3]);
+}
@@ -0,0 +1,207 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <thread>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/PowerPC/PowerPC.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+static std::vector<u64> s_fired;
+
+static void RecordCallback(u64 userdata, int cycles_late)
+{
+	s_fired.push_back(userdata);
+}
+
+class CoreTimingTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		Core::DeclareAsCPUThread();
+		CoreTiming::Init();
+		s_fired.clear();
+		m_type_a = CoreTiming::RegisterEvent("TestA", RecordCallback);
+		m_type_b = CoreTiming::RegisterEvent("TestB", RecordCallback);
+	}
+
+	void TearDown() override
+	{
+		CoreTiming::Shutdown();
+		Core::UndeclareAsCPUThread();
+		SConfig::Shutdown();
+	}
+
+	// Ends the current slice, which is longer than any of the delays used here.
+	void RunSlice()
+	{
+		PowerPC::ppcState.downcount = 0;
+		CoreTiming::Advance();
+	}
+
+	int m_type_a;
+	int m_type_b;
+};
+
+TEST_F(CoreTimingTest, FiresInTimeOrder)
+{
+	CoreTiming::ScheduleEvent(300, m_type_a, 3);
+	CoreTiming::ScheduleEvent(100, m_type_b, 1);
+	CoreTiming::ScheduleEvent(200, m_type_a, 2);
+	// Events due at the same time keep their scheduling order.
+	CoreTiming::ScheduleEvent(200, m_type_b, 4);
+	CoreTiming::ScheduleEvent(200, m_type_a, 5);
+
+	RunSlice();
+	EXPECT_EQ((std::vector<u64>{1, 2, 4, 5, 3}), s_fired);
+}
+
+TEST_F(CoreTimingTest, RemoveEvent)
+{
+	for (u64 i = 0; i < 10; i++)
+	{
+		CoreTiming::ScheduleEvent(100 + (int)i, m_type_a, i);
+		CoreTiming::ScheduleEvent(100 + (int)i, m_type_b, 100 + i);
+	}
+	CoreTiming::RemoveEvent(m_type_a);
+	// Events scheduled after the removal are kept.
+	CoreTiming::ScheduleEvent(50, m_type_a, 1000);
+
+	RunSlice();
+	ASSERT_EQ(11u, s_fired.size());
+	EXPECT_EQ(1000u, s_fired[0]);
+	for (u64 i = 0; i < 10; i++)
+		EXPECT_EQ(100 + i, s_fired[i + 1]);
+}
+
+TEST_F(CoreTimingTest, Threadsafe)
+{
+	std::thread thread([this] {
+		for (u64 i = 0; i < 100; i++)
+			CoreTiming::ScheduleEvent_Threadsafe(100, m_type_a, i);
+	});
+	thread.join();
+
+	RunSlice();
+	ASSERT_EQ(100u, s_fired.size());
+	for (u64 i = 0; i < 100; i++)
+		EXPECT_EQ(i, s_fired[i]);
+}
+
+TEST_F(CoreTimingTest, DoState)
+{
+	CoreTiming::ScheduleEvent(300, m_type_a, 3);
+	CoreTiming::ScheduleEvent(100, m_type_b, 1);
+	CoreTiming::ScheduleEvent(200, m_type_a, 2);
+	CoreTiming::ScheduleEvent(150, m_type_b, 7);
+	CoreTiming::RemoveEvent(m_type_b);
+	CoreTiming::ScheduleEvent(200, m_type_b, 4);
+
+	u8* ptr = nullptr;
+	PointerWrap measure(&ptr, PointerWrap::MODE_MEASURE);
+	CoreTiming::DoState(measure);
+	std::vector<u8> state(reinterpret_cast<size_t>(ptr));
+
+	ptr = state.data();
+	PointerWrap write(&ptr, PointerWrap::MODE_WRITE);
+	CoreTiming::DoState(write);
+
+	CoreTiming::ClearPendingEvents();
+	CoreTiming::ScheduleEvent(10, m_type_a, 99);
+
+	ptr = state.data();
+	PointerWrap read(&ptr, PointerWrap::MODE_READ);
+	CoreTiming::DoState(read);
+	ASSERT_EQ(PointerWrap::MODE_READ, read.GetMode());
+
+	RunSlice();
+	EXPECT_EQ((std::vector<u64>{2, 4, 3}), s_fired);
+}
+
+TEST_F(CoreTimingTest, AdaptiveSlicing)
+{
+	CoreTiming::Shutdown();
+	SConfig::GetInstance().bAdaptiveSlicing = true;
+	CoreTiming::Init();
+	m_type_a = CoreTiming::RegisterEvent("TestA", RecordCallback);
+
+	CoreTiming::ScheduleEvent(30000, m_type_a, 1);
+	CoreTiming::ScheduleEvent(30100, m_type_a, 2);
+	CoreTiming::ScheduleEvent(30500, m_type_a, 3);
+	CoreTiming::ScheduleEvent(1000000, m_type_a, 4);
+
+	// The first slice ends before any event.
+	RunSlice();
+	EXPECT_TRUE(s_fired.empty());
+	RunSlice();
+	EXPECT_EQ(std::vector<u64>{1}, s_fired);
+	// The other two events are close enough to run in one slice.
+	RunSlice();
+	EXPECT_EQ((std::vector<u64>{1, 2, 3}), s_fired);
+	EXPECT_EQ(3u, CoreTiming::GetSliceCount());
+	EXPECT_EQ(1u, CoreTiming::GetEmptySliceCount());
+
+	// Slices get longer while there is nothing to do.
+	int last_slice = CoreTiming::slicelength;
+	RunSlice();
+	EXPECT_GT(CoreTiming::slicelength, last_slice);
+	while (s_fired.size() < 4)
+		RunSlice();
+	// Fixed slices would have taken 49 more.
+	EXPECT_LT(CoreTiming::GetSliceCount(), 15u);
+}
+
+TEST_F(CoreTimingTest, ScheduleEndsLongSlice)
+{
+	CoreTiming::Shutdown();
+	SConfig::GetInstance().bAdaptiveSlicing = true;
+	CoreTiming::Init();
+	m_type_a = CoreTiming::RegisterEvent("TestA", RecordCallback);
+
+	CoreTiming::ScheduleEvent(1000000, m_type_a, 1);
+	for (int i = 0; i < 4; i++)
+		RunSlice();
+	int long_slice = CoreTiming::slicelength;
+	EXPECT_GT(long_slice, 20000);
+
+	// The CPU schedules an event while it is running the long slice.
+	CoreTiming::ScheduleEvent(500, m_type_a, 2);
+	EXPECT_LE(PowerPC::ppcState.downcount, 500);
+	RunSlice();
+	EXPECT_EQ(std::vector<u64>{2}, s_fired);
+	EXPECT_LT(CoreTiming::slicelength, long_slice);
+}
+
+TEST_F(CoreTimingTest, IdleLoopStats)
+{
+	SConfig::GetInstance().bSyncGPUOnSkipIdleHack = false;
+
+	CoreTiming::IdleLoop(0x80003000);
+	u64 first_skip = CoreTiming::GetIdleTicks();
+	RunSlice();
+	CoreTiming::IdleLoop(0x80004000);
+	RunSlice();
+	CoreTiming::IdleLoop(0x80004000);
+	u64 total = CoreTiming::GetIdleTicks();
+
+	std::vector<CoreTiming::IdleLoopStats> loops = CoreTiming::GetIdleLoopStats();
+	ASSERT_EQ(2u, loops.size());
+	// Most cycles first.
+	EXPECT_EQ(0x80004000u, loops[0].address);
+	EXPECT_EQ(2u, loops[0].count);
+	EXPECT_EQ(total - first_skip, loops[0].cycles);
+	EXPECT_EQ(0x80003000u, loops[1].address);
+	EXPECT_EQ(1u, loops[1].count);
+	EXPECT_EQ(first_skip, loops[1].cycles);
+	EXPECT_GT(first_skip, 0u);
+}
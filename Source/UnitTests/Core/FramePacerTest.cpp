@@ -0,0 +1,56 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/Timer.h"
+#include "Core/HW/FramePacer.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+TEST(FramePacer, FrameTimeStats)
+{
+	FramePacer::ClearFrameTimes();
+	for (int i = 0; i < 98; i++)
+		FramePacer::RecordFrameTime(16683);
+	FramePacer::RecordFrameTime(33000);
+	FramePacer::RecordFrameTime(100000);
+
+	std::vector<u64> histogram = FramePacer::GetFrameTimeHistogram();
+	ASSERT_EQ((size_t)FramePacer::HISTOGRAM_BUCKETS, histogram.size());
+	EXPECT_EQ(98u, histogram[16683 / FramePacer::HISTOGRAM_BUCKET_US]);
+	EXPECT_EQ(1u, histogram[33000 / FramePacer::HISTOGRAM_BUCKET_US]);
+	// Longer than the histogram goes.
+	EXPECT_EQ(1u, histogram.back());
+
+	FramePacer::FrameTimeStats stats = FramePacer::GetFrameTimeStats();
+	EXPECT_EQ(100u, stats.count);
+	EXPECT_EQ((98u * 16683 + 33000 + 100000) / 100, stats.mean_us);
+	EXPECT_EQ(16700u, stats.p50_us);
+	EXPECT_EQ(33100u, stats.p99_us);
+	EXPECT_EQ(100000u, stats.max_us);
+
+	FramePacer::ClearFrameTimes();
+	EXPECT_EQ(0u, FramePacer::GetFrameTimeStats().count);
+}
+
+TEST(FramePacer, WaitUntil)
+{
+	for (u64 wait_us : {300, 3000})
+	{
+		u64 start = Common::Timer::GetTimeUs();
+		FramePacer::WaitUntil(start + wait_us);
+		u64 elapsed = Common::Timer::GetTimeUs() - start;
+		EXPECT_GE(elapsed, wait_us);
+		// Generous, as the machine may be loaded.
+		EXPECT_LT(elapsed, wait_us + 20000);
+	}
+
+	// A deadline in the past doesn't wait.
+	u64 start = Common::Timer::GetTimeUs();
+	FramePacer::WaitUntil(start - 1000);
+	EXPECT_LT(Common::Timer::GetTimeUs() - start, 1000u);
+}
@@ -0,0 +1,165 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/GCMemcard.h"
+#include "Core/HW/GCMemcardDirectory.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+static const int NUM_SAVES = 110;
+static const u16 SAVE_BLOCKS = 2;
+static const u64 SAVE_SIZE = DENTRY_SIZE + SAVE_BLOCKS * BLOCK_SIZE;
+
+class GCMemcardDirectoryTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		// Flushed by hand.
+		SConfig::GetInstance().bEnableMemcardSdWriting = false;
+		m_dir = File::CreateTempDir();
+		ASSERT_FALSE(m_dir.empty());
+		m_dir += "/";
+
+		for (int i = 0; i < NUM_SAVES; i++)
+		{
+			DEntry header = MakeHeader(i);
+			std::vector<u8> data(SAVE_BLOCKS * BLOCK_SIZE, (u8)i);
+			File::IOFile gci(m_dir + header.GCI_FileName(), "wb");
+			gci.WriteBytes(&header, DENTRY_SIZE);
+			gci.WriteBytes(data.data(), data.size());
+		}
+	}
+
+	void TearDown() override
+	{
+		File::DeleteDirRecursively(m_dir);
+		SConfig::Shutdown();
+	}
+
+	static DEntry MakeHeader(int i)
+	{
+		DEntry header;
+		const u8 gamecode[4] = {'G', (u8)('A' + i / 26), (u8)('A' + i % 26), 'E'};
+		memcpy(header.Gamecode, gamecode, 4);
+		memcpy(header.Makercode, "01", 2);
+		memset(header.Filename, 0, sizeof(header.Filename));
+		snprintf((char*)header.Filename, sizeof(header.Filename), "save%03d", i);
+		*(u16*)header.BlockCount = BE16(SAVE_BLOCKS);
+		return header;
+	}
+
+	std::unique_ptr<GCMemcardDirectory> MakeCard()
+	{
+		DEntry current_game = MakeHeader(0);
+		return std::make_unique<GCMemcardDirectory>(m_dir, 0, MemCard2043Mb, true, DiscIO::IVolume::COUNTRY_USA,
+		                                            BE32(current_game.Gamecode));
+	}
+
+	// The address of the first block of a save, from the card's directory.
+	static u32 GetSaveAddress(GCMemcardDirectory& card, int i)
+	{
+		DEntry entry;
+		card.Read(BLOCK_SIZE + i * DENTRY_SIZE, DENTRY_SIZE, (u8*)&entry);
+		return BE16(entry.FirstBlock) * BLOCK_SIZE;
+	}
+
+	std::string m_dir;
+};
+
+TEST_F(GCMemcardDirectoryTest, LoadsSavesOnFirstAccess)
+{
+	auto start = std::chrono::high_resolution_clock::now();
+	std::unique_ptr<GCMemcardDirectory> card = MakeCard();
+	auto end = std::chrono::high_resolution_clock::now();
+
+	// Changed after opening, which only shows up if the data is read later.
+	const std::vector<int> saves = {0, 50, NUM_SAVES - 1};
+	for (int i : saves)
+	{
+		DEntry header = MakeHeader(i);
+		std::vector<u8> data(SAVE_BLOCKS * BLOCK_SIZE, (u8)~i);
+		File::IOFile gci(m_dir + header.GCI_FileName(), "r+b");
+		gci.Seek(DENTRY_SIZE, SEEK_SET);
+		ASSERT_TRUE(gci.WriteBytes(data.data(), data.size()));
+	}
+
+	for (int i : saves)
+	{
+		u8 block[BLOCK_SIZE];
+		card->Read(GetSaveAddress(*card, i) + BLOCK_SIZE, BLOCK_SIZE, block);
+		for (u8 b : block)
+			ASSERT_EQ((u8)~i, b);
+	}
+
+	printf("opening a directory of %d GCIs: %.2f ms\n", NUM_SAVES,
+	       std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0);
+}
+
+TEST_F(GCMemcardDirectoryTest, OnlyModifiedSavesAreWritten)
+{
+	std::unique_ptr<GCMemcardDirectory> card = MakeCard();
+	card->FlushToFile();
+	EXPECT_EQ(0u, card->GetFlushStats().flushes);
+
+	u8 block[BLOCK_SIZE];
+	memset(block, 0xA5, BLOCK_SIZE);
+	card->Write(GetSaveAddress(*card, 5), BLOCK_SIZE, block);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	card->FlushToFile();
+	auto end = std::chrono::high_resolution_clock::now();
+
+	GCMemcardDirectory::FlushStats stats = card->GetFlushStats();
+	EXPECT_EQ(1u, stats.flushes);
+	EXPECT_EQ(1u, stats.last_files);
+	EXPECT_EQ(SAVE_SIZE, stats.last_bytes);
+
+	std::string contents;
+	ASSERT_TRUE(File::ReadFileToString(m_dir + MakeHeader(5).GCI_FileName(), contents));
+	ASSERT_EQ(SAVE_SIZE, contents.size());
+	EXPECT_EQ(0, memcmp(&contents[DENTRY_SIZE], block, BLOCK_SIZE));
+	EXPECT_EQ(5, contents[DENTRY_SIZE + BLOCK_SIZE]);
+
+	printf("flushing 1 of %d GCIs: %.2f ms\n", NUM_SAVES,
+	       std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() / 1000.0);
+}
+
+TEST_F(GCMemcardDirectoryTest, HeaderChangesAreWritten)
+{
+	std::unique_ptr<GCMemcardDirectory> card = MakeCard();
+
+	// Games write a new copy of the directory over the older one. The save's
+	// blocks are never accessed.
+	std::unique_ptr<Directory> dirs[2] = {std::make_unique<Directory>(), std::make_unique<Directory>()};
+	card->Read(BLOCK_SIZE, BLOCK_SIZE, (u8*)dirs[0].get());
+	card->Read(2 * BLOCK_SIZE, BLOCK_SIZE, (u8*)dirs[1].get());
+	int current = BE16(dirs[0]->UpdateCounter) > BE16(dirs[1]->UpdateCounter) ? 0 : 1;
+	Directory& dir = *dirs[current];
+	dir.UpdateCounter = BE16(BE16(dir.UpdateCounter) + 1);
+	const u8 mod_time[4] = {1, 2, 3, 4};
+	memcpy(dir.Dir[0].ModTime, mod_time, 4);
+	card->Write((2 - current) * BLOCK_SIZE, BLOCK_SIZE, (u8*)&dir);
+
+	card->FlushToFile();
+	EXPECT_EQ(1u, card->GetFlushStats().last_files);
+
+	std::string contents;
+	ASSERT_TRUE(File::ReadFileToString(m_dir + MakeHeader(0).GCI_FileName(), contents));
+	ASSERT_EQ(SAVE_SIZE, contents.size());
+	EXPECT_EQ(0, memcmp(&contents[offsetof(DEntry, ModTime)], mod_time, 4));
+	EXPECT_EQ(0, contents[DENTRY_SIZE]);
+}
@@ -0,0 +1,223 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Common/Hash.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/GCMemcard.h"
+#include "Core/HW/GCMemcardRaw.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+class GCMemcardRawTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		m_dir = File::CreateTempDir();
+		ASSERT_FALSE(m_dir.empty());
+		m_filename = m_dir + "/MemoryCardA.USA.raw";
+	}
+
+	void TearDown() override
+	{
+		File::DeleteDirRecursively(m_dir);
+		SConfig::Shutdown();
+	}
+
+	std::vector<u8> ReadFile()
+	{
+		std::string data;
+		File::ReadFileToString(m_filename, data);
+		return std::vector<u8>(data.begin(), data.end());
+	}
+
+	static std::vector<u8> SaveState(MemoryCard& card)
+	{
+		u8* ptr = nullptr;
+		PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+		card.DoState(p);
+		std::vector<u8> state(reinterpret_cast<size_t>(ptr));
+		ptr = state.data();
+		p.SetMode(PointerWrap::MODE_WRITE);
+		card.DoState(p);
+		return state;
+	}
+
+	static void LoadState(MemoryCard& card, std::vector<u8>& state)
+	{
+		u8* ptr = state.data();
+		PointerWrap p(&ptr, PointerWrap::MODE_READ);
+		card.DoState(p);
+	}
+
+	std::string m_dir;
+	std::string m_filename;
+};
+
+TEST_F(GCMemcardRawTest, NewCardIsWrittenWhole)
+{
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	u8 data[16] = {1, 2, 3, 4};
+	card.Write(0x10000, sizeof(data), data);
+	ASSERT_TRUE(card.Flush());
+
+	const u32 size = MemCard59Mb * 1024 * 8 * 16;
+	EXPECT_EQ(size, card.GetFlushStats().last_bytes);
+	std::vector<u8> file = ReadFile();
+	ASSERT_EQ(size, file.size());
+	EXPECT_EQ(0, memcmp(&file[0x10000], data, sizeof(data)));
+}
+
+TEST_F(GCMemcardRawTest, OnlyChangedBlocksAreWritten)
+{
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	ASSERT_TRUE(card.Flush());
+
+	u8 data[16] = {1, 2, 3, 4};
+	card.Write(0x10000, sizeof(data), data);
+	card.ClearBlock(0x20000);
+	card.ClearBlock(0x22000);
+	ASSERT_TRUE(card.Flush());
+
+	MemoryCard::FlushStats stats = card.GetFlushStats();
+	EXPECT_EQ(2u, stats.flushes);
+	EXPECT_EQ(3u * BLOCK_SIZE, stats.last_bytes);
+
+	std::vector<u8> file = ReadFile();
+	std::vector<u8> expected(file.size());
+	card.Read(0, (s32)expected.size(), expected.data());
+	EXPECT_TRUE(file == expected);
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+
+	// Nothing changed since.
+	ASSERT_TRUE(card.Flush());
+	EXPECT_EQ(2u, card.GetFlushStats().flushes);
+}
+
+TEST_F(GCMemcardRawTest, JournalIsReplayed)
+{
+	{
+		MemoryCard card(m_filename, 0, MemCard59Mb);
+		ASSERT_TRUE(card.Flush());
+	}
+
+	// What a crash after writing the journal leaves behind.
+	const u32 offset = 0x12000;
+	std::vector<u8> body(8 + BLOCK_SIZE, 0x5A);
+	const u32 length = BLOCK_SIZE;
+	memcpy(&body[0], &offset, 4);
+	memcpy(&body[4], &length, 4);
+	const u32 header[3] = {0x4a434d44, 1, HashAdler32(body.data(), body.size())};
+	{
+		File::IOFile journal(m_filename + ".journal", "wb");
+		journal.WriteArray(header, 3);
+		journal.WriteBytes(body.data(), body.size());
+	}
+
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	u8 block[BLOCK_SIZE];
+	card.Read(offset, BLOCK_SIZE, block);
+	EXPECT_EQ(0, memcmp(block, &body[8], BLOCK_SIZE));
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
+
+TEST_F(GCMemcardRawTest, IncompleteJournalIsDiscarded)
+{
+	std::vector<u8> before;
+	{
+		MemoryCard card(m_filename, 0, MemCard59Mb);
+		ASSERT_TRUE(card.Flush());
+		before = ReadFile();
+	}
+
+	const u32 header[3] = {0x4a434d44, 1, 0};
+	{
+		File::IOFile journal(m_filename + ".journal", "wb");
+		journal.WriteArray(header, 3);
+	}
+
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	EXPECT_TRUE(ReadFile() == before);
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
+
+TEST_F(GCMemcardRawTest, LoadedStateOnlyWritesChangedBlocks)
+{
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	ASSERT_TRUE(card.Flush());
+
+	u8 data[16] = {1, 2, 3, 4};
+	card.Write(0x10000, sizeof(data), data);
+	std::vector<u8> state = SaveState(card);
+	ASSERT_TRUE(card.Flush());
+	card.Write(0x30000, sizeof(data), data);
+	ASSERT_TRUE(card.Flush());
+
+	// Only the second write is undone.
+	LoadState(card, state);
+	ASSERT_TRUE(card.Flush());
+	MemoryCard::FlushStats stats = card.GetFlushStats();
+	EXPECT_EQ(4u, stats.flushes);
+	EXPECT_EQ((u64)BLOCK_SIZE, stats.last_bytes);
+	std::vector<u8> file = ReadFile();
+	std::vector<u8> expected(file.size());
+	card.Read(0, (s32)expected.size(), expected.data());
+	EXPECT_TRUE(file == expected);
+
+	// The file already matches.
+	LoadState(card, state);
+	ASSERT_TRUE(card.Flush());
+	EXPECT_EQ(4u, card.GetFlushStats().flushes);
+}
+
+TEST_F(GCMemcardRawTest, LoadedStateIsComparedWithOpenedFile)
+{
+	{
+		MemoryCard card(m_filename, 0, MemCard59Mb);
+		ASSERT_TRUE(card.Flush());
+	}
+
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	u8 data[16] = {1, 2, 3, 4};
+	card.Write(0x10000, sizeof(data), data);
+	std::vector<u8> state = SaveState(card);
+	LoadState(card, state);
+	ASSERT_TRUE(card.Flush());
+	EXPECT_EQ((u64)BLOCK_SIZE, card.GetFlushStats().last_bytes);
+}
+
+TEST_F(GCMemcardRawTest, ConcurrentFlushesWriteEverything)
+{
+	MemoryCard card(m_filename, 0, MemCard59Mb);
+	ASSERT_TRUE(card.Flush());
+
+	// Each thread changes its own blocks and flushes them, racing the other.
+	auto writer = [&card](u32 base) {
+		for (u32 i = 0; i < 32; i++)
+		{
+			u8 data[16] = {(u8)(base >> 16), (u8)i};
+			card.Write(base + i * BLOCK_SIZE, sizeof(data), data);
+			EXPECT_TRUE(card.Flush());
+		}
+	};
+	std::thread other(writer, 0x40000);
+	writer(0x80000);
+	other.join();
+
+	std::vector<u8> file = ReadFile();
+	std::vector<u8> expected(file.size());
+	card.Read(0, (s32)expected.size(), expected.data());
+	EXPECT_TRUE(file == expected);
+	EXPECT_FALSE(File::Exists(m_filename + ".journal"));
+}
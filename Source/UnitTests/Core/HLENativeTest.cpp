@@ -0,0 +1,669 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/FPURoundMode.h"
+#include "Common/MathUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HLE/HLE_Native.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_Tables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+// The native routines are checked against the guest code they replace, run in
+// the interpreter. The guest code is the SDK's, assembled by hand.
+static u32 DForm(u32 opcd, u32 rd, u32 ra, u32 imm)
+{
+	return (opcd << 26) | (rd << 21) | (ra << 16) | (imm & 0xFFFF);
+}
+static u32 XForm(u32 rd, u32 ra, u32 rb, u32 xo)
+{
+	return (31u << 26) | (rd << 21) | (ra << 16) | (rb << 11) | (xo << 1);
+}
+static u32 Addi(u32 rd, u32 ra, s16 simm) { return DForm(14, rd, ra, simm); }
+static u32 Addic_(u32 rd, u32 ra, s16 simm) { return DForm(13, rd, ra, simm); }
+static u32 Lis(u32 rd, u16 imm) { return DForm(15, rd, 0, imm); }
+static u32 Ori(u32 ra, u32 rs, u16 uimm) { return DForm(24, rs, ra, uimm); }
+static u32 Lbzu(u32 rd, u32 ra, s16 d) { return DForm(35, rd, ra, d); }
+static u32 Stbu(u32 rs, u32 ra, s16 d) { return DForm(39, rs, ra, d); }
+static u32 Add(u32 rd, u32 ra, u32 rb) { return XForm(rd, ra, rb, 266); }
+static u32 Cmplw(u32 ra, u32 rb) { return XForm(0, ra, rb, 32); }
+// blt cr0, offset
+static u32 Blt(s16 offset) { return DForm(16, 12, 0, offset); }
+static u32 B(s32 offset) { return (18u << 26) | (offset & 0x03FFFFFC); }
+static const u32 BEQLR = 0x4D820020;
+static const u32 BLR = 0x4E800020;
+
+// Paired single loads and stores through GQR0, which is set to floats.
+static u32 PsqL(u32 frd, u32 ra, s16 d, u32 w = 0)
+{
+	return (56u << 26) | (frd << 21) | (ra << 16) | (w << 15) | (d & 0xFFF);
+}
+static u32 PsqSt(u32 frs, u32 ra, s16 d, u32 w = 0)
+{
+	return (60u << 26) | (frs << 21) | (ra << 16) | (w << 15) | (d & 0xFFF);
+}
+static u32 PsA(u32 xo, u32 frd, u32 fra, u32 frb, u32 frc)
+{
+	return (4u << 26) | (frd << 21) | (fra << 16) | (frb << 11) | (frc << 6) | (xo << 1);
+}
+static u32 FpA(u32 xo, u32 frd, u32 fra, u32 frb, u32 frc)
+{
+	return (63u << 26) | (frd << 21) | (fra << 16) | (frb << 11) | (frc << 6) | (xo << 1);
+}
+static u32 PsMuls0(u32 d, u32 a, u32 c) { return PsA(12, d, a, 0, c); }
+static u32 PsMadds0(u32 d, u32 a, u32 c, u32 b) { return PsA(14, d, a, b, c); }
+static u32 PsMadds1(u32 d, u32 a, u32 c, u32 b) { return PsA(15, d, a, b, c); }
+static u32 PsMul(u32 d, u32 a, u32 c) { return PsA(25, d, a, 0, c); }
+static u32 PsMadd(u32 d, u32 a, u32 c, u32 b) { return PsA(29, d, a, b, c); }
+static u32 PsSum0(u32 d, u32 a, u32 c, u32 b) { return PsA(10, d, a, b, c); }
+
+// MSL's memcpy, which copies backwards when the source is below the destination.
+static std::vector<u32> MemcpyCode()
+{
+	return {
+		Cmplw(4, 3),
+		Blt(36),
+		Addi(6, 4, -1),
+		Addi(7, 3, -1),
+		Addi(5, 5, 1),
+		Addic_(5, 5, -1),
+		BEQLR,
+		Lbzu(0, 6, 1),
+		Stbu(0, 7, 1),
+		B(-16),
+		Add(6, 4, 5),
+		Add(7, 3, 5),
+		Addi(5, 5, 1),
+		Addic_(5, 5, -1),
+		BEQLR,
+		Lbzu(0, 6, -1),
+		Stbu(0, 7, -1),
+		B(-16),
+	};
+}
+
+static std::vector<u32> MemsetCode()
+{
+	return {
+		Addi(6, 3, -1),
+		Addi(5, 5, 1),
+		Addic_(5, 5, -1),
+		BEQLR,
+		Stbu(4, 6, 1),
+		B(-12),
+	};
+}
+
+// The SDK's PSMTXConcat, with the {0, 1} constant it loads at unit01.
+static std::vector<u32> PSMTXConcatCode(u32 unit01)
+{
+	return {
+		PsqL(0, 3, 0),
+		PsqL(6, 4, 0),
+		Lis(6, unit01 >> 16),
+		PsqL(7, 4, 8),
+		Ori(6, 6, unit01 & 0xFFFF),
+		PsqL(8, 4, 16),
+		PsMuls0(12, 6, 0),
+		PsqL(2, 3, 32),
+		PsMuls0(13, 7, 0),
+		PsqL(31, 6, 0),
+		PsMuls0(14, 6, 2),
+		PsqL(9, 4, 24),
+		PsMuls0(15, 7, 2),
+		PsqL(1, 3, 8),
+		PsMadds1(12, 8, 0, 12),
+		PsqL(3, 3, 40),
+		PsMadds1(14, 8, 2, 14),
+		PsqL(10, 4, 32),
+		PsMadds1(13, 9, 0, 13),
+		PsqL(11, 4, 40),
+		PsMadds1(15, 9, 2, 15),
+		PsqL(4, 3, 16),
+		PsqL(5, 3, 24),
+		PsMadds0(12, 10, 1, 12),
+		PsMadds0(13, 11, 1, 13),
+		PsMadds0(14, 10, 3, 14),
+		PsMadds0(15, 11, 3, 15),
+		PsqSt(12, 5, 0),
+		PsMuls0(2, 6, 4),
+		PsMadds1(13, 31, 1, 13),
+		PsMuls0(0, 7, 4),
+		PsqSt(14, 5, 32),
+		PsMadds1(15, 31, 3, 15),
+		PsqSt(13, 5, 8),
+		PsMadds1(2, 8, 4, 2),
+		PsMadds1(0, 9, 4, 0),
+		PsMadds0(2, 10, 5, 2),
+		PsqSt(15, 5, 40),
+		PsMadds0(0, 11, 5, 0),
+		PsqSt(2, 5, 16),
+		PsMadds1(0, 31, 5, 0),
+		PsqSt(0, 5, 24),
+		BLR,
+	};
+}
+
+static std::vector<u32> PSMTXMultVecCode()
+{
+	return {
+		PsqL(0, 4, 0),
+		PsqL(2, 3, 0),
+		PsqL(1, 4, 8, 1),
+		PsMul(4, 2, 0),
+		PsqL(3, 3, 8),
+		PsMadd(5, 3, 1, 4),
+		PsqL(8, 3, 16),
+		PsSum0(6, 5, 6, 5),
+		PsqL(9, 3, 24),
+		PsMul(10, 8, 0),
+		PsqSt(6, 5, 0, 1),
+		PsMadd(11, 9, 1, 10),
+		PsqL(2, 3, 32),
+		PsSum0(12, 11, 12, 11),
+		PsqL(3, 3, 40),
+		PsMul(4, 2, 0),
+		PsqSt(12, 5, 4, 1),
+		PsMadd(5, 3, 1, 4),
+		PsSum0(6, 5, 6, 5),
+		PsqSt(6, 5, 8, 1),
+		BLR,
+	};
+}
+
+// fdlibm's e_sqrt.c for a positive finite x, run on the host. It also reports
+// which of the floating point operations that set the FPSCR ran.
+struct SqrtResult
+{
+	double value;
+	bool inexact;
+	bool rounded_up;
+};
+
+static SqrtResult FdlibmSqrt(double x)
+{
+	static volatile double one = 1.0, tiny = 1.0e-300;
+	const u32 sign = 0x80000000;
+	u64 bits = MathUtil::IntDouble(x).i;
+	s32 ix0 = (s32)(bits >> 32);
+	u32 ix1 = (u32)bits;
+
+	s32 m = ix0 >> 20;
+	if (m == 0)
+	{
+		while (ix0 == 0)
+		{
+			m -= 21;
+			ix0 |= ix1 >> 11;
+			ix1 <<= 21;
+		}
+		s32 i;
+		for (i = 0; (ix0 & 0x00100000) == 0; i++)
+			ix0 <<= 1;
+		m -= i - 1;
+		if (i)
+			ix0 |= ix1 >> (32 - i);
+		ix1 <<= i;
+	}
+	m -= 1023;
+	ix0 = (ix0 & 0x000fffff) | 0x00100000;
+	if (m & 1)
+	{
+		ix0 += ix0 + ((ix1 & sign) >> 31);
+		ix1 += ix1;
+	}
+	m >>= 1;
+
+	ix0 += ix0 + ((ix1 & sign) >> 31);
+	ix1 += ix1;
+	s32 q = 0, s0 = 0;
+	u32 q1 = 0, s1 = 0;
+	u32 r = 0x00200000;
+	while (r != 0)
+	{
+		s32 t = s0 + r;
+		if (t <= ix0)
+		{
+			s0 = t + r;
+			ix0 -= t;
+			q += r;
+		}
+		ix0 += ix0 + ((ix1 & sign) >> 31);
+		ix1 += ix1;
+		r >>= 1;
+	}
+
+	r = sign;
+	while (r != 0)
+	{
+		u32 t1 = s1 + r;
+		s32 t = s0;
+		if (t < ix0 || (t == ix0 && t1 <= ix1))
+		{
+			s1 = t1 + r;
+			if ((t1 & sign) == sign && (s1 & sign) == 0)
+				s0 += 1;
+			ix0 -= t;
+			if (ix1 < t1)
+				ix0 -= 1;
+			ix1 -= t1;
+			q1 += r;
+		}
+		ix0 += ix0 + ((ix1 & sign) >> 31);
+		ix1 += ix1;
+		r >>= 1;
+	}
+
+	SqrtResult result = {0.0, false, false};
+	if ((ix0 | ix1) != 0)
+	{
+		result.inexact = true;
+		double z = one - tiny;
+		result.rounded_up = z >= one;
+		if (z >= one)
+		{
+			z = one + tiny;
+			result.rounded_up = z > one;
+			if (q1 == 0xffffffff)
+			{
+				q1 = 0;
+				q += 1;
+			}
+			else if (z > one)
+			{
+				if (q1 == 0xfffffffe)
+					q += 1;
+				q1 += 2;
+			}
+			else
+			{
+				q1 += q1 & 1;
+			}
+		}
+	}
+	ix0 = (q >> 1) + 0x3fe00000;
+	ix1 = q1 >> 1;
+	if (q & 1)
+		ix1 |= sign;
+	ix0 += m << 20;
+	result.value = MathUtil::IntDouble(((u64)(u32)ix0 << 32) | ix1).d;
+	return result;
+}
+
+static const u32 CODE_ADDRESS = 0x00003000;
+static const u32 RETURN_ADDRESS = 0x00002000;
+static const u32 DATA_ADDRESS = 0x00010000;
+static const u32 DATA_SIZE = 0x100;
+static const u32 FPSCR_FPRF_MASK = 0x1F << 12;
+
+class HLENativeTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		SConfig::GetInstance().bMMU = false;
+		// Nothing here is an idle loop.
+		SConfig::GetInstance().bSkipIdle = false;
+		InterpreterTables::InitTables();
+
+		// Only RAM is needed, Memory::Init would also want the devices behind MMIO.
+		m_ram.resize(Memory::RAM_SIZE);
+		Memory::m_pRAM = m_ram.data();
+		Memory::physical_base = m_ram.data();
+		PowerPC::ppcState.Exceptions = 0;
+		// psq_l and psq_st with GQR0 load and store floats.
+		GQR(0) = 0;
+		SetFastPath(true);
+
+		CoreTiming::Init();
+	}
+
+	void TearDown() override
+	{
+		FPSCR.Hex = 0;
+		FPURoundMode::SetRoundMode(0);
+		CoreTiming::Shutdown();
+		Memory::m_pRAM = nullptr;
+		Memory::physical_base = nullptr;
+		SConfig::Shutdown();
+	}
+
+	// The native routines access RAM directly through the BAT mapped
+	// addresses. With address translation off, they go through PowerPC::Read_*
+	// and PowerPC::Write_* instead.
+	void SetFastPath(bool fast)
+	{
+		// Floating point available, and data address translation.
+		MSR = fast ? 0x2010 : 0x2000;
+		m_data = fast ? 0x80000000 | DATA_ADDRESS : DATA_ADDRESS;
+	}
+
+	void SetRoundingMode(u32 mode)
+	{
+		FPSCR.Hex = 0;
+		FPSCR.RN = mode;
+		FPURoundMode::SetRoundMode(mode);
+	}
+
+	void RunGuest(const std::vector<u32>& code)
+	{
+		for (size_t i = 0; i < code.size(); i++)
+			Memory::Write_U32(code[i], CODE_ADDRESS + (u32)i * 4);
+		LR = RETURN_ADDRESS;
+		PC = CODE_ADDRESS;
+		for (int i = 0; PC != RETURN_ADDRESS; i++)
+		{
+			ASSERT_LT(i, 100000);
+			Interpreter::getInstance()->SingleStep();
+		}
+	}
+
+	void RunNative(void (*function)())
+	{
+		LR = RETURN_ADDRESS;
+		NPC = 0;
+		function();
+		EXPECT_EQ(RETURN_ADDRESS, NPC);
+	}
+
+	std::vector<u8> GetData() const
+	{
+		return std::vector<u8>(&m_ram[DATA_ADDRESS], &m_ram[DATA_ADDRESS + DATA_SIZE]);
+	}
+
+	void SetData(const std::vector<u8>& data)
+	{
+		std::memcpy(&m_ram[DATA_ADDRESS], data.data(), data.size());
+	}
+
+	// Mostly ordinary floats, with -0, infinities, NaNs and denormals mixed in.
+	u32 RandomFloat()
+	{
+		static const u32 special[] = {
+			0x00000000, 0x80000000, 0x3F800000, 0x7F7FFFFF, 0x00000001, 0x80400000,
+			0x7F800000, 0xFF800000, 0x7FC00001, 0xFFC00002, 0x7FA00003,
+		};
+		if (m_rng() % 4 == 0)
+			return special[m_rng() % ArraySize(special)];
+		u32 exponent = 100 + m_rng() % 55;
+		return (m_rng() & 0x807FFFFF) | (exponent << 23);
+	}
+
+	// Runs the guest and native routine on the same registers and data, and
+	// compares the data and the FPSCR. FPRF is left out: it holds the class of
+	// the last result the guest code computed, which nothing after the call
+	// reads before overwriting it.
+	void Compare(const std::vector<u32>& code, void (*function)(), const char* name)
+	{
+		std::vector<u8> data = GetData();
+		u32 gpr[3] = {GPR(3), GPR(4), GPR(5)};
+		u32 fpscr = FPSCR.Hex;
+
+		RunGuest(code);
+		std::vector<u8> expected = GetData();
+		u32 expected_r3 = GPR(3);
+		u32 expected_fpscr = FPSCR.Hex;
+
+		SetData(data);
+		std::memcpy(&GPR(3), gpr, sizeof(gpr));
+		FPSCR.Hex = fpscr;
+		RunNative(function);
+
+		EXPECT_EQ(expected_r3, GPR(3)) << name;
+		EXPECT_EQ(expected_fpscr & ~FPSCR_FPRF_MASK, FPSCR.Hex & ~FPSCR_FPRF_MASK) << name;
+		ASSERT_TRUE(expected == GetData()) << name << (MSR & 0x10 ? "" : " slow path") << " RN " << FPSCR.RN;
+	}
+
+	std::vector<u8> m_ram;
+	// Address of the data, as the guest sees it.
+	u32 m_data;
+	std::mt19937 m_rng{1234};
+};
+
+TEST_F(HLENativeTest, Memcpy)
+{
+	for (bool fast : {true, false})
+	{
+		SetFastPath(fast);
+		for (int run = 0; run < 500; run++)
+		{
+			for (u32 i = 0; i < DATA_SIZE; i++)
+				m_ram[DATA_ADDRESS + i] = (u8)m_rng();
+			// Overlapping in either direction as often as not.
+			u32 size = m_rng() % 64;
+			u32 src = 64 + m_rng() % 64;
+			u32 dst = src + m_rng() % 128 - 64;
+			GPR(3) = m_data + dst;
+			GPR(4) = m_data + src;
+			GPR(5) = size;
+			Compare(MemcpyCode(), HLE_Native::Memcpy, "memcpy");
+		}
+	}
+}
+
+TEST_F(HLENativeTest, Memset)
+{
+	for (bool fast : {true, false})
+	{
+		SetFastPath(fast);
+		for (int run = 0; run < 200; run++)
+		{
+			for (u32 i = 0; i < DATA_SIZE; i++)
+				m_ram[DATA_ADDRESS + i] = (u8)m_rng();
+			u32 size = m_rng() % 128;
+			GPR(3) = m_data + m_rng() % 128;
+			// Only the low byte is the value.
+			GPR(4) = m_rng();
+			GPR(5) = size;
+			Compare(MemsetCode(), HLE_Native::Memset, "memset");
+		}
+	}
+}
+
+// Under the MMU, the copy stops at a page the guest hasn't mapped yet and the
+// call starts over once its handler has mapped it.
+TEST_F(HLENativeTest, MemcpyRestartsAfterDSI)
+{
+	const u32 PAGE_TABLE = 0x00020000;
+	const u32 VIRTUAL_ADDRESS = 0x40000000;
+	const u32 PHYSICAL_ADDRESS = 0x00030000;
+	const u32 SIZE = 0x20;
+	// Ends on the page after the first one.
+	const u32 DST = VIRTUAL_ADDRESS + 0x1000 - SIZE / 2;
+
+	SConfig::GetInstance().bMMU = true;
+	SetFastPath(true);
+	PowerPC::ppcState.sr[VIRTUAL_ADDRESS >> 28] = 0;
+	// The two pages' entries are in different groups.
+	PowerPC::ppcState.pagetable_base = PAGE_TABLE;
+	PowerPC::ppcState.pagetable_hashmask = 1;
+	for (auto& tlb : PowerPC::ppcState.tlb)
+	{
+		for (PowerPC::tlb_entry& entry : tlb)
+			entry.tag[0] = entry.tag[1] = TLB_TAG_INVALID;
+	}
+	// Valid, VSID 0 and API 0, to the physical page at the same offset.
+	auto map_page = [&](u32 page) {
+		u32 group = PAGE_TABLE + page * 64;
+		Memory::Write_U32(0x80000000, group);
+		Memory::Write_U32(PHYSICAL_ADDRESS + page * 0x1000, group + 4);
+	};
+	map_page(0);
+
+	for (u32 i = 0; i < SIZE; i++)
+		m_ram[DATA_ADDRESS + i] = (u8)m_rng();
+	GPR(3) = DST;
+	GPR(4) = m_data;
+	GPR(5) = SIZE;
+	LR = RETURN_ADDRESS;
+	PC = NPC = CODE_ADDRESS;
+	HLE_Native::Memcpy();
+	ASSERT_TRUE(PowerPC::ppcState.Exceptions & EXCEPTION_DSI);
+	EXPECT_EQ(CODE_ADDRESS, NPC);
+	EXPECT_EQ(VIRTUAL_ADDRESS + 0x1000, PowerPC::ppcState.spr[SPR_DAR]);
+
+	map_page(1);
+	PowerPC::ppcState.Exceptions = 0;
+	HLE_Native::Memcpy();
+	EXPECT_FALSE(PowerPC::ppcState.Exceptions & EXCEPTION_DSI);
+	EXPECT_EQ(RETURN_ADDRESS, NPC);
+	EXPECT_EQ(0, std::memcmp(&m_ram[DATA_ADDRESS], &m_ram[PHYSICAL_ADDRESS + 0x1000 - SIZE / 2], SIZE));
+}
+
+TEST_F(HLENativeTest, PSMTXConcat)
+{
+	const u32 A = 0x00, B = 0x40, AB = 0x80, UNIT01 = 0xC0;
+	Memory::Write_U32(0x00000000, DATA_ADDRESS + UNIT01);
+	Memory::Write_U32(0x3F800000, DATA_ADDRESS + UNIT01 + 4);
+
+	for (bool fast : {true, false})
+	{
+		SetFastPath(fast);
+		std::vector<u32> code = PSMTXConcatCode(m_data + UNIT01);
+		for (u32 mode = 0; mode < 4; mode++)
+		{
+			// ab is separate, a, or b.
+			for (u32 ab : {AB, A, B})
+			{
+				for (int run = 0; run < 100; run++)
+				{
+					SetRoundingMode(mode);
+					for (u32 i = 0; i < 12; i++)
+					{
+						Memory::Write_U32(RandomFloat(), DATA_ADDRESS + A + i * 4);
+						Memory::Write_U32(RandomFloat(), DATA_ADDRESS + B + i * 4);
+					}
+					GPR(3) = m_data + A;
+					GPR(4) = m_data + B;
+					GPR(5) = m_data + ab;
+					Compare(code, HLE_Native::PSMTXConcat, "PSMTXConcat");
+				}
+			}
+		}
+	}
+}
+
+TEST_F(HLENativeTest, PSMTXMultVec)
+{
+	const u32 M = 0x00, SRC = 0x40, DST = 0x50;
+
+	for (bool fast : {true, false})
+	{
+		SetFastPath(fast);
+		for (u32 mode = 0; mode < 4; mode++)
+		{
+			// dst is separate, src, or the last row of m.
+			for (u32 dst : {DST, SRC, M + 32})
+			{
+				for (int run = 0; run < 100; run++)
+				{
+					SetRoundingMode(mode);
+					for (u32 i = 0; i < 12; i++)
+						Memory::Write_U32(RandomFloat(), DATA_ADDRESS + M + i * 4);
+					for (u32 i = 0; i < 3; i++)
+						Memory::Write_U32(RandomFloat(), DATA_ADDRESS + SRC + i * 4);
+					GPR(3) = m_data + M;
+					GPR(4) = m_data + SRC;
+					GPR(5) = m_data + dst;
+					Compare(PSMTXMultVecCode(), HLE_Native::PSMTXMultVec, "PSMTXMultVec");
+				}
+			}
+		}
+	}
+}
+
+// fdlibm only uses the FPU for the special cases, and to find the rounding
+// direction of an inexact result. The rest is integer code, which is checked
+// against fdlibm's source run on the host.
+TEST_F(HLENativeTest, Sqrt)
+{
+	std::vector<double> inputs = {
+		1.0, 2.0, 4.0, 2.25, 0.5, 3.0, 1e300, 1e-300,
+		MathUtil::IntDouble((u64)0x0000000000000001).d, MathUtil::IntDouble((u64)0x000FFFFFFFFFFFFF).d,
+		MathUtil::IntDouble((u64)0x0000000000000004).d, MathUtil::IntDouble((u64)0x7FEFFFFFFFFFFFFF).d,
+	};
+	for (int i = 0; i < 500; i++)
+		inputs.push_back(MathUtil::IntDouble((u64)(((u64)m_rng() << 32 | m_rng()) & 0x7FFFFFFFFFFFFFFF)).d);
+	for (int i = 0; i < 100; i++)
+	{
+		// Squares of 26 bit integers are exact.
+		double root = (double)(m_rng() & 0x3FFFFFF);
+		inputs.push_back(root * root);
+	}
+
+	for (u32 mode = 0; mode < 4; mode++)
+	{
+		for (double x : inputs)
+		{
+			if (std::isnan(x) || std::isinf(x) || x == 0.0)
+				continue;
+
+			SetRoundingMode(mode);
+			SqrtResult expected = FdlibmSqrt(x);
+			UReg_FPSCR expected_fpscr = FPSCR;
+			if (expected.inexact)
+			{
+				expected_fpscr.Hex |= FPSCR_FX | FPSCR_XX;
+				expected_fpscr.FI = 1;
+				expected_fpscr.FR = expected.rounded_up;
+				expected_fpscr.FPRF = MathUtil::PPC_FPCLASS_PN;
+			}
+
+			rPS0(1) = x;
+			RunNative(HLE_Native::Sqrt);
+			EXPECT_EQ(MathUtil::IntDouble(expected.value).i, riPS0(1)) << std::hexfloat << x << " RN " << mode;
+			EXPECT_EQ(expected_fpscr.Hex, FPSCR.Hex) << std::hexfloat << x << " RN " << mode;
+		}
+	}
+}
+
+// The special cases are the floating point code fdlibm runs for them.
+TEST_F(HLENativeTest, SqrtSpecialCases)
+{
+	// fmadd f1, f1, f1, f1
+	const std::vector<u32> nan_or_inf = {FpA(29, 1, 1, 1, 1), BLR};
+	// fsub f0, f1, f1; fdiv f1, f0, f0
+	const std::vector<u32> negative = {FpA(20, 0, 1, 1, 0), FpA(18, 1, 0, 0, 0), BLR};
+	const std::vector<u32> zero = {BLR};
+
+	const u64 inputs[] = {
+		0x0000000000000000, 0x8000000000000000, 0x7FF0000000000000, 0xFFF0000000000000,
+		0x7FF8000000000123, 0xFFF8000000000456, 0x7FF4000000000789, 0xBFF0000000000000,
+		0x8000000000000001, 0xFFEFFFFFFFFFFFFF,
+	};
+	for (u64 x : inputs)
+	{
+		double value = MathUtil::IntDouble(x).d;
+		const std::vector<u32>* code = &negative;
+		if (std::isnan(value) || std::isinf(value))
+			code = &nan_or_inf;
+		else if (value == 0.0)
+			code = &zero;
+
+		SetRoundingMode(0);
+		rPS0(1) = value;
+		RunGuest(*code);
+		u64 expected = riPS0(1);
+		u32 expected_fpscr = FPSCR.Hex;
+
+		SetRoundingMode(0);
+		rPS0(1) = value;
+		RunNative(HLE_Native::Sqrt);
+		EXPECT_EQ(expected, riPS0(1)) << std::hex << x;
+		EXPECT_EQ(expected_fpscr, FPSCR.Hex) << std::hex << x;
+	}
+}
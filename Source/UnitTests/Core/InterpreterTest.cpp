@@ -0,0 +1,208 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "Common/CommonFuncs.h"
+#include "Common/CommonTypes.h"
+#include "Common/MsgHandler.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCTables.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_Tables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+// Integer instructions with specialised handlers.
+struct Opcode
+{
+	u32 opcd;
+	u32 subop10;
+	bool has_oe;
+};
+
+static const Opcode s_opcodes[] = {
+	{14, 0, false}, {15, 0, false}, {20, 0, false}, {21, 0, false}, {23, 0, false},
+	{31, 266, true}, {31, 10, true}, {31, 138, true}, {31, 234, true}, {31, 202, true},
+	{31, 491, true}, {31, 459, true}, {31, 235, true}, {31, 104, true}, {31, 40, true},
+	{31, 8, true}, {31, 136, true}, {31, 232, true}, {31, 200, true}, {31, 75, false},
+	{31, 11, false}, {31, 28, false}, {31, 60, false}, {31, 444, false}, {31, 124, false},
+	{31, 316, false}, {31, 412, false}, {31, 476, false}, {31, 284, false}, {31, 26, false},
+	{31, 922, false}, {31, 954, false}, {31, 536, false}, {31, 792, false}, {31, 824, false},
+	{31, 24, false},
+};
+
+struct RegisterState
+{
+	u32 gpr[32];
+	u64 cr_val[8];
+	u8 xer_ca;
+	u8 xer_so_ov;
+};
+
+static RegisterState SaveState()
+{
+	RegisterState state;
+	std::memcpy(state.gpr, PowerPC::ppcState.gpr, sizeof(state.gpr));
+	std::memcpy(state.cr_val, PowerPC::ppcState.cr_val, sizeof(state.cr_val));
+	state.xer_ca = PowerPC::ppcState.xer_ca;
+	state.xer_so_ov = PowerPC::ppcState.xer_so_ov;
+	return state;
+}
+
+static void LoadState(const RegisterState& state)
+{
+	std::memcpy(PowerPC::ppcState.gpr, state.gpr, sizeof(state.gpr));
+	std::memcpy(PowerPC::ppcState.cr_val, state.cr_val, sizeof(state.cr_val));
+	PowerPC::ppcState.xer_ca = state.xer_ca;
+	PowerPC::ppcState.xer_so_ov = state.xer_so_ov;
+}
+
+class InterpreterTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		InterpreterTables::InitTables();
+		// The OE forms complain about the unimplemented overflow flag.
+		SetEnableAlert(false);
+	}
+
+	void TearDown() override
+	{
+		SetEnableAlert(true);
+	}
+
+	UGeckoInstruction RandomInstruction(const Opcode& opcode, bool allow_oe = true)
+	{
+		UGeckoInstruction inst(m_rng());
+		inst.OPCD = opcode.opcd;
+		if (opcode.opcd == 31)
+		{
+			inst.SUBOP10 = opcode.subop10;
+			// The OE bit is part of SUBOP10 for the XO form instructions.
+			if (opcode.has_oe && allow_oe)
+				inst.OE = m_rng() & 1;
+		}
+		// rA = 0 means the value 0 to some instructions.
+		if (m_rng() % 4 == 0)
+			inst.RA = 0;
+		return inst;
+	}
+
+	void RandomizeState()
+	{
+		for (u32& gpr : PowerPC::ppcState.gpr)
+		{
+			// Also the edge cases of the divisions and shifts.
+			switch (m_rng() % 4)
+			{
+			case 0:  gpr = m_rng() % 64; break;
+			case 1:  gpr = 0x80000000 - m_rng() % 2; break;
+			case 2:  gpr = 0xFFFFFFFF; break;
+			default: gpr = m_rng(); break;
+			}
+		}
+		for (int i = 0; i < 8; i++)
+			SetCRField(i, m_rng() & 0xF);
+		PowerPC::ppcState.xer_ca = m_rng() & 1;
+		PowerPC::ppcState.xer_so_ov = m_rng() & 3;
+	}
+
+	std::mt19937 m_rng{1234};
+};
+
+TEST_F(InterpreterTest, DecodedHandlersMatchTables)
+{
+	for (const Opcode& opcode : s_opcodes)
+	{
+		for (int i = 0; i < 200; i++)
+		{
+			UGeckoInstruction inst = RandomInstruction(opcode);
+			Interpreter::Instruction decoded = GetInterpreterOp(inst);
+			ASSERT_TRUE(decoded != nullptr);
+			ASSERT_TRUE(decoded != Interpreter::unknown_instruction);
+
+			RandomizeState();
+			RegisterState before = SaveState();
+			Interpreter::m_opTable[inst.OPCD](inst);
+			RegisterState expected = SaveState();
+
+			LoadState(before);
+			decoded(inst);
+			RegisterState actual = SaveState();
+
+			ASSERT_EQ(0, std::memcmp(expected.gpr, actual.gpr, sizeof(expected.gpr))) << std::hex << inst.hex;
+			ASSERT_EQ(0, std::memcmp(expected.cr_val, actual.cr_val, sizeof(expected.cr_val))) << std::hex << inst.hex;
+			ASSERT_EQ(expected.xer_ca, actual.xer_ca) << std::hex << inst.hex;
+			ASSERT_EQ(expected.xer_so_ov, actual.xer_so_ov) << std::hex << inst.hex;
+		}
+	}
+}
+
+TEST_F(InterpreterTest, UnspecialisedOpsUseTables)
+{
+	// cmp and mfcr have no fields to specialise on.
+	UGeckoInstruction cmp(0x7C000000);
+	UGeckoInstruction mfcr(0x7C000026);
+	EXPECT_TRUE(InterpreterTables::GetDecodedOp(cmp) == nullptr);
+	EXPECT_TRUE(InterpreterTables::GetDecodedOp(mfcr) == nullptr);
+	EXPECT_TRUE(GetInterpreterOp(cmp) == Interpreter::m_opTable31[cmp.SUBOP10]);
+	EXPECT_TRUE(GetInterpreterOp(mfcr) == Interpreter::m_opTable31[mfcr.SUBOP10]);
+}
+
+TEST_F(InterpreterTest, DispatchTiming)
+{
+	const size_t NUM_INSTRUCTIONS = 256;
+	const int NUM_RUNS = 4000;
+
+	std::vector<UGeckoInstruction> block;
+	std::vector<Interpreter::Instruction> decoded;
+	while (block.size() < NUM_INSTRUCTIONS)
+	{
+		// Overflow enable only shows up in the alert path, and the divisions
+		// would dominate the timing.
+		const Opcode& opcode = s_opcodes[m_rng() % ArraySize(s_opcodes)];
+		if (opcode.subop10 == 491 || opcode.subop10 == 459)
+			continue;
+		UGeckoInstruction inst = RandomInstruction(opcode, false);
+		block.push_back(inst);
+		decoded.push_back(GetInterpreterOp(inst));
+	}
+	RandomizeState();
+	RegisterState state = SaveState();
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int run = 0; run < NUM_RUNS; run++)
+	{
+		for (UGeckoInstruction inst : block)
+			Interpreter::m_opTable[inst.OPCD](inst);
+	}
+	auto middle = std::chrono::high_resolution_clock::now();
+	RegisterState expected = SaveState();
+
+	LoadState(state);
+	for (int run = 0; run < NUM_RUNS; run++)
+	{
+		for (size_t i = 0; i < NUM_INSTRUCTIONS; i++)
+			decoded[i](block[i]);
+	}
+	auto end = std::chrono::high_resolution_clock::now();
+	RegisterState actual = SaveState();
+
+	EXPECT_EQ(0, std::memcmp(expected.gpr, actual.gpr, sizeof(expected.gpr)));
+	EXPECT_EQ(0, std::memcmp(expected.cr_val, actual.cr_val, sizeof(expected.cr_val)));
+
+	const u64 count = (u64)NUM_INSTRUCTIONS * NUM_RUNS;
+	unsigned long long table_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(middle - start).count();
+	unsigned long long decoded_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - middle).count();
+	printf("interpreter dispatch timing (%llu instructions):\n", (unsigned long long)count);
+	printf("opcode tables          %.2f ns per instruction\n", (double)table_ns / count);
+	printf("decoded handlers       %.2f ns per instruction\n", (double)decoded_ns / count);
+}
@@ -0,0 +1,262 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <memory>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/CommonFuncs.h"
+#include "Common/CPUDetect.h"
+#include "Core/ConfigManager.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/Gekko.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_Tables.h"
+#include "Core/PowerPC/Jit64/Jit.h"
+#include "Core/PowerPC/Jit64/Jit64_Tables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+// Encodings of the A-form floating point instructions, as {opcd, xo}.
+struct FloatOp
+{
+	u32 opcd;
+	u32 xo;
+	const char* name;
+};
+
+static const FloatOp s_ops[] = {
+	{63, 29, "fmadd"}, {63, 28, "fmsub"}, {63, 31, "fnmadd"}, {63, 30, "fnmsub"},
+	{59, 29, "fmadds"}, {59, 28, "fmsubs"}, {59, 31, "fnmadds"}, {59, 30, "fnmsubs"},
+	{4, 29, "ps_madd"}, {4, 28, "ps_msub"}, {4, 31, "ps_nmadd"}, {4, 30, "ps_nmsub"},
+	{4, 14, "ps_madds0"}, {4, 15, "ps_madds1"},
+	{63, 23, "fsel"}, {4, 23, "ps_sel"},
+};
+
+static const u64 s_values[] = {
+	0x0000000000000000, // 0
+	0x8000000000000000, // -0
+	0x3FF0000000000000, // 1
+	0xBFF8000000000000, // -1.5
+	0x3FD5555555555555, // 1/3
+	0x47EFFFFFE0000000, // FLT_MAX
+	0x7E37E43C8800759C, // 1e300
+	0x0000000000000001, // smallest denormal
+	0x7FF0000000000000, // inf
+	0xFFF0000000000000, // -inf
+	0x7FF8000000000123, // quiet NaN with a payload
+	0xFFF8000000000456, // negative quiet NaN
+	0x7FF4000000000789, // signalling NaN
+};
+
+static const u32 FA = 1, FB = 2, FC = 3, FD = 4;
+
+static bool IsNaN(u64 bits)
+{
+	return (bits & 0x7FF0000000000000) == 0x7FF0000000000000 && (bits & 0x000FFFFFFFFFFFFF) != 0;
+}
+
+struct Result
+{
+	u64 ps0;
+	u64 ps1;
+};
+
+class Jit64FloatingPointTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		SConfig& config = SConfig::GetInstance();
+		config.bEnableDebugging = false;
+		config.bFastmem = false;
+		config.bMMU = false;
+		config.bSkipIdle = false;
+		config.bFPRF = false;
+		config.bJITAsyncCompile = false;
+		config.bJITTieredCompile = false;
+		config.bJITNoBlockCache = false;
+		config.bJITOff = false;
+		config.bJITFloatingPointOff = false;
+		config.bJITPairedOff = false;
+		config.bJITBranchOff = false;
+
+		InterpreterTables::InitTables();
+		Jit64Tables::InitTables();
+		m_cpu_info = cpu_info;
+		// The results of FMA differ from the interpreter in the last bit.
+		cpu_info.bFMA = false;
+
+		// Only RAM is needed, Memory::Init would also want the devices behind MMIO.
+		m_ram.resize(Memory::RAM_SIZE);
+		Memory::m_pRAM = m_ram.data();
+		Memory::physical_base = m_ram.data();
+		// The instruction, then a loop which runs until the slice is over.
+		Memory::Write_U32(0, CODE_ADDRESS);
+		Memory::Write_U32(0x48000000, CODE_ADDRESS + 4);
+
+		CoreTiming::Init();
+		// The dispatcher leaves at the end of the slice, as the CPU isn't running.
+		PowerPC::Stop();
+		// Floating point available, address translation off.
+		MSR = 0x2000;
+
+		// The dispatcher is generated with the block cache of the global JIT.
+		m_jit.reset(new Jit64());
+		jit = m_jit.get();
+		m_jit->Init();
+	}
+
+	void TearDown() override
+	{
+		m_jit->Shutdown();
+		jit = nullptr;
+		m_jit.reset();
+		CoreTiming::Shutdown();
+		Memory::m_pRAM = nullptr;
+		Memory::physical_base = nullptr;
+		cpu_info = m_cpu_info;
+		SConfig::Shutdown();
+	}
+
+	void SetInputs(size_t i, size_t j, size_t k)
+	{
+		const size_t n = ArraySize(s_values);
+		// Different values in ps1, so mixing up the halves shows up.
+		riPS0(FA) = s_values[i];
+		riPS1(FA) = s_values[(i + 3) % n];
+		riPS0(FB) = s_values[j];
+		riPS1(FB) = s_values[(j + 5) % n];
+		riPS0(FC) = s_values[k];
+		riPS1(FC) = s_values[(k + 7) % n];
+		// Scalar double results have to leave ps1 alone.
+		riPS0(FD) = 0x4020000000000000;
+		riPS1(FD) = 0xC022000000000000;
+	}
+
+	static Result GetResult()
+	{
+		return {riPS0(FD), riPS1(FD)};
+	}
+
+	static UGeckoInstruction Encode(const FloatOp& op)
+	{
+		return UGeckoInstruction((op.opcd << 26) | (FD << 21) | (FA << 16) | (FB << 11) | (FC << 6) | (op.xo << 1));
+	}
+
+	// Runs the instruction on every combination of inputs.
+	std::vector<Result> RunInterpreter(const FloatOp& op)
+	{
+		UGeckoInstruction inst = Encode(op);
+		std::vector<Result> results;
+		const size_t n = ArraySize(s_values);
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t j = 0; j < n; j++)
+			{
+				for (size_t k = 0; k < n; k++)
+				{
+					SetInputs(i, j, k);
+					Interpreter::m_opTable[inst.OPCD](inst);
+					results.push_back(GetResult());
+				}
+			}
+		}
+		return results;
+	}
+
+	std::vector<Result> RunJit(const FloatOp& op, bool avx)
+	{
+		cpu_info.bAVX = avx;
+		m_jit->ClearCache();
+		Memory::Write_U32(Encode(op).hex, CODE_ADDRESS);
+
+		std::vector<Result> results;
+		const size_t n = ArraySize(s_values);
+		for (size_t i = 0; i < n; i++)
+		{
+			for (size_t j = 0; j < n; j++)
+			{
+				for (size_t k = 0; k < n; k++)
+				{
+					SetInputs(i, j, k);
+					PC = CODE_ADDRESS;
+					m_jit->Run();
+					results.push_back(GetResult());
+				}
+			}
+		}
+		cpu_info.bAVX = m_cpu_info.bAVX;
+		return results;
+	}
+
+	static const u32 CODE_ADDRESS = 0x00003000;
+
+	std::vector<u8> m_ram;
+	std::unique_ptr<Jit64> m_jit;
+	CPUInfo m_cpu_info;
+};
+
+TEST_F(Jit64FloatingPointTest, AVXMatchesSSE)
+{
+	if (!cpu_info.bAVX || !cpu_info.bSSE4_1)
+		return;
+
+	for (bool accurate_nans : {false, true})
+	{
+		SConfig::GetInstance().bAccurateNaNs = accurate_nans;
+		for (const FloatOp& op : s_ops)
+		{
+			std::vector<Result> sse = RunJit(op, false);
+			std::vector<Result> avx = RunJit(op, true);
+			ASSERT_EQ(sse.size(), avx.size());
+			for (size_t i = 0; i < sse.size(); i++)
+			{
+				EXPECT_EQ(sse[i].ps0, avx[i].ps0) << op.name << " input " << i;
+				EXPECT_EQ(sse[i].ps1, avx[i].ps1) << op.name << " input " << i;
+			}
+		}
+	}
+}
+
+// Which NaN comes out depends on bAccurateNaNs and isn't exact even with it:
+// the JIT doesn't quiet signalling NaNs in scalar results, for example.
+// Every other result, zeros and infinities included, has to be bit-exact.
+static void ExpectSame(u64 expected, u64 actual, const FloatOp& op, bool avx, size_t input)
+{
+	if (IsNaN(expected) || IsNaN(actual))
+	{
+		EXPECT_TRUE(IsNaN(expected) && IsNaN(actual)) << op.name << (avx ? " AVX" : "") << " input " << input
+			<< std::hex << ": " << expected << " != " << actual;
+	}
+	else
+	{
+		EXPECT_EQ(expected, actual) << op.name << (avx ? " AVX" : "") << " input " << input;
+	}
+}
+
+TEST_F(Jit64FloatingPointTest, MatchesInterpreter)
+{
+	for (const FloatOp& op : s_ops)
+	{
+		std::vector<Result> expected = RunInterpreter(op);
+		for (bool avx : {false, true})
+		{
+			if (avx && !m_cpu_info.bAVX)
+				continue;
+
+			std::vector<Result> actual = RunJit(op, avx);
+			ASSERT_EQ(expected.size(), actual.size());
+			for (size_t i = 0; i < expected.size(); i++)
+			{
+				ExpectSame(expected[i].ps0, actual[i].ps0, op, avx, i);
+				ExpectSame(expected[i].ps1, actual[i].ps1, op, avx, i);
+			}
+		}
+	}
+}
@@ -0,0 +1,367 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Common/x64Emitter.h"
+#include "Core/ConfigManager.h"
+#include "Core/PowerPC/JitCommon/JitBase.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+class TestBlockCache : public JitBaseBlockCache
+{
+public:
+	int num_links = 0;
+	int num_destroys = 0;
+	int num_unlinks = 0;
+
+	int AddBlock(u32 address, u32 num_instructions, std::initializer_list<u32> exits = {})
+	{
+		int block_num = AllocateBlock(address);
+		JitBlock* b = GetBlock(block_num);
+		b->checkedEntry = reinterpret_cast<const u8*>(static_cast<uintptr_t>(address));
+		b->normalEntry = b->checkedEntry;
+		b->originalSize = num_instructions;
+		b->codeSize = 0;
+		for (u32 exit : exits)
+		{
+			JitBlock::LinkData link_data;
+			link_data.exitAddress = exit;
+			link_data.exitPtrs = nullptr;
+			link_data.linkStatus = false;
+			b->linkData.push_back(link_data);
+		}
+		FinalizeBlock(block_num, true, b->checkedEntry);
+		return block_num;
+	}
+
+private:
+	void WriteLinkBlock(u8* location, const u8* address) override { num_links++; }
+	void WriteDestroyBlock(const u8* location, u32 address) override { num_destroys++; }
+	void WriteUnlinkBlock(u8* location, u32 address) override { num_unlinks++; }
+};
+
+// Patches exits like Jit64 does, in code made up by the test.
+class X64TestBlockCache : public JitBlockCache
+{
+public:
+	// exits are (destination, host address of the exit's JMP or CALL).
+	int AddBlock(u32 address, const u8* entry, std::vector<std::pair<u32, u8*>> exits = {})
+	{
+		int block_num = AllocateBlock(address);
+		JitBlock* b = GetBlock(block_num);
+		b->checkedEntry = entry;
+		b->normalEntry = entry;
+		b->originalSize = 1;
+		b->codeSize = 0;
+		for (const auto& exit : exits)
+		{
+			JitBlock::LinkData link_data;
+			link_data.exitAddress = exit.first;
+			link_data.exitPtrs = exit.second;
+			link_data.linkStatus = false;
+			b->linkData.push_back(link_data);
+		}
+		FinalizeBlock(block_num, true, entry);
+		return block_num;
+	}
+};
+
+class JitCacheFakeJit : public JitBase
+{
+public:
+	// CPUCoreBase methods
+	void Init() override {}
+	void Shutdown() override {}
+	void ClearCache() override {}
+	void Run() override {}
+	void SingleStep() override {}
+	const char *GetName() override { return nullptr; }
+
+	// JitBase methods
+	JitBaseBlockCache *GetBlockCache() override { return m_cache; }
+	void Jit(u32 em_address) override {}
+	const CommonAsmRoutinesBase *GetAsmRoutines() override { return &m_asm_routines; }
+	bool HandleFault(uintptr_t access_address, SContext* ctx) override { return false; }
+
+	JitBaseBlockCache* m_cache;
+	CommonAsmRoutinesBase m_asm_routines = {};
+};
+
+// Where the JMP or CALL at code goes.
+static const u8* GetJumpTarget(const u8* code)
+{
+	s32 offset;
+	std::memcpy(&offset, code + 1, sizeof(offset));
+	return code + 5 + offset;
+}
+
+class JitCacheTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		m_cache.reset(new TestBlockCache());
+		m_jit.m_cache = m_cache.get();
+		jit = &m_jit;
+		m_cache->Init();
+	}
+
+	void TearDown() override
+	{
+		m_cache->Shutdown();
+		jit = nullptr;
+		SConfig::Shutdown();
+	}
+
+	JitCacheFakeJit m_jit;
+	std::unique_ptr<TestBlockCache> m_cache;
+};
+
+TEST_F(JitCacheTest, InvalidateOverlapping)
+{
+	int a = m_cache->AddBlock(0x80003000, 8);   // 0x3000 - 0x301f
+	int b = m_cache->AddBlock(0x80003ff0, 8);   // crosses into the next page
+	int c = m_cache->AddBlock(0x80005000, 4);
+
+	m_cache->InvalidateICache(0x80004000, 4, true);
+	EXPECT_FALSE(m_cache->GetBlock(a)->invalid);
+	EXPECT_TRUE(m_cache->GetBlock(b)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(c)->invalid);
+	EXPECT_EQ(-1, m_cache->GetBlockNumberFromStartAddress(0x80003ff0));
+
+	m_cache->InvalidateICache(0x80003020, 0x1000, true);
+	EXPECT_FALSE(m_cache->GetBlock(a)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(c)->invalid);
+
+	m_cache->InvalidateICache(0x8000301c, 4, true);
+	EXPECT_TRUE(m_cache->GetBlock(a)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(c)->invalid);
+	EXPECT_EQ(c, m_cache->GetBlockNumberFromStartAddress(0x80005000));
+}
+
+TEST_F(JitCacheTest, RelinkAfterRecompile)
+{
+	int source = m_cache->AddBlock(0x80001000, 4, {0x80002000});
+	EXPECT_FALSE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+
+	m_cache->AddBlock(0x80002000, 4);
+	EXPECT_TRUE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+	EXPECT_EQ(1, m_cache->num_links);
+
+	m_cache->InvalidateICache(0x80002000, 32, true);
+	EXPECT_FALSE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+
+	// Recompiling the destination links the surviving source back to it.
+	m_cache->AddBlock(0x80002000, 4);
+	EXPECT_TRUE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+	EXPECT_EQ(2, m_cache->num_links);
+
+	// Destroyed sources aren't linked anymore.
+	m_cache->InvalidateICache(0x80001000, 32, true);
+	m_cache->InvalidateICache(0x80002000, 32, true);
+	m_cache->AddBlock(0x80002000, 4);
+	EXPECT_EQ(2, m_cache->num_links);
+}
+
+TEST_F(JitCacheTest, PendingBlocks)
+{
+	int source = m_cache->AddBlock(0x80001000, 4, {0x80002000});
+
+	int pending = m_cache->AllocatePendingBlock(0x80002000, 4);
+	EXPECT_EQ(-1, m_cache->GetBlockNumberFromStartAddress(0x80002000));
+	EXPECT_FALSE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+
+	// Invalidating a pending block doesn't touch its (missing) code.
+	m_cache->InvalidateICache(0x80002008, 4, true);
+	EXPECT_TRUE(m_cache->GetBlock(pending)->invalid);
+	EXPECT_EQ(0, m_cache->num_destroys);
+	m_cache->DiscardPendingBlock(pending);
+
+	// The dropped block's slot is reused.
+	int discarded = pending;
+	pending = m_cache->AllocatePendingBlock(0x80002000, 4);
+	EXPECT_EQ(discarded, pending);
+	JitBlock* b = m_cache->GetBlock(pending);
+	b->checkedEntry = reinterpret_cast<const u8*>(static_cast<uintptr_t>(0x2000));
+	b->normalEntry = b->checkedEntry;
+	m_cache->FinalizeBlock(pending, true, b->checkedEntry);
+	EXPECT_FALSE(b->pending);
+	EXPECT_EQ(pending, m_cache->GetBlockNumberFromStartAddress(0x80002000));
+	EXPECT_TRUE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+
+	// Once installed, it's invalidated like any other block.
+	m_cache->InvalidateICache(0x80002000, 4, true);
+	EXPECT_TRUE(b->invalid);
+	EXPECT_EQ(1, m_cache->num_destroys);
+}
+
+TEST_F(JitCacheTest, InvalidateLargeRange)
+{
+	int a = m_cache->AddBlock(0x80003000, 8);
+	int pending = m_cache->AllocatePendingBlock(0x80100000, 4);
+	m_jit.js.fifoWriteAddresses.insert(0x80003004);
+	m_jit.js.fifoWriteAddresses.insert(0x80200000);
+
+	// Nothing was compiled from the range.
+	m_cache->InvalidateICache(0x80010000, 0x10000, false);
+	EXPECT_FALSE(m_cache->GetBlock(a)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(pending)->invalid);
+
+	// Pending blocks aren't skipped by the single line fast path.
+	m_cache->InvalidateICache(0x80100000, 32, false);
+	EXPECT_TRUE(m_cache->GetBlock(pending)->invalid);
+	m_cache->DiscardPendingBlock(pending);
+
+	m_cache->InvalidateICache(0x80000000, 0x100000, false);
+	EXPECT_TRUE(m_cache->GetBlock(a)->invalid);
+	EXPECT_EQ(1u, m_jit.js.fifoWriteAddresses.size());
+	EXPECT_EQ(1u, m_jit.js.fifoWriteAddresses.count(0x80200000));
+}
+
+TEST_F(JitCacheTest, RecompileSingleBlock)
+{
+	int source = m_cache->AddBlock(0x80001000, 4, {0x80002000});
+	int hot = m_cache->AddBlock(0x80002000, 4);
+	int overlapping = m_cache->AddBlock(0x80001ff8, 4);
+
+	m_cache->InvalidateBlock(hot);
+	EXPECT_TRUE(m_cache->GetBlock(hot)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(overlapping)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+
+	hot = m_cache->AddBlock(0x80002000, 4);
+	EXPECT_TRUE(m_cache->GetBlock(source)->linkData[0].linkStatus);
+	EXPECT_EQ(hot, m_cache->GetBlockNumberFromStartAddress(0x80002000));
+}
+
+TEST_F(JitCacheTest, ExitCountersAreReused)
+{
+	int block_num = m_cache->AddBlock(0x80001000, 4, {0x80002000});
+	u32* counter = m_cache->AllocateExitCounter();
+	ASSERT_TRUE(counter != nullptr);
+	m_cache->GetBlock(block_num)->linkData[0].exitCount = counter;
+	*counter = 1234;
+
+	while (m_cache->AllocateExitCounter())
+	{
+	}
+
+	m_cache->InvalidateBlock(block_num);
+	EXPECT_TRUE(m_cache->GetBlock(block_num)->linkData[0].exitCount == nullptr);
+	EXPECT_TRUE(m_cache->AllocateExitCounter() == counter);
+	EXPECT_EQ(0u, *counter);
+	EXPECT_TRUE(m_cache->AllocateExitCounter() == nullptr);
+}
+
+TEST_F(JitCacheTest, EvictCodeRange)
+{
+	// The fake code pointers are the addresses of the blocks.
+	int evicted = m_cache->AddBlock(0x80001000, 4, {0x80003000});
+	int survivor = m_cache->AddBlock(0x80003000, 4, {0x80001000});
+	EXPECT_TRUE(m_cache->GetBlock(survivor)->linkData[0].linkStatus);
+
+	std::vector<u32> addresses;
+	EXPECT_EQ(1, m_cache->EvictBlocks(reinterpret_cast<const u8*>(0x80001000), reinterpret_cast<const u8*>(0x80002000),
+	                                  &addresses));
+	ASSERT_EQ(1u, addresses.size());
+	EXPECT_EQ(0x80001000u, addresses[0]);
+	EXPECT_TRUE(m_cache->GetBlock(evicted)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(survivor)->invalid);
+	EXPECT_FALSE(m_cache->GetBlock(survivor)->linkData[0].linkStatus);
+	EXPECT_EQ(-1, m_cache->GetBlockNumberFromStartAddress(0x80001000));
+	EXPECT_EQ(survivor, m_cache->GetBlockNumberFromStartAddress(0x80003000));
+
+	// The slot is reused, and the survivor links to the recompiled block.
+	int recompiled = m_cache->AddBlock(0x80001000, 4);
+	EXPECT_EQ(evicted, recompiled);
+	EXPECT_TRUE(m_cache->GetBlock(survivor)->linkData[0].linkStatus);
+
+	// The evicted block's exit is gone, destroying its old target doesn't
+	// touch the block in its slot.
+	m_cache->InvalidateICache(0x80003000, 4, true);
+	EXPECT_FALSE(m_cache->GetBlock(recompiled)->invalid);
+	EXPECT_EQ(0u, m_cache->GetBlock(recompiled)->linkData.size());
+}
+
+TEST_F(JitCacheTest, EvictionRewritesLinkedExits)
+{
+	Gen::X64CodeBlock code;
+	code.AllocCodeSpace(0x1000);
+	const u8* dispatcher = code.GetCodePtr();
+	code.INT3();
+	m_jit.m_asm_routines.dispatcher = dispatcher;
+
+	// Unlinked exits, as Jit64::JustWriteExit writes them after setting pc.
+	// The second one stands for a far code exit.
+	u8* jump_exit = code.GetWritableCodePtr();
+	code.JMP(dispatcher, true);
+	u8* call_exit = code.GetWritableCodePtr();
+	code.CALL(dispatcher);
+	code.INT3();
+	const u8* source_entry = code.AlignCode16();
+	code.INT3();
+	const u8* victim_entry = code.AlignCode16();
+	code.INT3();
+
+	std::unique_ptr<X64TestBlockCache> cache(new X64TestBlockCache());
+	m_jit.m_cache = cache.get();
+	cache->Init();
+	int source = cache->AddBlock(0x80001000, source_entry, {{0x80002000, jump_exit}, {0x80002000, call_exit}});
+	cache->AddBlock(0x80002000, victim_entry);
+
+	ASSERT_EQ(0xE9, jump_exit[0]);
+	ASSERT_EQ(0xE8, call_exit[0]);
+	EXPECT_TRUE(GetJumpTarget(jump_exit) == victim_entry);
+	EXPECT_TRUE(GetJumpTarget(call_exit) == victim_entry);
+
+	EXPECT_EQ(1, cache->EvictBlocks(victim_entry, victim_entry + 1));
+	EXPECT_FALSE(cache->GetBlock(source)->linkData[0].linkStatus);
+	EXPECT_FALSE(cache->GetBlock(source)->linkData[1].linkStatus);
+	EXPECT_EQ(0xE9, jump_exit[0]);
+	EXPECT_EQ(0xE8, call_exit[0]);
+	EXPECT_TRUE(GetJumpTarget(jump_exit) == dispatcher);
+	EXPECT_TRUE(GetJumpTarget(call_exit) == dispatcher);
+
+	cache->Shutdown();
+	m_jit.m_cache = m_cache.get();
+}
+
+TEST_F(JitCacheTest, InvalidateRandomRangesTiming)
+{
+	const int NUM_BLOCKS = 30000;
+	const int NUM_INVALIDATIONS = 100000;
+
+	std::mt19937 rng(1234);
+	std::uniform_int_distribution<u32> address_dist(0, 0x017fffff / 4);
+	std::uniform_int_distribution<u32> size_dist(1, 64);
+	std::uniform_int_distribution<u32> length_dist(1, 0x400);
+
+	while (m_cache->GetNumBlocks() < NUM_BLOCKS)
+	{
+		u32 address = 0x80000000 | (address_dist(rng) * 4);
+		if (m_cache->GetBlockNumberFromStartAddress(address) == -1)
+			m_cache->AddBlock(address, size_dist(rng), {address + 4 * size_dist(rng)});
+	}
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int i = 0; i < NUM_INVALIDATIONS; i++)
+		m_cache->InvalidateICache(0x80000000 | (address_dist(rng) * 4), length_dist(rng) * 4, true);
+	auto end = std::chrono::high_resolution_clock::now();
+
+	unsigned long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+	printf("block cache invalidation timing (%d blocks):\n", NUM_BLOCKS);
+	printf("blocks destroyed       %d\n", m_cache->num_destroys);
+	printf("per invalidation       %llu ns\n", ns / NUM_INVALIDATIONS);
+}
@@ -2,7 +2,9 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <functional>
 #include <unordered_set>
+#include <vector>
 #include <gtest/gtest.h>
 
 #include "Common/CommonTypes.h"
@@ -129,3 +131,125 @@ TEST_F(MappingTest, ReadWriteComplex)
 	EXPECT_TRUE(read_called);
 	EXPECT_TRUE(write_called);
 }
+
+// Reports whether a handler's method is one that the JITs inline.
+template <typename T>
+class IsDirectVisitor : public MMIO::ReadHandlingMethodVisitor<T>, public MMIO::WriteHandlingMethodVisitor<T>
+{
+public:
+	bool direct = false;
+	bool constant = false;
+	bool pure = false;
+
+	void VisitConstant(T value) override { constant = true; }
+	void VisitDirect(const T* addr, u32 mask) override { direct = true; }
+	void VisitComplex(const std::function<T(u32)>* lambda) override {}
+	void VisitPure(T (*func)(u32), const std::function<T(u32)>* lambda) override { pure = true; }
+	void VisitNop() override {}
+	void VisitDirect(T* addr, u32 mask) override { direct = true; }
+	void VisitComplex(const std::function<void(u32, T)>* lambda) override {}
+};
+
+TEST_F(MappingTest, CombineDirectToSmaller)
+{
+	u32 target = 0;
+
+	m_mapping->Register(0x0C001000, MMIO::DirectRead<u16>(MMIO::Utils::HighPart(&target)),
+	                    MMIO::DirectWrite<u16>(MMIO::Utils::HighPart(&target), 0x00FF));
+	m_mapping->Register(0x0C001002, MMIO::DirectRead<u16>(MMIO::Utils::LowPart(&target)),
+	                    MMIO::DirectWrite<u16>(MMIO::Utils::LowPart(&target), 0xFFE0));
+	m_mapping->Register(0x0C001000, MMIO::ReadToSmaller<u32>(m_mapping, 0x0C001000, 0x0C001002),
+	                    MMIO::WriteToSmaller<u32>(m_mapping, 0x0C001000, 0x0C001002));
+
+	IsDirectVisitor<u32> read_visitor, write_visitor;
+	m_mapping->GetHandlerForRead<u32>(0x0C001000).Visit(read_visitor);
+	m_mapping->GetHandlerForWrite<u32>(0x0C001000).Visit(write_visitor);
+	EXPECT_TRUE(read_visitor.direct);
+	EXPECT_TRUE(write_visitor.direct);
+
+	m_mapping->Write<u32>(0x0C001000, 0x12345678);
+	EXPECT_EQ(0x00345660u, target);
+	EXPECT_EQ(0x00345660u, m_mapping->Read<u32>(0x0C001000));
+}
+
+TEST_F(MappingTest, CombineToLarger)
+{
+	u32 target = 0x12345678;
+
+	m_mapping->Register(0x0C001000, MMIO::DirectRead<u32>(&target, 0xFFFF0FFF), MMIO::Nop<u32>());
+	m_mapping->RegisterRead(0x0C001000, MMIO::ReadToLarger<u16>(m_mapping, 0x0C001000, 16));
+	m_mapping->RegisterRead(0x0C001002, MMIO::ReadToLarger<u16>(m_mapping, 0x0C001000, 0));
+
+	IsDirectVisitor<u16> high_visitor, low_visitor;
+	m_mapping->GetHandlerForRead<u16>(0x0C001000).Visit(high_visitor);
+	m_mapping->GetHandlerForRead<u16>(0x0C001002).Visit(low_visitor);
+	EXPECT_TRUE(high_visitor.direct);
+	EXPECT_TRUE(low_visitor.direct);
+
+	EXPECT_EQ(0x1234, m_mapping->Read<u16>(0x0C001000));
+	EXPECT_EQ(0x0678, m_mapping->Read<u16>(0x0C001002));
+
+	// Complex handlers can't be combined and are still called.
+	m_mapping->RegisterRead(0x0C001004, MMIO::ComplexRead<u32>([](u32) { return 0xCAFEBABE; }));
+	m_mapping->RegisterRead(0x0C001004, MMIO::ReadToLarger<u16>(m_mapping, 0x0C001004, 16));
+	EXPECT_EQ(0xCAFE, m_mapping->Read<u16>(0x0C001004));
+}
+
+static u16 s_pure_value;
+
+static u16 ReadPureValue(u32 addr)
+{
+	return s_pure_value;
+}
+
+TEST_F(MappingTest, ReadPure)
+{
+	s_pure_value = 0x1234;
+	m_mapping->RegisterRead(0x0C001000, MMIO::PureRead<u16>(ReadPureValue));
+
+	IsDirectVisitor<u16> visitor;
+	m_mapping->GetHandlerForRead<u16>(0x0C001000).Visit(visitor);
+	EXPECT_TRUE(visitor.pure);
+	EXPECT_EQ(0x1234, m_mapping->Read<u16>(0x0C001000));
+	s_pure_value = 0x5678;
+	EXPECT_EQ(0x5678, m_mapping->Read<u16>(0x0C001000));
+
+	// Visitors that don't know about Pure see a Complex handler.
+	struct ComplexVisitor : public MMIO::ReadHandlingMethodVisitor<u16>
+	{
+		const std::function<u16(u32)>* lambda = nullptr;
+
+		void VisitConstant(u16 value) override {}
+		void VisitDirect(const u16* addr, u32 mask) override {}
+		void VisitComplex(const std::function<u16(u32)>* l) override { lambda = l; }
+	};
+	ComplexVisitor complex;
+	m_mapping->GetHandlerForRead<u16>(0x0C001000).Visit(complex);
+	ASSERT_TRUE(complex.lambda != nullptr);
+	EXPECT_EQ(0x5678, (*complex.lambda)(0x0C001000));
+}
+
+TEST_F(MappingTest, Profiling)
+{
+	u16 target = 0;
+	m_mapping->Register(0x0C001000, MMIO::DirectRead<u16>(&target), MMIO::DirectWrite<u16>(&target));
+	m_mapping->Register(0x0C001002, MMIO::DirectRead<u16>(&target), MMIO::DirectWrite<u16>(&target));
+
+	m_mapping->SetProfilingEnabled(true);
+	for (int i = 0; i < 3; ++i)
+		m_mapping->Read<u16>(0x0C001002);
+	m_mapping->Read<u16>(0x0C001000);
+	m_mapping->Write<u16>(0x0C001000, 1);
+
+	std::vector<MMIO::Mapping::ProfileEntry> results = m_mapping->GetProfileResults();
+	ASSERT_EQ(2u, results.size());
+	EXPECT_EQ(0x0C001002u, results[0].address);
+	EXPECT_EQ(3u, results[0].reads);
+	EXPECT_EQ(0u, results[0].writes);
+	EXPECT_EQ(0x0C001000u, results[1].address);
+	EXPECT_EQ(1u, results[1].reads);
+	EXPECT_EQ(1u, results[1].writes);
+
+	m_mapping->SetProfilingEnabled(false);
+	EXPECT_TRUE(m_mapping->GetProfileResults().empty());
+}
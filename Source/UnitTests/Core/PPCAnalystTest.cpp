@@ -0,0 +1,248 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <initializer_list>
+#include <vector>
+
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/PPCAnalyst.h"
+#include "Core/PowerPC/Interpreter/Interpreter_Tables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+// Assembles the few instructions the tests need.
+static u32 DForm(u32 opcd, u32 rd, u32 ra, u32 imm)
+{
+	return (opcd << 26) | (rd << 21) | (ra << 16) | (imm & 0xFFFF);
+}
+static u32 Li(u32 rd, s16 simm) { return DForm(14, rd, 0, simm); }
+static u32 Lis(u32 rd, s16 simm) { return DForm(15, rd, 0, simm); }
+static u32 Ori(u32 ra, u32 rs, u16 uimm) { return DForm(24, rs, ra, uimm); }
+static u32 Lwz(u32 rd, u32 ra, s16 d) { return DForm(32, rd, ra, d); }
+static u32 Lhz(u32 rd, u32 ra, s16 d) { return DForm(40, rd, ra, d); }
+static u32 Cmpwi(u32 ra, s16 simm) { return DForm(11, 0, ra, simm); }
+static u32 Stw(u32 rs, u32 ra, s16 d) { return DForm(36, rs, ra, d); }
+// bne cr0, offset
+static u32 Bne(s16 offset) { return DForm(16, 4, 2, offset); }
+// beq cr0, offset
+static u32 Beq(s16 offset) { return DForm(16, 12, 2, offset); }
+static const u32 BLR = 0x4E800020;
+
+class PPCAnalystTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		InterpreterTables::InitTables();
+		// Only RAM is needed, Memory::Init would also want the devices behind MMIO.
+		m_ram.resize(Memory::RAM_SIZE);
+		Memory::m_pRAM = m_ram.data();
+		// Page table lookups read through this.
+		Memory::physical_base = m_ram.data();
+		// Data address translation on, for the usual BAT mappings.
+		MSR = 0x10;
+
+		m_code_block.m_stats = &m_stats;
+		m_code_block.m_gpa = &m_gpa;
+		m_code_block.m_fpa = &m_fpa;
+	}
+
+	void TearDown() override
+	{
+		Memory::m_pRAM = nullptr;
+		Memory::physical_base = nullptr;
+		SConfig::Shutdown();
+	}
+
+	// Analyzes the given code, placed at CODE_ADDRESS.
+	const PPCAnalyst::CodeOp* Analyze(std::initializer_list<u32> code)
+	{
+		u32 address = CODE_ADDRESS;
+		for (u32 inst : code)
+		{
+			Memory::Write_U32(inst, address);
+			address += 4;
+		}
+
+		m_analyzer.Analyze(CODE_ADDRESS, &m_code_block, &m_code_buffer, m_code_buffer.GetSize());
+		return m_code_buffer.codebuffer;
+	}
+
+	static const u32 CODE_ADDRESS = 0x00003000;
+
+	std::vector<u8> m_ram;
+	PPCAnalyst::PPCAnalyzer m_analyzer;
+	PPCAnalyst::CodeBlock m_code_block;
+	PPCAnalyst::BlockStats m_stats;
+	PPCAnalyst::BlockRegStats m_gpa;
+	PPCAnalyst::BlockRegStats m_fpa;
+	PPCAnalyst::CodeBuffer m_code_buffer{32};
+};
+
+TEST_F(PPCAnalystTest, ConstantAddress)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lis(3, -0x8000),
+		Ori(3, 3, 0x1234),
+		Lwz(4, 3, 8),
+		Stw(4, 3, -4),
+		Lwz(3, 3, 0),
+		// r3 is no longer known.
+		Stw(4, 3, 0),
+		BLR,
+	});
+
+	EXPECT_FALSE(code[1].hasConstantAddress);
+	EXPECT_TRUE(code[2].hasConstantAddress);
+	EXPECT_EQ(0x8000123Cu, code[2].constantAddress);
+	EXPECT_TRUE(code[3].hasConstantAddress);
+	EXPECT_EQ(0x80001230u, code[3].constantAddress);
+	EXPECT_TRUE(code[4].hasConstantAddress);
+	EXPECT_FALSE(code[5].hasConstantAddress);
+}
+
+TEST_F(PPCAnalystTest, ConstantAddressNeedsOption)
+{
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lis(3, -0x8000),
+		Lwz(4, 3, 8),
+		BLR,
+	});
+
+	EXPECT_FALSE(code[1].hasConstantAddress);
+}
+
+TEST_F(PPCAnalystTest, KilledResult)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Li(5, 1),
+		Li(6, 2),
+		Li(5, 3),
+		Ori(5, 6, 4),
+		BLR,
+	});
+
+	// Both values of r5 are overwritten before they're read.
+	EXPECT_TRUE(code[0].skip);
+	EXPECT_FALSE(code[1].skip);
+	EXPECT_TRUE(code[2].skip);
+	// The last value is live when the block ends.
+	EXPECT_FALSE(code[3].skip);
+}
+
+TEST_F(PPCAnalystTest, LiveAcrossExit)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONDITIONAL_CONTINUE);
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Li(5, 1),
+		Bne(8),
+		Li(5, 2),
+		BLR,
+	});
+
+	// The branch target sees the first value.
+	EXPECT_FALSE(code[0].skip);
+	EXPECT_FALSE(code[2].skip);
+}
+
+TEST_F(PPCAnalystTest, LiveAcrossException)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_CONSTANT_PROPAGATION);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Li(5, 1),
+		Lwz(6, 7, 0),
+		Li(5, 2),
+		BLR,
+	});
+
+	// The load can raise a DSI, whose handler sees the first value.
+	EXPECT_FALSE(code[0].skip);
+	EXPECT_FALSE(code[2].skip);
+}
+
+TEST_F(PPCAnalystTest, IdleLoopOnSmallData)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lwz(0, 13, -0x7000),
+		Cmpwi(0, 0),
+		Beq(-8),
+	});
+
+	EXPECT_TRUE(code[2].branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, IdleLoopOnConstantRAMAddress)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lis(3, -0x8000),
+		Lwz(0, 3, 0x100),
+		Cmpwi(0, 0),
+		Beq(-12),
+	});
+
+	EXPECT_TRUE(code[3].branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, NoIdleLoopOnMMIO)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+	// Waits for the VI beam position to reach a line.
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lis(3, -0x3400),
+		Lhz(0, 3, 0x202C),
+		Cmpwi(0, 100),
+		Bne(-12),
+	});
+
+	EXPECT_FALSE(code[3].branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, NoIdleLoopOnUnknownAddress)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+	// r4 could point anywhere, including MMIO.
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lwz(0, 4, 0),
+		Cmpwi(0, 0),
+		Beq(-8),
+	});
+
+	EXPECT_FALSE(code[2].branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, NoIdleLoopWithStore)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+	const PPCAnalyst::CodeOp* code = Analyze({
+		Lwz(0, 13, -0x7000),
+		Stw(0, 13, -0x6ffc),
+		Cmpwi(0, 0),
+		Beq(-12),
+	});
+
+	EXPECT_FALSE(code[3].branchIsIdleLoop);
+}
+
+TEST_F(PPCAnalystTest, NoIdleLoopWithChangingRegister)
+{
+	m_analyzer.SetOption(PPCAnalyst::PPCAnalyzer::OPTION_IDLE_LOOPS);
+	// A counter, every iteration differs.
+	const PPCAnalyst::CodeOp* code = Analyze({
+		DForm(14, 5, 5, 1),
+		Cmpwi(5, 100),
+		Bne(-8),
+	});
+
+	EXPECT_FALSE(code[2].branchIsIdleLoop);
+}
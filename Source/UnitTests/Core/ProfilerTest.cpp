@@ -0,0 +1,114 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Common/FileUtil.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Profiler.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+class ProfilerTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		Core::DeclareAsCPUThread();
+		CoreTiming::Init();
+		Profiler::Init();
+		Profiler::ClearSamples();
+
+		// No symbols and no stack, so the samples are PC and LR.
+		PC = 0x80003100;
+		LR = 0x80004000;
+		PowerPC::ppcState.gpr[1] = 0;
+	}
+
+	void TearDown() override
+	{
+		Profiler::StopSampling();
+		Profiler::Shutdown();
+		CoreTiming::Shutdown();
+		Core::UndeclareAsCPUThread();
+		SConfig::Shutdown();
+	}
+
+	// Gives the sampler thread time to request a sample, then ends the slice.
+	void SampleOnce()
+	{
+		Profiler::StartSampling(100);
+		std::this_thread::sleep_for(std::chrono::milliseconds(20));
+		PowerPC::ppcState.downcount = 0;
+		CoreTiming::Advance();
+		Profiler::StopSampling();
+	}
+};
+
+TEST_F(ProfilerTest, FunctionSamples)
+{
+	SampleOnce();
+	// Requests don't pile up while the CPU thread doesn't advance.
+	ASSERT_EQ(1u, Profiler::GetSampleCount());
+
+	std::vector<FunctionSamples> functions = Profiler::GetFunctionSamples();
+	ASSERT_EQ(2u, functions.size());
+	EXPECT_EQ(0x80003100u, functions[0].address);
+	EXPECT_EQ(1u, functions[0].self);
+	EXPECT_EQ(1u, functions[0].total);
+	EXPECT_EQ(0x80004000u, functions[1].address);
+	EXPECT_EQ(0u, functions[1].self);
+	EXPECT_EQ(1u, functions[1].total);
+}
+
+TEST_F(ProfilerTest, FoldedStacks)
+{
+	SampleOnce();
+	SampleOnce();
+
+	std::string dir = File::CreateTempDir();
+	std::string filename = dir + "/folded.txt";
+	Profiler::WriteFoldedStacks(filename);
+	std::string folded;
+	EXPECT_TRUE(File::ReadFileToString(filename, folded));
+	File::DeleteDirRecursively(dir);
+
+	EXPECT_EQ("80004000;80003100 2\n", folded);
+}
+
+TEST_F(ProfilerTest, SampleAfterStateLoad)
+{
+	u8* ptr = nullptr;
+	PointerWrap measure(&ptr, PointerWrap::MODE_MEASURE);
+	CoreTiming::DoState(measure);
+	std::vector<u8> state(reinterpret_cast<size_t>(ptr));
+	ptr = state.data();
+	PointerWrap write(&ptr, PointerWrap::MODE_WRITE);
+	CoreTiming::DoState(write);
+
+	// A state loaded while a sample is requested doesn't lose the request,
+	// nor keep the next ones from being taken.
+	Profiler::StartSampling(100);
+	std::this_thread::sleep_for(std::chrono::milliseconds(20));
+	ptr = state.data();
+	PointerWrap read(&ptr, PointerWrap::MODE_READ);
+	CoreTiming::DoState(read);
+	PowerPC::ppcState.downcount = 0;
+	CoreTiming::Advance();
+	Profiler::StopSampling();
+	EXPECT_EQ(1u, Profiler::GetSampleCount());
+
+	SampleOnce();
+	EXPECT_EQ(2u, Profiler::GetSampleCount());
+}
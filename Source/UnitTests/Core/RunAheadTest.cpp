@@ -0,0 +1,250 @@
+// Copyright 2016 Dolphin Emulator Project
+// Licensed under GPLv2+
+// Refer to the license.txt file included.
+
+#include <vector>
+
+#include "Common/ChunkFile.h"
+#include "Common/CommonTypes.h"
+#include "Core/ConfigManager.h"
+#include "Core/Core.h"
+#include "Core/CoreTiming.h"
+#include "Core/HW/Memmap.h"
+#include "Core/PowerPC/CachedInterpreter.h"
+#include "Core/PowerPC/JitInterface.h"
+#include "Core/PowerPC/PowerPC.h"
+#include "Core/PowerPC/Interpreter/Interpreter.h"
+#include "Core/PowerPC/Interpreter/Interpreter_Tables.h"
+
+// include order is important
+#include <gtest/gtest.h> // NOLINT
+
+static u32 DForm(u32 opcd, u32 rd, u32 ra, u32 imm)
+{
+	return (opcd << 26) | (rd << 21) | (ra << 16) | (imm & 0xFFFF);
+}
+static u32 Li(u32 rd, s16 simm) { return DForm(14, rd, 0, simm); }
+static u32 Addi(u32 rd, u32 ra, s16 simm) { return DForm(14, rd, ra, simm); }
+static u32 Stw(u32 rs, u32 ra, s16 d) { return DForm(36, rs, ra, d); }
+static u32 B(s32 offset) { return (18u << 26) | (offset & 0x03FFFFFC); }
+
+static const u32 CODE_ADDRESS = 0x00003000;
+static const u32 OTHER_CODE_ADDRESS = 0x00004000;
+static const u32 COUNTER_ADDRESS = 0x00000100;
+
+static std::vector<s64> s_event_ticks;
+
+static void TestEvent(u64 userdata, int cycles_late)
+{
+	s_event_ticks.push_back((s64)CoreTiming::GetTicks() - cycles_late);
+}
+
+// Run-ahead rolls back the whole state, of which these tests cover what the
+// CPU sees: RAM, the PowerPC state with the JIT blocks, and CoreTiming. The
+// rest needs a video backend.
+class RunAheadTest : public testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		SConfig::Init();
+		SConfig::GetInstance().bJITNoBlockCache = false;
+		// The code ends in branches to themselves, which aren't meant to idle.
+		SConfig::GetInstance().bSkipIdle = false;
+		InterpreterTables::InitTables();
+
+		// Only RAM is needed, Memory::Init would also want the devices behind MMIO.
+		m_ram.resize(Memory::RAM_SIZE);
+		m_l1_cache.resize(Memory::L1_CACHE_SIZE);
+		Memory::m_pRAM = m_ram.data();
+		Memory::m_pL1Cache = m_l1_cache.data();
+		Memory::physical_base = m_ram.data();
+		Memory::bFakeVMEM = false;
+		// Address translation off.
+		MSR = 0;
+		PowerPC::ppcState.Exceptions = 0;
+
+		// Events are scheduled from the CPU thread.
+		Core::DeclareAsCPUThread();
+		CoreTiming::Init();
+		m_event = CoreTiming::RegisterEvent("RunAheadTest", TestEvent);
+		s_event_ticks.clear();
+		jit = &m_cached_interpreter;
+		m_cached_interpreter.Init();
+	}
+
+	void TearDown() override
+	{
+		m_cached_interpreter.Shutdown();
+		jit = nullptr;
+		CoreTiming::Shutdown();
+		Core::UndeclareAsCPUThread();
+		Memory::m_pRAM = nullptr;
+		Memory::m_pL1Cache = nullptr;
+		Memory::physical_base = nullptr;
+		SConfig::Shutdown();
+	}
+
+	// Those parts of State::DoState, in the same order.
+	static void DoState(PointerWrap& p, bool rollback)
+	{
+		PowerPC::DoState(p, rollback);
+		Memory::DoState(p);
+		CoreTiming::DoState(p);
+	}
+
+	void Save(bool rollback)
+	{
+		u8* ptr = nullptr;
+		PointerWrap p(&ptr, PointerWrap::MODE_MEASURE);
+		DoState(p, rollback);
+		m_state.resize(reinterpret_cast<size_t>(ptr));
+
+		ptr = m_state.data();
+		p.SetMode(PointerWrap::MODE_WRITE);
+		DoState(p, rollback);
+	}
+
+	void Load(bool rollback)
+	{
+		u8* ptr = m_state.data();
+		PointerWrap p(&ptr, PointerWrap::MODE_READ);
+		DoState(p, rollback);
+	}
+
+	void WriteCode(u32 address, std::initializer_list<u32> code)
+	{
+		for (u32 inst : code)
+		{
+			Memory::Write_U32(inst, address);
+			address += 4;
+		}
+	}
+
+	// One cycle per instruction.
+	static void Run(int instructions)
+	{
+		for (int i = 0; i < instructions; i++)
+			Interpreter::getInstance()->SingleStep();
+	}
+
+	bool HasBlock(u32 address)
+	{
+		return m_cached_interpreter.GetBlockCache()->GetBlockNumberFromStartAddress(address) >= 0;
+	}
+
+	// Compiles the block at address, without running it.
+	void Compile(u32 address)
+	{
+		PC = address;
+		m_cached_interpreter.SingleStep();
+		ASSERT_TRUE(HasBlock(address));
+	}
+
+	std::vector<u8> m_ram;
+	std::vector<u8> m_l1_cache;
+	std::vector<u8> m_state;
+	CachedInterpreter m_cached_interpreter;
+	int m_event;
+};
+
+TEST_F(RunAheadTest, RoundTrip)
+{
+	// A counter in RAM.
+	WriteCode(CODE_ADDRESS, {
+		Addi(3, 3, 1),
+		Stw(3, 0, COUNTER_ADDRESS),
+		B(-8),
+	});
+	PC = CODE_ADDRESS;
+	rGPR[3] = 0;
+	CoreTiming::ScheduleEvent(500, m_event);
+	Run(100);
+
+	Save(true);
+	std::vector<u8> saved_ram = m_ram;
+	u64 saved_ticks = CoreTiming::GetTicks();
+	u32 saved_pc = PC;
+	u32 saved_r3 = rGPR[3];
+	u32 saved_counter = Memory::Read_U32(COUNTER_ADDRESS);
+	EXPECT_NE(0u, saved_counter);
+
+	// The fields that are rolled back, which schedule an event of their own.
+	Run(300);
+	CoreTiming::ScheduleEvent(10, m_event);
+	Run(300);
+	ASSERT_EQ(2u, s_event_ticks.size());
+	s64 event_ticks = s_event_ticks[1];
+	EXPECT_NE(saved_counter, Memory::Read_U32(COUNTER_ADDRESS));
+
+	Load(true);
+	EXPECT_TRUE(saved_ram == m_ram);
+	EXPECT_EQ(saved_ticks, CoreTiming::GetTicks());
+	EXPECT_EQ(saved_pc, PC);
+	EXPECT_EQ(saved_r3, rGPR[3]);
+
+	// The event that was pending at the save runs at the same time again, and
+	// the one scheduled after it doesn't.
+	s_event_ticks.clear();
+	Run(600);
+	ASSERT_EQ(1u, s_event_ticks.size());
+	EXPECT_EQ(event_ticks, s_event_ticks[0]);
+	EXPECT_EQ(saved_counter + 200, Memory::Read_U32(COUNTER_ADDRESS));
+}
+
+TEST_F(RunAheadTest, KeepsJitBlocks)
+{
+	WriteCode(CODE_ADDRESS, {Li(3, 1), B(0)});
+	WriteCode(OTHER_CODE_ADDRESS, {Li(4, 1), B(0)});
+	Compile(CODE_ADDRESS);
+
+	Save(true);
+	Compile(OTHER_CODE_ADDRESS);
+	Load(true);
+	EXPECT_TRUE(HasBlock(CODE_ADDRESS));
+	// Compiled from code that is the same after the load.
+	EXPECT_TRUE(HasBlock(OTHER_CODE_ADDRESS));
+
+	// Loading any other state clears the cache.
+	Save(false);
+	Load(false);
+	EXPECT_FALSE(HasBlock(CODE_ADDRESS));
+	EXPECT_FALSE(HasBlock(OTHER_CODE_ADDRESS));
+}
+
+TEST_F(RunAheadTest, InvalidatesChangedCode)
+{
+	WriteCode(CODE_ADDRESS, {Li(3, 1), B(0)});
+	WriteCode(OTHER_CODE_ADDRESS, {Li(4, 1), B(0)});
+	Compile(CODE_ADDRESS);
+	Compile(OTHER_CODE_ADDRESS);
+
+	Save(true);
+	// New code is loaded over the old, and run.
+	WriteCode(CODE_ADDRESS, {Li(3, 2)});
+	JitInterface::InvalidateICache(CODE_ADDRESS, 32, false);
+	Compile(CODE_ADDRESS);
+	m_cached_interpreter.SingleStep();
+	EXPECT_EQ(2u, rGPR[3]);
+
+	Load(true);
+	EXPECT_FALSE(HasBlock(CODE_ADDRESS));
+	EXPECT_TRUE(HasBlock(OTHER_CODE_ADDRESS));
+	rGPR[3] = 0;
+	Compile(CODE_ADDRESS);
+	m_cached_interpreter.SingleStep();
+	EXPECT_EQ(1u, rGPR[3]);
+}
+
+TEST_F(RunAheadTest, DiscardRollback)
+{
+	WriteCode(CODE_ADDRESS, {Li(3, 1), B(0)});
+	Compile(CODE_ADDRESS);
+
+	// Emulation stops before the rollback, which stops logging the
+	// invalidations. A state loaded later is then a different one.
+	Save(true);
+	JitInterface::DiscardRollback();
+	Load(true);
+	EXPECT_FALSE(HasBlock(CODE_ADDRESS));
+}